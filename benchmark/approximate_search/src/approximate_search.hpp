@@ -0,0 +1,332 @@
+/*
+ * Approximate pattern matching under the edit distance in FM-indexes.
+ *
+ * backtracking_search extends the pattern character by character with
+ * backward search and branches on each substitution, insertion and deletion.
+ *
+ * scheme_search works on the bidirectional FM-index, i.e. an index of the
+ * text and an index of the reversed text, and uses a search scheme [1]: the
+ * pattern is split into parts and each search of the scheme processes the
+ * parts in a fixed order and bounds the number of errors after each part.
+ *
+ * In both cases an occurrence is a substring of the text whose edit distance
+ * to the pattern is at most k and which does not start or end with a
+ * deletion. The result is the set of SA intervals of these substrings in the
+ * index of the text.
+ *
+ * [1] Gregory Kucherov, Kamil Salikhov, Dekel Tsur:
+ *     Approximate String Matching using a Bidirectional Index. CPM 2014.
+ */
+#ifndef SDSL_BENCHMARK_APPROXIMATE_SEARCH
+#define SDSL_BENCHMARK_APPROXIMATE_SEARCH
+
+#include <sdsl/suffix_arrays.hpp>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+
+// One search of a search scheme. After processing the parts order[0..i]
+// the number of errors has to be in [L[i]..U[i]].
+struct search {
+    std::vector<uint8_t> order, L, U;
+};
+
+typedef std::vector<search> search_scheme;
+
+// k+1 parts; one part is error-free. Search j starts with part j.
+inline search_scheme pigeonhole_scheme(uint8_t k)
+{
+    uint8_t p = k+1;
+    search_scheme res;
+    for (uint8_t j=0; j < p; ++j) {
+        search s;
+        for (uint8_t i=j; i < p; ++i) s.order.push_back(i);
+        for (uint8_t i=j; i > 0; --i) s.order.push_back(i-1);
+        s.L.assign(p, 0);
+        s.U.assign(p, k);
+        s.U[0] = 0;
+        res.push_back(s);
+    }
+    return res;
+}
+
+// k+2 parts; there are two error-free parts and each part between
+// them contains exactly one error (01*0 seeds of Vroland et al.).
+inline search_scheme o1s0_scheme(uint8_t k)
+{
+    uint8_t p = k+2;
+    search_scheme res;
+    for (uint8_t j=0; j <= k; ++j) {
+        search s;
+        for (uint8_t i=j; i < p; ++i) {
+            s.order.push_back(i);
+            s.U.push_back(std::min(i-j, (int)k));
+        }
+        for (uint8_t i=j; i > 0; --i) {
+            s.order.push_back(i-1);
+            s.U.push_back(k);
+        }
+        s.L.assign(p, 0);
+        res.push_back(s);
+    }
+    return res;
+}
+
+// Fixed schemes for small k. For k=1 the two searches on two parts of
+// Kucherov et al. [1]. The schemes for k=2 (three parts) and k=3 (four
+// parts) are hand-made: each distribution of at most k errors over the parts
+// is covered by one of the searches, but the schemes are not proven to be
+// optimal. For k=0 the exact search.
+inline search_scheme optimum_scheme(uint8_t k)
+{
+    struct raw {
+        const char* order, *L, *U;
+    };
+    static const std::vector<std::vector<raw>> schemes = {
+        {{"0", "0", "0"}},
+        {{"01", "00", "01"}, {"10", "01", "01"}},
+        {{"012", "000", "022"}, {"210", "000", "012"}, {"120", "001", "012"}},
+        {{"0123", "0000", "0123"}, {"1230", "0000", "0133"},
+         {"2310", "0000", "0233"}, {"3210", "0000", "0333"}}
+    };
+    search_scheme res;
+    if (k < schemes.size()) {
+        for (const raw& r : schemes[k]) {
+            search s;
+            for (const char* x = r.order; *x; ++x) s.order.push_back(*x-'0');
+            for (const char* x = r.L; *x; ++x) s.L.push_back(*x-'0');
+            for (const char* x = r.U; *x; ++x) s.U.push_back(*x-'0');
+            res.push_back(s);
+        }
+    }
+    return res;
+}
+
+// Returns an empty scheme if the name or k is not supported.
+inline search_scheme scheme_by_name(const std::string& name, uint8_t k)
+{
+    if (name == "PIGEON") {
+        return pigeonhole_scheme(k);
+    } else if (name == "O1S0") {
+        return o1s0_scheme(k);
+    } else if (name == "OPT") {
+        return optimum_scheme(k);
+    }
+    return search_scheme();
+}
+
+inline std::string reverse_complement(const std::string& s)
+{
+    std::string res(s.rbegin(), s.rend());
+    for (char& c : res) {
+        switch (c) {
+            case 'A': c = 'T'; break;
+            case 'C': c = 'G'; break;
+            case 'G': c = 'C'; break;
+            case 'T': c = 'A'; break;
+        }
+    }
+    return res;
+}
+
+// Number of suffixes in the union of the SA intervals [l..r].
+inline uint64_t occurrences(std::vector<std::pair<uint64_t,uint64_t>>& ranges)
+{
+    std::sort(ranges.begin(), ranges.end());
+    uint64_t occ = 0, end = 0; // end: first suffix after the counted ones
+    for (const auto& r : ranges) {
+        uint64_t l = std::max(r.first, end);
+        if (r.second+1 > l) {
+            occ += r.second+1-l;
+            end = r.second+1;
+        }
+    }
+    return occ;
+}
+
+enum edit_op {NONE, MATCH, INSERTION, DELETION};
+
+template<class t_csa>
+class backtracking_search
+{
+    public:
+        typedef typename t_csa::size_type size_type;
+        typedef std::vector<std::pair<uint64_t,uint64_t>> range_vector;
+
+        uint64_t nodes = 0; // number of non-empty intervals visited
+
+    private:
+        const t_csa&       m_csa;
+        const std::string* m_pat = nullptr;
+        uint8_t            m_k   = 0;
+        range_vector*      m_res = nullptr;
+
+    public:
+        explicit backtracking_search(const t_csa& csa) : m_csa(csa) {}
+
+        //! Appends the intervals of the occurrences of pat to res.
+        void operator()(const std::string& pat, uint8_t k, range_vector& res)
+        {
+            m_pat = &pat; m_k = k; m_res = &res;
+            rec(0, m_csa.size()-1, pat.size(), 0, NONE);
+        }
+
+    private:
+        // [l..r] is the interval of the text matched to pat[i..m)
+        void rec(size_type l, size_type r, size_type i, uint8_t e, edit_op last)
+        {
+            const std::string& pat = *m_pat;
+            if (i == 0) {
+                m_res->push_back({l, r});
+                return;
+            }
+            size_type l2, r2;
+            if (e == m_k) {
+                if (backward_search(m_csa, l, r, (typename t_csa::char_type)pat[i-1], l2, r2) > 0) {
+                    ++nodes;
+                    rec(l2, r2, i-1, e, MATCH);
+                }
+                return;
+            }
+            if (last != DELETION) {
+                rec(l, r, i-1, e+1, INSERTION);
+            }
+            for (size_type cc=1; cc < m_csa.sigma; ++cc) {
+                auto c = m_csa.comp2char[cc];
+                if (backward_search(m_csa, l, r, c, l2, r2) == 0) {
+                    continue;
+                }
+                ++nodes;
+                rec(l2, r2, i-1, e + (c != (unsigned char)pat[i-1]), MATCH);
+                if (i < pat.size() and last != INSERTION) {
+                    rec(l2, r2, i, e+1, DELETION);
+                }
+            }
+        }
+};
+
+template<class t_csa>
+class scheme_search
+{
+    public:
+        typedef typename t_csa::size_type size_type;
+        typedef std::vector<std::pair<uint64_t,uint64_t>> range_vector;
+
+        uint64_t nodes = 0; // number of non-empty intervals visited
+
+    private:
+        // [l..r] is the interval in the index of the text,
+        // [lb..rb] the one in the index of the reversed text.
+        struct interval {
+            size_type l, r, lb, rb;
+        };
+
+        const t_csa&        m_fwd;
+        const t_csa&        m_bwd;
+        const std::string*  m_pat    = nullptr;
+        const search*       m_search = nullptr;
+        std::vector<size_type> m_border; // part p is pat[m_border[p]..m_border[p+1])
+        std::vector<bool>   m_right;     // direction of the i-th part of the search
+        range_vector*       m_res    = nullptr;
+
+    public:
+        scheme_search(const t_csa& fwd, const t_csa& bwd) : m_fwd(fwd), m_bwd(bwd) {}
+
+        //! Appends the intervals of the occurrences of pat to res.
+        void operator()(const std::string& pat, const search_scheme& scheme, range_vector& res)
+        {
+            size_type parts = scheme[0].order.size();
+            m_pat = &pat; m_res = &res;
+            m_border.resize(parts+1);
+            for (size_type p=0; p <= parts; ++p) {
+                m_border[p] = p*pat.size()/parts;
+            }
+            for (const search& s : scheme) {
+                m_search = &s;
+                m_right.assign(parts, false);
+                m_right[0] = parts > 1 and s.order[1] > s.order[0];
+                for (size_type i=1; i < parts; ++i) {
+                    m_right[i] = s.order[i] > s.order[i-1];
+                }
+                size_type start = m_right[0] ? m_border[s.order[0]] : m_border[s.order[0]+1];
+                rec({0, m_fwd.size()-1, 0, m_bwd.size()-1}, start, start, 0, 0, NONE);
+            }
+        }
+
+    private:
+        bool extend(const interval& v, bool right, typename t_csa::char_type c, interval& res)
+        {
+            if (right) {
+                if (m_bwd.char2comp[c] == 0) {
+                    return false;
+                }
+                return sdsl::bidirectional_search(m_bwd, v.lb, v.rb, v.l, v.r, c, res.lb, res.rb, res.l, res.r) > 0;
+            } else {
+                if (m_fwd.char2comp[c] == 0) {
+                    return false;
+                }
+                return sdsl::bidirectional_search(m_fwd, v.l, v.r, v.lb, v.rb, c, res.l, res.r, res.lb, res.rb) > 0;
+            }
+        }
+
+        // v is the interval of the text matched to pat[i..j) and idx the
+        // position of the current part in the order of the search.
+        void rec(const interval& v, size_type i, size_type j, size_type idx, uint8_t e, edit_op last)
+        {
+            const std::string& pat = *m_pat;
+            const search& s = *m_search;
+            bool right = m_right[idx];
+            size_type p = s.order[idx];
+            bool done = right ? j == m_border[p+1] : i == m_border[p];
+            if (done and e >= s.L[idx]) {
+                if (idx+1 == s.order.size()) {
+                    m_res->push_back({v.l, v.r});
+                    return;
+                }
+                rec(v, i, j, idx+1, e, m_right[idx+1] == right ? last : NONE);
+            }
+            interval w;
+            if (!done) {
+                size_type pos = right ? j : i-1;
+                size_type i2 = right ? i : i-1, j2 = right ? j+1 : j;
+                if (e == s.U[idx]) {
+                    if (extend(v, right, (typename t_csa::char_type)pat[pos], w)) {
+                        ++nodes;
+                        rec(w, i2, j2, idx, e, MATCH);
+                    }
+                    return;
+                }
+                if (last != DELETION) {
+                    rec(v, i2, j2, idx, e+1, INSERTION);
+                }
+            }
+            // a deletion is only allowed inside of the pattern
+            size_type frontier = right ? j : i;
+            bool deletion = frontier > 0 and frontier < pat.size() and last != INSERTION;
+            if (done and (!deletion or e == s.U[idx])) {
+                return;
+            }
+            for (size_type cc=1; cc < m_fwd.sigma; ++cc) {
+                auto c = m_fwd.comp2char[cc];
+                if (!extend(v, right, c, w)) {
+                    continue;
+                }
+                ++nodes;
+                if (!done) {
+                    size_type pos = right ? j : i-1;
+                    rec(w, right ? i : i-1, right ? j+1 : j, idx, e + (c != (unsigned char)pat[pos]), MATCH);
+                }
+                if (deletion) {
+                    rec(w, i, j, idx, e+1, DELETION);
+                }
+            }
+        }
+};
+
+} // end namespace bench
+
+#endif
@@ -0,0 +1,39 @@
+/*
+ * Builds the bidirectional FM-index of a text: the index of the text is
+ * stored to output_file, the index of the reversed text to output_file.rev.
+ */
+#include <sdsl/suffix_arrays.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+using namespace sdsl;
+using namespace std;
+
+int main(int argc, char** argv)
+{
+    if (argc < 4) {
+        cout << "Usage ./" << argv[0] << " input_file tmp_dir output_file" << endl;
+        return 0;
+    }
+    string input_file = argv[1];
+    string tmp_dir    = argv[2];
+    string rev_file   = tmp_dir+"/"+util::basename(input_file)+".rev";
+    {
+        ifstream in(input_file, ios::binary);
+        string text((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        reverse(text.begin(), text.end());
+        ofstream out(rev_file, ios::binary);
+        out.write(text.data(), text.size());
+    }
+    for (const string& file : {input_file, rev_file}) {
+        CSA_TYPE csa;
+        // config: do not delete files, tmp_dir=argv[2], id=basename(file)
+        cache_config cconfig(false, tmp_dir, util::basename(file));
+        construct(csa, file, cconfig, 1);
+        store_to_file(csa, string(argv[3]) + (file == rev_file ? ".rev" : ""));
+    }
+    sdsl::remove(rev_file);
+}
@@ -0,0 +1,97 @@
+/*
+ * Searches all reads of a read file with at most k errors (edit distance)
+ * and outputs time, number of visited nodes and memory consumption.
+ *
+ * Scheme BACKTRACK uses backward search on the index of the text. All
+ * other schemes (see scheme_by_name) use the bidirectional index.
+ * If the reads were simulated from both strands, the reverse complement
+ * of each read is searched as well.
+ */
+#include "approximate_search.hpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace sdsl;
+using namespace std;
+using namespace std::chrono;
+
+int main(int argc, char** argv)
+{
+    if (argc < 5) {
+        cout << "Usage ./" << argv[0] << " index_file read_file scheme k" << endl;
+        cout << " scheme: BACKTRACK, PIGEON, O1S0, or OPT" << endl;
+        return 1;
+    }
+    string index_file = argv[1];
+    string scheme_name = argv[3];
+    uint8_t k = stoul(argv[4]);
+    bool backtrack = scheme_name == "BACKTRACK";
+    bench::search_scheme scheme = bench::scheme_by_name(scheme_name, k);
+    if (!backtrack and scheme.empty()) {
+        cerr << "Scheme " << scheme_name << " is not available for k=" << (int)k << endl;
+        return 1;
+    }
+
+    vector<string> reads;
+    bool both_strands = false;
+    {
+        ifstream in(argv[2], ios::binary);
+        uint64_t n = 0, len = 0;
+        in >> n >> both_strands;
+        for (uint64_t i=0; i < n and in >> len; ++i) {
+            string read(len, 0);
+            in.get(); // space
+            in.read(&read[0], len);
+            reads.push_back(read);
+        }
+    }
+
+    memory_monitor::start();
+    CSA_TYPE csa, csa_rev;
+    load_from_file(csa, index_file);
+    if (!backtrack) {
+        load_from_file(csa_rev, index_file+".rev");
+    }
+    uint64_t index_size = size_in_bytes(csa) + size_in_bytes(csa_rev);
+
+    bench::backtracking_search<CSA_TYPE> backtracking(csa);
+    bench::scheme_search<CSA_TYPE> scheme_search(csa, csa_rev);
+    uint64_t mapped = 0, occ = 0;
+    vector<pair<uint64_t,uint64_t>> ranges;
+    auto start = high_resolution_clock::now();
+    for (const string& read : reads) {
+        ranges.clear();
+        for (const string& pat : {read, both_strands ? bench::reverse_complement(read) : string()}) {
+            if (pat.empty()) {
+                continue;
+            }
+            if (backtrack) {
+                backtracking(pat, k, ranges);
+            } else {
+                scheme_search(pat, scheme, ranges);
+            }
+        }
+        uint64_t read_occ = bench::occurrences(ranges);
+        mapped += read_occ > 0;
+        occ += read_occ;
+    }
+    auto stop = high_resolution_clock::now();
+    memory_monitor::stop();
+    double secs = duration_cast<microseconds>(stop-start).count()/1000000.0;
+    uint64_t nodes = backtracking.nodes + scheme_search.nodes;
+    uint64_t n = max((size_t)1, reads.size());
+
+    cout << "# reads = " << reads.size() << endl;
+    cout << "# text_size = " << csa.size()-1 << endl;
+    cout << "# Index_size_in_bytes = " << index_size << endl;
+    cout << "# Peak_memory_in_bytes = " << memory_monitor::peak() << endl;
+    cout << "# Time_in_secs = " << secs << endl;
+    cout << "# Time_per_read_in_us = " << secs*1000000/n << endl;
+    cout << "# Node_visits = " << nodes << endl;
+    cout << "# Node_visits_per_read = " << (double)nodes/n << endl;
+    cout << "# Mapped_reads = " << mapped << endl;
+    cout << "# Occurrences = " << occ << endl;
+}
@@ -0,0 +1,85 @@
+/*
+ * Simulates sequencing reads from a text.
+ *
+ * A read starts at a uniformly chosen text position. Each read character is
+ * a substitution with probability subst_rate and an insertion or deletion
+ * with probability indel_rate/2 each. Substituted and inserted characters
+ * are drawn with the character distribution of the text. If at least 90%
+ * of the text are A, C, G and T the text is treated as DNA and a fraction
+ * revcomp_fraction of the reads is reverse complemented.
+ *
+ * Output format: the first line contains the number of reads and a flag
+ * which is 1 if the reads were simulated from both strands. Then each read
+ * is written as its length, a space, the read, and a newline.
+ */
+#include "approximate_search.hpp"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char** argv)
+{
+    if (argc < 9) {
+        cout << "Usage ./" << argv[0] << " input_file read_length num_reads subst_rate"
+             << " indel_rate revcomp_fraction seed output_file" << endl;
+        return 0;
+    }
+    ifstream in(argv[1], ios::binary);
+    string text((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    uint64_t read_length   = stoull(argv[2]);
+    uint64_t num_reads     = stoull(argv[3]);
+    double subst_rate      = stod(argv[4]);
+    double indel_rate      = stod(argv[5]);
+    double revcomp_fraction= stod(argv[6]);
+    mt19937_64 rng(stoull(argv[7]));
+
+    // reads may consume up to 2*read_length text characters if every
+    // character is a deletion; stop at the text end in that case
+    if (text.size() < 2*read_length) {
+        cerr << "Text is shorter than two times the read length" << endl;
+        return 1;
+    }
+    uint64_t acgt = 0;
+    for (char c : text) {
+        acgt += (c == 'A' or c == 'C' or c == 'G' or c == 'T');
+    }
+    bool dna = acgt >= 0.9*text.size();
+    if (!dna) {
+        revcomp_fraction = 0;
+    }
+
+    uniform_int_distribution<uint64_t> position(0, text.size()-read_length-1);
+    uniform_real_distribution<double> coin(0, 1);
+    auto random_char = [&]() { return text[position(rng)]; };
+
+    ofstream out(argv[8], ios::binary);
+    out << num_reads << " " << (revcomp_fraction > 0) << "\n";
+    for (uint64_t r=0; r < num_reads; ++r) {
+        string read;
+        for (uint64_t pos = position(rng); read.size() < read_length and pos < text.size();) {
+            double x = coin(rng);
+            if (x < subst_rate) {
+                char c = random_char();
+                while (c == text[pos]) {
+                    c = random_char();
+                }
+                read.push_back(c);
+                ++pos;
+            } else if (x < subst_rate + indel_rate/2) {
+                read.push_back(random_char());
+            } else if (x < subst_rate + indel_rate) {
+                ++pos;
+            } else {
+                read.push_back(text[pos++]);
+            }
+        }
+        if (coin(rng) < revcomp_fraction) {
+            read = bench::reverse_complement(read);
+        }
+        out << read.size() << " " << read << "\n";
+    }
+}
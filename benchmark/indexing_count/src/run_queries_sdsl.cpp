@@ -3,6 +3,8 @@
  */
 #include <sdsl/suffix_arrays.hpp>
 #include <string>
+#include <vector>
+#include "../../query_latency.hpp"
 
 #include <stdlib.h>
 #include "interface.h"
@@ -118,39 +120,39 @@ int main(int argc, char* argv[])
 void
 do_count(const CSA_TYPE& csa)
 {
-    ulong numocc, length, tot_numocc = 0, numpatt, res_patt;
-    double time, tot_time = 0;
-    uchar* pattern;
+    ulong numocc, length, tot_numocc = 0, numpatt;
+    double tot_time = 0;
+    bench::latency_histogram latency;
+    bench::perf_counters perf;
 
     pfile_info(&length, &numpatt);
-    res_patt = numpatt;
 
-    pattern = (uchar*) malloc(sizeof(uchar) * (length));
-    if (pattern == NULL) {
-        fprintf(stderr, "Error: cannot allocate\n");
+    // read all patterns, so that they can also be queried by several threads
+    std::vector<uchar> patterns(length*numpatt);
+    if (fread(patterns.data(), sizeof(uchar), patterns.size(), stdin) != patterns.size()) {
+        fprintf(stderr, "Error: cannot read patterns file\n");
         exit(1);
     }
 
-    while (res_patt) {
-
-        if (fread(pattern, sizeof(*pattern), length, stdin) != length) {
-            fprintf(stderr, "Error: cannot read patterns file\n");
-            exit(1);
-        }
+    perf.start();
+    for (ulong p = 0; p < numpatt; ++p) {
+        uchar* pattern = patterns.data() + p*length;
 
         /* Count */
-        time = getTime();
+        auto begin = bench::clock_type::now();
         numocc = sdsl::count(csa, pattern, pattern+length);
+        uint64_t ns = bench::elapsed_ns(begin, bench::clock_type::now());
 
         if (Verbose) {
             fwrite(&length, sizeof(length), 1, stdout);
             fwrite(pattern, sizeof(*pattern), length, stdout);
             fwrite(&numocc, sizeof(numocc), 1, stdout);
         }
-        tot_time += (getTime() - time);
+        latency.add(ns);
+        tot_time += ns/1e9;
         tot_numocc += numocc;
-        res_patt--;
     }
+    perf.stop();
 
     fprintf(stderr, "# Total_Num_occs_found = %lu\n", tot_numocc);
     fprintf(stderr, "# Count_time_in_milli_sec = %.4f\n", tot_time*1000);
@@ -163,7 +165,11 @@ do_count(const CSA_TYPE& csa)
     fprintf(stderr, "# (Load_time+Count_time)/Num_patterns = %.4f\n\n",
             ((Load_time+tot_time) * 1000) / numpatt);
 
-    free(pattern);
+    bench::report_latency("Count", latency, perf);
+    bench::report_throughput("Count", numpatt, [&](size_t p) -> uint64_t {
+        const uchar* pattern = patterns.data() + p*length;
+        return sdsl::count(csa, pattern, pattern+length);
+    });
 }
 
 
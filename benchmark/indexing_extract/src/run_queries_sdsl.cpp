@@ -3,6 +3,8 @@
  */
 #include <sdsl/suffix_arrays.hpp>
 #include <string>
+#include <vector>
+#include "../../query_latency.hpp"
 
 #include <stdlib.h>
 #include "interface.h"
@@ -246,7 +248,10 @@ do_extract(const CSA_TYPE& csa)
     uchar* text, orig_file[257];
     ulong num_pos, from, to, numchars, tot_ext = 0;
     CSA_TYPE::size_type readlen = 0;
-    double time, tot_time = 0;
+    double tot_time = 0;
+    std::vector<std::pair<ulong, ulong>> intervals; // also queried by several threads
+    bench::latency_histogram latency;
+    bench::perf_counters perf;
 
     error = fscanf(stdin, "# number=%lu length=%lu file=%s\n", &num_pos, &numchars, orig_file);
     if (error != 3) {
@@ -256,6 +261,7 @@ do_extract(const CSA_TYPE& csa)
     }
     fprintf(stderr, "# number=%lu length=%lu file=%s\n", num_pos, numchars, orig_file);
 
+    perf.start();
     while (num_pos) {
 
         if (fscanf(stdin,"%lu,%lu\n", &from, &to) != 2) {
@@ -263,10 +269,13 @@ do_extract(const CSA_TYPE& csa)
             exit(1);
         }
 
-        time = getTime();
+        auto begin = bench::clock_type::now();
         text = (uchar*)malloc(to-from+2);
         readlen = sdsl::extract(csa, from, to, text);
-        tot_time += (getTime() - time);
+        uint64_t ns = bench::elapsed_ns(begin, bench::clock_type::now());
+        latency.add(ns);
+        tot_time += ns/1e9;
+        intervals.emplace_back(from, to);
 
         tot_ext += readlen;
 
@@ -279,6 +288,7 @@ do_extract(const CSA_TYPE& csa)
         num_pos--;
         free(text);
     }
+    perf.stop();
 
     fprintf(stderr, "# Total_num_chars_extracted = %lu\n", tot_ext);
     fprintf(stderr, "# Extract_time_in_sec = %.2f\n", tot_time);
@@ -286,6 +296,12 @@ do_extract(const CSA_TYPE& csa)
             (tot_time * 1000) / tot_ext);
     fprintf(stderr, "(Load_time+Extract_time)/Num_chars_extracted = %.4f\n\n",
             ((Load_time+tot_time) * 1000) / tot_ext);
+
+    bench::report_latency("Extract", latency, perf);
+    bench::report_throughput("Extract", intervals.size(), [&](size_t i) -> uint64_t {
+        std::vector<uchar> buf(intervals[i].second-intervals[i].first+2);
+        return sdsl::extract(csa, intervals[i].first, intervals[i].second, buf.data());
+    });
 }
 
 double
@@ -3,6 +3,8 @@
  */
 #include <sdsl/suffix_arrays.hpp>
 #include <string>
+#include <vector>
+#include "../../query_latency.hpp"
 
 #include <stdlib.h>
 #include "interface.h"
@@ -168,8 +170,11 @@ do_locate(const CSA_TYPE& csa)
 {
     ulong numocc, length;
     ulong tot_numocc = 0, numpatt = 0, processed_pat = 0;
-    double time, tot_time = 0;
+    double tot_time = 0;
     uchar* pattern;
+    std::vector<uchar> processed; // patterns which are also queried by several threads
+    bench::latency_histogram latency;
+    bench::perf_counters perf;
 
     pfile_info(&length, &numpatt);
 
@@ -178,6 +183,7 @@ do_locate(const CSA_TYPE& csa)
         fprintf(stderr, "Error: cannot allocate\n");
         exit(1);
     }
+    perf.start();
     /*SG: added timeout of 60 seconds */
     while (numpatt and tot_time < 60.0) {
 
@@ -187,11 +193,14 @@ do_locate(const CSA_TYPE& csa)
             exit(1);
         }
         // Locate
-        time = getTime();
+        auto begin = bench::clock_type::now();
         auto occs =  locate(csa, (char*)pattern, (char*)pattern+length);
+        uint64_t ns = bench::elapsed_ns(begin, bench::clock_type::now());
         numocc = occs.size();
-        tot_time += (getTime() - time);
+        latency.add(ns);
+        tot_time += ns/1e9;
         ++processed_pat;
+        processed.insert(processed.end(), pattern, pattern+length);
 
         tot_numocc += numocc;
         numpatt--;
@@ -202,6 +211,7 @@ do_locate(const CSA_TYPE& csa)
             fwrite(&numocc, sizeof(numocc), 1, stdout);
         }
     }
+    perf.stop();
 
     fprintf(stderr, "# processed_pattern = %lu\n", processed_pat);
     fprintf(stderr, "# Total_Num_occs_found = %lu\n", tot_numocc);
@@ -209,6 +219,12 @@ do_locate(const CSA_TYPE& csa)
     fprintf(stderr, "# Locate_time/Num_occs = %.4f\n\n", (tot_time * 1000) / tot_numocc);
     fprintf(stderr, "# (Load_time+Locate_time)/Num_occs = %.4f\n\n", ((tot_time+Load_time) * 1000) / tot_numocc);
 
+    bench::report_latency("Locate", latency, perf);
+    bench::report_throughput("Locate", processed_pat, [&](size_t p) -> uint64_t {
+        const char* pat = (const char*)processed.data() + p*length;
+        return locate(csa, pat, pat+length).size();
+    });
+
     free(pattern);
 }
 
@@ -0,0 +1,124 @@
+/*
+ * Compares the results of the microbenchmarks with a baseline.
+ *
+ * Records are matched by all keys except the measured values. A record is
+ * a regression if its time per query exceeds the baseline by more than
+ * the given threshold (in percent). The program returns 1 if there is a
+ * regression and 0 otherwise.
+ */
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+
+typedef map<string, string> record;
+
+// keys which contain measurements and do not identify a record
+bool is_measurement(const string& key)
+{
+    return key == "ns_per_query" or key == "bits_per_bit" or key == "checksum";
+}
+
+string trim(const string& s)
+{
+    size_t b = s.find_first_not_of(" \t");
+    size_t e = s.find_last_not_of(" \t\r");
+    return b == string::npos ? "" : s.substr(b, e-b+1);
+}
+
+// Parses `# key = value` lines. A new record starts when a key repeats.
+vector<record> parse(const string& file)
+{
+    vector<record> res;
+    ifstream in(file);
+    if (!in) {
+        cerr << "Could not open " << file << endl;
+        return res;
+    }
+    record r;
+    string line;
+    while (getline(in, line)) {
+        size_t eq = line.find('=');
+        if (line.empty() or line[0] != '#' or eq == string::npos) {
+            continue;
+        }
+        string key = trim(line.substr(1, eq-1));
+        string value = trim(line.substr(eq+1));
+        if (r.count(key)) {
+            res.push_back(r);
+            r.clear();
+        }
+        r[key] = value;
+    }
+    if (!r.empty()) {
+        res.push_back(r);
+    }
+    return res;
+}
+
+string id(const record& r)
+{
+    string res;
+    for (const auto& kv : r) {
+        if (!is_measurement(kv.first)) {
+            res += kv.first + "=" + kv.second + " ";
+        }
+    }
+    return res;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        cout << "Usage: " << argv[0] << " baseline_file result_file [threshold]" << endl;
+        cout << " threshold: allowed slowdown in percent (default: 10)" << endl;
+        return 1;
+    }
+    double threshold = argc > 3 ? stod(argv[3]) : 10;
+    map<string, double> baseline;
+    for (const record& r : parse(argv[1])) {
+        if (r.count("ns_per_query")) {
+            baseline[id(r)] = stod(r.at("ns_per_query"));
+        }
+    }
+    uint64_t regressions = 0, improvements = 0, missing = 0, compared = 0;
+    for (const record& r : parse(argv[2])) {
+        if (!r.count("ns_per_query")) {
+            continue;
+        }
+        auto it = baseline.find(id(r));
+        if (it == baseline.end()) {
+            ++missing;
+            continue;
+        }
+        ++compared;
+        double now = stod(r.at("ns_per_query"));
+        double change = it->second > 0 ? 100.0*(now - it->second)/it->second : 0;
+        const char* flag = "";
+        if (change > threshold) {
+            flag = "REGRESSION";
+            ++regressions;
+        } else if (change < -threshold) {
+            flag = "improvement";
+            ++improvements;
+        }
+        printf("%-12s %-22s %-7s %-11s %10s %6s %9.2f %9.2f %+7.1f%% %s\n",
+               r.at("compile_id").c_str(), r.at("structure").c_str(), r.at("operation").c_str(),
+               r.at("pattern").c_str(), r.at("size").c_str(), r.at("density").c_str(),
+               it->second, now, change, flag);
+    }
+    printf("# compared = %lu\n", (unsigned long)compared);
+    printf("# not_in_baseline = %lu\n", (unsigned long)missing);
+    printf("# improvements = %lu\n", (unsigned long)improvements);
+    printf("# regressions = %lu\n", (unsigned long)regressions);
+    return regressions > 0;
+}
@@ -0,0 +1,186 @@
+/*
+ * Microbenchmarks for the rank, select and access operations of the
+ * bitvectors and their supports, and for bits::sel.
+ *
+ * For a random bitvector of the given size and density each operation is
+ * executed with three query patterns:
+ *   random     : random arguments; each argument depends on the result of
+ *                the previous query, i.e. the latency is measured
+ *   batched    : independent random arguments, i.e. the throughput is
+ *                measured
+ *   sequential : increasing arguments with equal distance
+ * Each result is written as a record of `# key = value` lines.
+ */
+#include <sdsl/bit_vectors.hpp>
+#include <sdsl/rank_support.hpp>
+#include <sdsl/select_support.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace sdsl;
+using namespace std;
+using namespace std::chrono;
+using timer = std::chrono::high_resolution_clock;
+
+namespace
+{
+
+const uint64_t queries     = 1ULL<<20;
+const uint64_t repetitions = 3;
+
+uint64_t    bv_size;
+double      density;
+std::string compile_id;
+std::mt19937_64 rng;
+
+// Returns the arguments of a pattern. Arguments are in [lo..hi). For
+// pattern `random` they are in [lo..hi-1), since the least significant bit
+// of the previous result is added.
+vector<uint64_t> arguments(const string& pattern, uint64_t lo, uint64_t hi)
+{
+    vector<uint64_t> args(queries);
+    if (pattern == "sequential") {
+        for (uint64_t i=0; i < queries; ++i) {
+            args[i] = lo + (i*(hi-lo))/queries;
+        }
+    } else {
+        uniform_int_distribution<uint64_t> dist(lo, pattern == "random" ? hi-2 : hi-1);
+        for (auto& x : args) {
+            x = dist(rng);
+        }
+    }
+    return args;
+}
+
+void report(const string& structure, const string& operation, const string& pattern,
+            double ns, double bits_per_bit, uint64_t checksum)
+{
+    cout << "# structure = " << structure << endl;
+    cout << "# operation = " << operation << endl;
+    cout << "# pattern = " << pattern << endl;
+    cout << "# size = " << bv_size << endl;
+    cout << "# density = " << density << endl;
+    cout << "# compile_id = " << compile_id << endl;
+    cout << "# bits_per_bit = " << bits_per_bit << endl;
+    cout << "# ns_per_query = " << ns << endl;
+    cout << "# checksum = " << checksum << endl;
+}
+
+// Measures query(x) for the arguments of all patterns in [lo..hi).
+// The minimum over the repetitions is reported.
+template<class t_query>
+void run(const string& structure, const string& operation, uint64_t lo, uint64_t hi,
+         double bits_per_bit, t_query query)
+{
+    if (hi <= lo+1) {
+        return;
+    }
+    for (const string& pattern : {"random", "batched", "sequential"}) {
+        vector<uint64_t> args = arguments(pattern, lo, hi);
+        bool dependent = pattern == "random";
+        double best = 0;
+        uint64_t checksum = 0;
+        for (uint64_t r=0; r < repetitions; ++r) {
+            uint64_t sum = 0, prev = 0;
+            auto start = timer::now();
+            if (dependent) {
+                for (uint64_t i=0; i < queries; ++i) {
+                    prev = query(args[i] + (prev&1));
+                    sum += prev;
+                }
+            } else {
+                for (uint64_t i=0; i < queries; ++i) {
+                    sum += query(args[i]);
+                }
+            }
+            auto stop = timer::now();
+            double ns = (double)duration_cast<nanoseconds>(stop-start).count()/queries;
+            if (r == 0 or ns < best) {
+                best = ns;
+            }
+            checksum = sum;
+        }
+        report(structure, operation, pattern, best, bits_per_bit, checksum);
+    }
+}
+
+template<class t_bv, class t_rank, class t_select>
+void run_bitvector(const string& name, const bit_vector& bv, bool with_select=true)
+{
+    t_bv v(bv);
+    t_rank rank(&v);
+    t_select select(&v);
+    uint64_t ones = rank(v.size());
+    double bpb = (8.0*(size_in_bytes(v)+size_in_bytes(rank)+size_in_bytes(select)))/v.size();
+    run(name, "access", 0, v.size(), bpb, [&](uint64_t i) { return (uint64_t)v[i]; });
+    run(name, "rank", 0, v.size()+1, bpb, [&](uint64_t i) { return (uint64_t)rank(i); });
+    if (with_select) {
+        run(name, "select", 1, ones+1, bpb, [&](uint64_t i) { return (uint64_t)select(i); });
+    }
+}
+
+template<class t_support>
+void run_support(const string& name, const string& operation, const bit_vector& bv)
+{
+    t_support s(&bv);
+    uint64_t ones = rank_support_v<>(&bv)(bv.size());
+    double bpb = (8.0*size_in_bytes(s))/bv.size();
+    if (operation == "rank") {
+        run(name, operation, 0, bv.size()+1, bpb, [&](uint64_t i) { return (uint64_t)s(i); });
+    } else {
+        run(name, operation, 1, ones+1, bpb, [&](uint64_t i) { return (uint64_t)s(i); });
+    }
+}
+
+void run_bits_sel(const bit_vector& bv)
+{
+    // argument i selects the (1+i%cnt)-th one in the word at position i/64
+    vector<uint64_t> cnt(bv.size()/64);
+    const uint64_t* data = bv.data();
+    for (uint64_t w=0; w < cnt.size(); ++w) {
+        cnt[w] = bits::cnt(data[w]);
+    }
+    run("bits", "sel", 0, 64*cnt.size(), 0, [&](uint64_t i) {
+        uint64_t w = i/64;
+        return cnt[w] ? (uint64_t)bits::sel(data[w], 1+(i%64)%cnt[w]) : 0;
+    });
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        cout << "Usage: " << argv[0] << " size density [compile_id] [seed]" << endl;
+        cout << " runs the microbenchmarks on a random bitvector of size bits" << endl;
+        cout << " in which each bit is set with probability density." << endl;
+        return 1;
+    }
+    bv_size    = stoull(argv[1]);
+    density    = stod(argv[2]);
+    compile_id = argc > 3 ? argv[3] : "default";
+    rng.seed(argc > 4 ? stoull(argv[4]) : 4711);
+
+    bit_vector bv(bv_size, 0);
+    bernoulli_distribution bit(density);
+    for (uint64_t i=0; i < bv.size(); ++i) {
+        bv[i] = bit(rng);
+    }
+
+    run("bit_vector", "access", 0, bv.size(), 1, [&](uint64_t i) { return (uint64_t)bv[i]; });
+    run_support<rank_support_v<>>("rank_support_v", "rank", bv);
+    run_support<rank_support_v5<>>("rank_support_v5", "rank", bv);
+    run_support<select_support_mcl<>>("select_support_mcl", "select", bv);
+    run_support<select_support_darray<>>("select_support_darray", "select", bv);
+    run_bitvector<bit_vector_il<>, rank_support_il<>, select_support_il<>>("bit_vector_il", bv);
+    run_bitvector<bit_vector_cl<>, rank_support_cl<>, select_support_cl<>>("bit_vector_cl", bv);
+    run_bitvector<rrr_vector<15>, rrr_vector<15>::rank_1_type, rrr_vector<15>::select_1_type>("rrr_vector<15>", bv);
+    run_bitvector<rrr_vector<63>, rrr_vector<63>::rank_1_type, rrr_vector<63>::select_1_type>("rrr_vector<63>", bv);
+    run_bitvector<sd_vector<>, sd_vector<>::rank_1_type, sd_vector<>::select_1_type>("sd_vector", bv);
+    run_bitvector<hyb_vector<>, hyb_vector<>::rank_1_type, hyb_vector<>::select_1_type>("hyb_vector", bv, false);
+    run_bits_sel(bv);
+}
@@ -0,0 +1,243 @@
+/*
+ * Helpers to measure the latency distribution, hardware counters and the
+ * multithreaded throughput of the queries in the indexing benchmarks.
+ *
+ * The results are written in the `# key = value` format of the result files,
+ * so that they can be read by `data_frame_from_key_value_pairs` in
+ * basic_functions.R.
+ */
+#ifndef SDSL_BENCHMARK_QUERY_LATENCY
+#define SDSL_BENCHMARK_QUERY_LATENCY
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench
+{
+
+typedef std::chrono::steady_clock clock_type;
+
+inline uint64_t elapsed_ns(clock_type::time_point begin, clock_type::time_point end)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end-begin).count();
+}
+
+// Histogram of latencies in nanoseconds. Each power of two is divided into
+// 32 buckets, so percentiles have a relative error of at most 1/32.
+class latency_histogram
+{
+    private:
+        static const uint32_t sub_bits = 5;
+        std::vector<uint64_t> m_cnt;
+        uint64_t m_n = 0, m_sum = 0, m_max = 0;
+
+        static size_t bucket(uint64_t ns)
+        {
+            if (ns < (1ULL<<sub_bits)) {
+                return ns;
+            }
+            uint32_t e = 63-__builtin_clzll(ns);
+            return ((size_t)(e-sub_bits+1)<<sub_bits) + ((ns>>(e-sub_bits)) & ((1ULL<<sub_bits)-1));
+        }
+        // smallest latency of a bucket
+        static uint64_t lower(size_t b)
+        {
+            if (b < (1ULL<<sub_bits)) {
+                return b;
+            }
+            uint32_t e = (b>>sub_bits)+sub_bits-1;
+            return ((1ULL<<sub_bits) + (b & ((1ULL<<sub_bits)-1))) << (e-sub_bits);
+        }
+    public:
+        latency_histogram() : m_cnt((64-sub_bits+1)<<sub_bits, 0) {}
+
+        void add(uint64_t ns)
+        {
+            ++m_cnt[bucket(ns)];
+            ++m_n;
+            m_sum += ns;
+            m_max = std::max(m_max, ns);
+        }
+
+        uint64_t count() const { return m_n; }
+        uint64_t max() const { return m_max; }
+        double mean() const { return m_n ? (double)m_sum/m_n : 0; }
+
+        // Upper bound of the latency of the q-quantile (0 < q <= 1).
+        uint64_t percentile(double q) const
+        {
+            uint64_t rank = std::max((uint64_t)1, (uint64_t)(q*m_n + 0.999999));
+            uint64_t cum = 0;
+            for (size_t b=0; b < m_cnt.size(); ++b) {
+                cum += m_cnt[b];
+                if (cum >= rank) {
+                    return std::min(m_max, b+1 < m_cnt.size() ? lower(b+1)-1 : m_max);
+                }
+            }
+            return m_max;
+        }
+};
+
+// Counts the CPU cycles and cache misses of the calling thread. If the
+// perf_event interface is not available (e.g. kernel.perf_event_paranoid
+// is too restrictive) available() is false and the counters are 0.
+class perf_counters
+{
+    private:
+        int m_fd[2] = {-1, -1};
+#ifdef __linux__
+        static int open_counter(uint64_t config)
+        {
+            struct perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.type           = PERF_TYPE_HARDWARE;
+            attr.size           = sizeof(attr);
+            attr.config         = config;
+            attr.disabled       = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        }
+#endif
+        uint64_t read_counter(int fd) const
+        {
+            uint64_t value = 0;
+#ifdef __linux__
+            if (fd < 0 or read(fd, &value, sizeof(value)) != sizeof(value)) {
+                return 0;
+            }
+#endif
+            return value;
+        }
+    public:
+        perf_counters()
+        {
+#ifdef __linux__
+            m_fd[0] = open_counter(PERF_COUNT_HW_CPU_CYCLES);
+            m_fd[1] = open_counter(PERF_COUNT_HW_CACHE_MISSES);
+#endif
+        }
+        ~perf_counters()
+        {
+#ifdef __linux__
+            for (int fd : m_fd) {
+                if (fd >= 0) {
+                    close(fd);
+                }
+            }
+#endif
+        }
+        perf_counters(const perf_counters&) = delete;
+        perf_counters& operator=(const perf_counters&) = delete;
+
+        bool available() const { return m_fd[0] >= 0; }
+
+        void start()
+        {
+#ifdef __linux__
+            for (int fd : m_fd) {
+                if (fd >= 0) {
+                    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+                }
+            }
+#endif
+        }
+        void stop()
+        {
+#ifdef __linux__
+            for (int fd : m_fd) {
+                if (fd >= 0) {
+                    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+                }
+            }
+#endif
+        }
+        uint64_t cycles() const { return read_counter(m_fd[0]); }
+        uint64_t cache_misses() const { return read_counter(m_fd[1]); }
+};
+
+// Thread counts 1,2,4,... and the number of hardware threads.
+inline std::vector<uint32_t> thread_counts()
+{
+    uint32_t max_threads = std::max(1U, std::thread::hardware_concurrency());
+    std::vector<uint32_t> res;
+    for (uint32_t t=1; t < max_threads; t*=2) {
+        res.push_back(t);
+    }
+    res.push_back(max_threads);
+    return res;
+}
+
+// Executes query(0),...,query(n-1) with the given number of threads and
+// returns the number of queries per second. query has to be thread-safe and
+// return a number (e.g. the number of occurrences), which is summed up so
+// that the queries are not optimized away.
+template<class t_query>
+double queries_per_second(size_t n, uint32_t threads, t_query query)
+{
+    const size_t chunk = 64;
+    std::atomic<size_t> next(0);
+    std::atomic<uint64_t> checksum(0);
+    std::vector<std::thread> workers;
+    auto begin = clock_type::now();
+    for (uint32_t t=0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            uint64_t sum = 0;
+            for (size_t i = next.fetch_add(chunk); i < n; i = next.fetch_add(chunk)) {
+                for (size_t j=i; j < std::min(n, i+chunk); ++j) {
+                    sum += query(j);
+                }
+            }
+            checksum += sum;
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    uint64_t ns = elapsed_ns(begin, clock_type::now());
+    static volatile uint64_t sink;
+    sink = checksum;
+    return ns ? n*1e9/ns : 0;
+}
+
+// Writes the percentiles and the counters per query as `# <name>_... = value`.
+inline void report_latency(const char* name, const latency_histogram& h, const perf_counters& perf)
+{
+    fprintf(stderr, "# %s_latency_mean_ns = %.1f\n", name, h.mean());
+    fprintf(stderr, "# %s_latency_p50_ns = %lu\n", name, (unsigned long)h.percentile(0.5));
+    fprintf(stderr, "# %s_latency_p99_ns = %lu\n", name, (unsigned long)h.percentile(0.99));
+    fprintf(stderr, "# %s_latency_p999_ns = %lu\n", name, (unsigned long)h.percentile(0.999));
+    fprintf(stderr, "# %s_latency_max_ns = %lu\n", name, (unsigned long)h.max());
+    double n = std::max((uint64_t)1, h.count());
+    // -1 marks that the hardware counters are not available
+    fprintf(stderr, "# %s_cycles_per_query = %.1f\n", name, perf.available() ? perf.cycles()/n : -1.0);
+    fprintf(stderr, "# %s_cache_misses_per_query = %.2f\n", name, perf.available() ? perf.cache_misses()/n : -1.0);
+}
+
+// Measures and writes the throughput for thread_counts() as
+// `# <name>_qps_threads_<t> = value`.
+template<class t_query>
+void report_throughput(const char* name, size_t n, t_query query)
+{
+    for (uint32_t t : thread_counts()) {
+        fprintf(stderr, "# %s_qps_threads_%u = %.1f\n", name, t, queries_per_second(n, t, query));
+    }
+}
+
+} // end namespace bench
+
+#endif
@@ -0,0 +1,53 @@
+#include <sdsl/query_server.hpp>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace sdsl;
+using namespace std;
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        cout << "Usage: " << argv[0] << " socket_path" << endl;
+        cout << " Reads queries from stdin, one per line:" << endl;
+        cout << "   count PATTERN | locate PATTERN | extract BEGIN END | kmismatch K PATTERN" << endl;
+        cout << " and prints the answers of the index-server." << endl;
+        return 1;
+    }
+    query_client client(argv[1]);
+    string line;
+    while (getline(cin, line)) {
+        istringstream in(line);
+        string op;
+        in >> op;
+        try {
+            if (op == "count") {
+                string pat;
+                in >> pat;
+                cout << client.count(pat) << endl;
+            } else if (op == "locate" or op == "kmismatch") {
+                uint32_t k = 0;
+                string pat;
+                if (op == "kmismatch") {
+                    in >> k;
+                }
+                in >> pat;
+                auto occ = op == "locate" ? client.locate(pat) : client.k_mismatch(pat, k);
+                cout << occ.size() << ":";
+                for (auto x : occ) {
+                    cout << " " << x;
+                }
+                cout << endl;
+            } else if (op == "extract") {
+                uint64_t begin, end;
+                in >> begin >> end;
+                cout << client.extract(begin, end) << endl;
+            } else if (!op.empty()) {
+                cerr << "Unknown query " << op << endl;
+            }
+        } catch (const std::runtime_error& e) {
+            cerr << e.what() << endl;
+        }
+    }
+}
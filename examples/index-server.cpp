@@ -0,0 +1,59 @@
+#include <sdsl/query_server.hpp>
+#include <sdsl/suffix_arrays.hpp>
+#include <sdsl/suffix_trees.hpp>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace sdsl;
+using namespace std;
+
+template<class t_index>
+int serve(const string& index_file, const string& text_file, const string& socket_path, uint32_t threads)
+{
+    t_index index;
+    if (!load_from_file(index, index_file)) {
+        construct(index, text_file, 1);
+        store_to_file(index, index_file);
+    }
+    // SIGINT and SIGTERM are blocked in all threads and stop the server
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    query_server<t_index> server(index, socket_path, threads);
+    thread signal_thread([&]() {
+        int sig;
+        sigwait(&signals, &sig);
+        server.stop();
+    });
+    cout << "Serving " << index_file << " on " << socket_path << endl;
+    server.run();
+    signal_thread.join();
+    cout << server.requests() << " requests in " << server.batches() << " batches" << endl;
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 4) {
+        cout << "Usage: " << argv[0] << " csa_wt|cst_sct3 text_file socket_path [threads]" << endl;
+        cout << " (1) Loads the index of text_file or constructs it." << endl;
+        cout << " (2) Answers count, locate, extract and k-mismatch queries" << endl;
+        cout << "     on the Unix domain socket until SIGINT." << endl;
+        return 1;
+    }
+    string type = argv[1];
+    string text_file = argv[2];
+    uint32_t threads = argc > 4 ? stoul(argv[4]) : 0;
+    if (type == "csa_wt") {
+        return serve<csa_wt<>>(text_file+".csa_wt", text_file, argv[3], threads);
+    } else if (type == "cst_sct3") {
+        return serve<cst_sct3<>>(text_file+".cst_sct3", text_file, argv[3], threads);
+    }
+    cerr << "Unknown index type " << type << endl;
+    return 1;
+}
@@ -0,0 +1,494 @@
+/*!\file bit_vector_cl.hpp
+   \brief bit_vector_cl.hpp contains the sdsl::bit_vector_cl class, and
+          classes which support rank and select for bit_vector_cl.
+
+   The bits are stored in 64-byte lines which also hold the rank counts of
+   the line, so a rank query touches a single cache line.
+*/
+#ifndef INCLUDED_SDSL_BIT_VECTOR_CL
+#define INCLUDED_SDSL_BIT_VECTOR_CL
+
+#include "int_vector.hpp"
+#include "util.hpp"
+#include "iterators.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+//! Namespace for the succinct data structure library
+namespace sdsl
+{
+
+template<uint8_t t_b=1, uint32_t t_ss=4096>// forward declaration needed for friend declaration
+class rank_support_cl;  // in bit_vector_cl
+
+template<uint8_t t_b=1, uint32_t t_ss=4096>// forward declaration needed for friend declaration
+class select_support_cl;  // in bit_vector_cl
+
+//! A bit vector which stores its rank information in the cache lines of the bits.
+/*!
+ * The bits are split into lines of 448 bits. Each line occupies one 64-byte
+ * aligned cache line: a header word followed by the 7 data words. The header
+ * stores in its upper 32 bits the number of ones before the line, relative
+ * to a group of 2^23 lines, and in its lower 27 bits the number of ones
+ * before the data words 2, 4 and 6 of the line (9 bits each). The absolute
+ * counts of the groups are kept in a small array. rank therefore reads one
+ * cache line and computes at most two popcounts.
+ *
+ * For select the line of every t_ss-th one and zero is sampled; the line of
+ * a select query is found by a search on the headers between two samples.
+ *
+ * The space overhead is 14.3% for the headers plus the select samples.
+ *
+ * \tparam t_ss Sample rate of the select samples.
+ */
+template<uint32_t t_ss=4096>
+class bit_vector_cl
+{
+        static_assert(t_ss > 0 , "bit_vector_cl: sample rate must be positive.");
+    public:
+        typedef bit_vector::size_type                       size_type;
+        typedef size_type                                   value_type;
+        typedef bit_vector::difference_type                 difference_type;
+        typedef random_access_const_iterator<bit_vector_cl> iterator;
+        typedef iterator                                    const_iterator;
+        typedef bv_tag                                      index_category;
+
+        friend class rank_support_cl<1,t_ss>;
+        friend class rank_support_cl<0,t_ss>;
+        friend class select_support_cl<1,t_ss>;
+        friend class select_support_cl<0,t_ss>;
+
+        typedef rank_support_cl<1,t_ss>     rank_1_type;
+        typedef rank_support_cl<0,t_ss>     rank_0_type;
+        typedef select_support_cl<1,t_ss> select_1_type;
+        typedef select_support_cl<0,t_ss> select_0_type;
+
+        //! Number of bits in a line
+        static const size_type line_bits  = 448;
+        //! Number of 64-bit words of a line (header and data)
+        static const size_type line_words = 8;
+        //! log2 of the number of lines in a group
+        static const size_type group_shift = 23;
+    private:
+        size_type      m_size   = 0;  //!< Size of the original bitvector
+        size_type      m_lines  = 0;  //!< Number of lines
+        size_type      m_offset = 0;  //!< Padding words before the first line in m_data
+        int_vector<64> m_data;        //!< Lines; 64-byte aligned after m_offset words
+        int_vector<64> m_groups;      //!< Number of ones before each group of lines
+        int_vector<>   m_sel_1;       //!< Line of every t_ss-th one
+        int_vector<>   m_sel_0;       //!< Line of every t_ss-th zero
+
+        const uint64_t* line(size_type l)const
+        {
+            return m_data.data() + m_offset + l*line_words;
+        }
+
+        //! Number of ones before line l
+        size_type ones_before(size_type l)const
+        {
+            return m_groups[l >> group_shift] + (line(l)[0] >> 32);
+        }
+
+        //! Number of ones before the data word w of the line with header h
+        static size_type ones_before_word(uint64_t h, size_type w)
+        {
+            return ((h << 9) >> (9*(w>>1))) & 0x1FF;
+        }
+
+        //! Moves the lines to a 64-byte boundary of the current buffer
+        void align_lines()
+        {
+            if (m_lines == 0) {
+                return;
+            }
+            uint64_t* data = m_data.data();
+            size_type offset = ((64 - ((uintptr_t)data & 63)) & 63) / 8;
+            if (offset != m_offset) {
+                memmove(data + offset, data + m_offset, m_lines*line_words*sizeof(uint64_t));
+                m_offset = offset;
+            }
+        }
+
+        void copy(const bit_vector_cl& bv)
+        {
+            m_size   = bv.m_size;
+            m_lines  = bv.m_lines;
+            m_offset = bv.m_offset;
+            m_data   = bv.m_data;
+            m_groups = bv.m_groups;
+            m_sel_1  = bv.m_sel_1;
+            m_sel_0  = bv.m_sel_0;
+            align_lines();
+        }
+
+    public:
+        bit_vector_cl() {}
+        bit_vector_cl(const bit_vector_cl& bv)
+        {
+            copy(bv);
+        }
+        bit_vector_cl(bit_vector_cl&&) = default;
+        bit_vector_cl& operator=(const bit_vector_cl& bv)
+        {
+            if (this != &bv) {
+                copy(bv);
+            }
+            return *this;
+        }
+        bit_vector_cl& operator=(bit_vector_cl&&) = default;
+
+        bit_vector_cl(const bit_vector& bv)
+        {
+            m_size  = bv.size();
+            m_lines = m_size/line_bits + 1; // the last line holds the total count
+            m_data  = int_vector<64>(m_lines*line_words + line_words-1, 0);
+            m_offset = ((64 - ((uintptr_t)m_data.data() & 63)) & 63) / 8;
+            m_groups = int_vector<64>((m_lines >> group_shift) + 1, 0);
+
+            const uint64_t* bvp = bv.data();
+            size_type words = (m_size+63)/64;
+            std::vector<size_type> sel_1, sel_0;
+            size_type ones = 0, zeros = 0;
+            uint64_t* p = m_data.data() + m_offset;
+            for (size_type l=0; l < m_lines; ++l, p += line_words) {
+                if ((l & bits::lo_set[group_shift]) == 0) {
+                    m_groups[l >> group_shift] = ones;
+                }
+                uint64_t rel = 0;
+                size_type line_ones = 0;
+                for (size_type w=0; w < line_words-1; ++w) {
+                    size_type k = l*(line_words-1) + w;
+                    uint64_t x = 0;
+                    if (k < words) {
+                        x = bvp[k];
+                        if (64*k + 64 > m_size) {
+                            x &= bits::lo_set[m_size - 64*k];
+                        }
+                    }
+                    if (w > 0 and (w & 1) == 0) {
+                        rel |= line_ones << (9*(w/2-1));
+                    }
+                    p[1+w] = x;
+                    line_ones += bits::cnt(x);
+                }
+                p[0] = ((ones - m_groups[l >> group_shift]) << 32) | rel;
+                size_type line_size = 0;
+                if (l*line_bits < m_size) {
+                    line_size = std::min((size_type)line_bits, m_size - l*line_bits);
+                }
+                while (sel_1.size()*t_ss + 1 <= ones + line_ones) {
+                    sel_1.push_back(l);
+                }
+                while (sel_0.size()*t_ss + 1 <= zeros + line_size - line_ones) {
+                    sel_0.push_back(l);
+                }
+                ones  += line_ones;
+                zeros += line_size - line_ones;
+            }
+            uint8_t width = bits::hi(m_lines)+1;
+            m_sel_1 = int_vector<>(sel_1.size(), 0, width);
+            std::copy(sel_1.begin(), sel_1.end(), m_sel_1.begin());
+            m_sel_0 = int_vector<>(sel_0.size(), 0, width);
+            std::copy(sel_0.begin(), sel_0.end(), m_sel_0.begin());
+        }
+
+        //! Accessing the i-th element of the original bit_vector
+        /*! \param i An index i with \f$ 0 \leq i < size()  \f$.
+         *  \return The i-th bit of the original bit_vector
+         *  \par Time complexity
+         *     \f$ \Order{1} \f$
+         */
+        value_type operator[](size_type i)const
+        {
+            assert(i < m_size);
+            size_type l = i / line_bits;
+            size_type off = i - l*line_bits;
+            return (line(l)[1 + (off>>6)] >> (off&63)) & 1ULL;
+        }
+
+        //! Get the integer value of the binary string of length len starting at position idx.
+        /*! \param idx Starting index of the binary representation of the integer.
+         *  \param len Length of the binary representation of the integer. Default value is 64.
+         *   \returns The integer value of the binary string of length len starting at position idx.
+         *
+         *  \pre idx+len-1 in [0..size()-1]
+         *  \pre len in [1..64]
+         */
+        uint64_t get_int(size_type idx, uint8_t len=64)const
+        {
+            assert(idx+len-1 < m_size);
+            size_type k = idx >> 6;   // word in the original bit_vector
+            uint8_t off = idx & 63;
+            uint64_t res = line(k/7)[1 + k%7] >> off;
+            if (off + len > 64) {
+                ++k;
+                res |= line(k/7)[1 + k%7] << (64-off);
+            }
+            return res & bits::lo_set[len];
+        }
+
+        //! Returns the size of the original bit vector.
+        size_type size()const
+        {
+            return m_size;
+        }
+
+        //! Serializes the data structure into the given ostream
+        size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const
+        {
+            structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
+            size_type written_bytes = 0;
+            written_bytes += write_member(m_size, out, child, "size");
+            written_bytes += write_member(m_lines, out, child, "lines");
+            written_bytes += write_member(m_offset, out, child, "offset");
+            written_bytes += m_data.serialize(out, child, "data");
+            written_bytes += m_groups.serialize(out, child, "groups");
+            written_bytes += m_sel_1.serialize(out, child, "sel_1");
+            written_bytes += m_sel_0.serialize(out, child, "sel_0");
+            structure_tree::add_size(child, written_bytes);
+            return written_bytes;
+        }
+
+        //! Loads the data structure from the given istream.
+        void load(std::istream& in)
+        {
+            read_member(m_size, in);
+            read_member(m_lines, in);
+            read_member(m_offset, in);
+            m_data.load(in);
+            m_groups.load(in);
+            m_sel_1.load(in);
+            m_sel_0.load(in);
+            align_lines();
+        }
+
+        void swap(bit_vector_cl& bv)
+        {
+            if (this != &bv) {
+                std::swap(m_size, bv.m_size);
+                std::swap(m_lines, bv.m_lines);
+                std::swap(m_offset, bv.m_offset);
+                m_data.swap(bv.m_data);
+                m_groups.swap(bv.m_groups);
+                m_sel_1.swap(bv.m_sel_1);
+                m_sel_0.swap(bv.m_sel_0);
+            }
+        }
+
+        iterator begin() const
+        {
+            return iterator(this, 0);
+        }
+
+        iterator end() const
+        {
+            return iterator(this, size());
+        }
+};
+
+template<uint8_t t_b, uint32_t t_ss>
+class rank_support_cl
+{
+        static_assert(t_b == 1 or t_b == 0 , "rank_support_cl only supports bitpatterns 0 or 1.");
+    public:
+        typedef bit_vector::size_type size_type;
+        typedef bit_vector_cl<t_ss>   bit_vector_type;
+        enum { bit_pat = t_b };
+        enum { bit_pat_len = (uint8_t)1 };
+    private:
+        const bit_vector_type* m_v;
+
+        inline size_type rank1(size_type i) const
+        {
+            size_type l = i / bit_vector_type::line_bits;
+            size_type off = i - l*bit_vector_type::line_bits;
+            size_type w = off >> 6;
+            const uint64_t* p = m_v->line(l);
+            uint64_t h = p[0];
+            // for an odd word w the preceding word p[w] is added
+            return m_v->m_groups[l >> bit_vector_type::group_shift] + (h >> 32)
+                   + bit_vector_type::ones_before_word(h, w)
+                   + bits::cnt(p[w] & -(uint64_t)(w&1))
+                   + bits::cnt(p[1+w] & bits::lo_set[off&63]);
+        }
+
+    public:
+
+        rank_support_cl(const bit_vector_type* v=nullptr)
+        {
+            set_vector(v);
+        }
+
+        //! Returns the number of occurrences of the bit pattern in [0..i-1].
+        SDSL_TARGET_CLONES size_type rank(size_type i) const
+        {
+            if (t_b) return rank1(i);
+            return i - rank1(i);
+        }
+
+        size_type operator()(size_type i)const
+        {
+            return rank(i);
+        }
+
+        //! Answers n independent rank queries: out[j] = rank(idx[j]) for \f$j\in[0..n-1]\f$.
+        /*! The lines of a chunk of queries are prefetched before the ranks
+         *  are computed.
+         */
+        SDSL_TARGET_CLONES void rank_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            util::batch(n, [&](size_type j) {
+                util::prefetch(m_v->line(idx[j] / bit_vector_type::line_bits));
+            }, [&](size_type j) {
+                out[j] = rank(idx[j]);
+            });
+        }
+
+        size_type size()const
+        {
+            return m_v->size();
+        }
+
+        void set_vector(const bit_vector_type* v=nullptr)
+        {
+            m_v = v;
+        }
+
+        rank_support_cl& operator=(const rank_support_cl& rs)
+        {
+            if (this != &rs) {
+                set_vector(rs.m_v);
+            }
+            return *this;
+        }
+
+        void swap(rank_support_cl&) { }
+
+        void load(std::istream&, const bit_vector_type* v=nullptr)
+        {
+            set_vector(v);
+        }
+
+        size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const
+        {
+            return serialize_empty_object(out, v, name, this);
+        }
+};
+
+
+template<uint8_t t_b, uint32_t t_ss>
+class select_support_cl
+{
+        static_assert(t_b == 1 or t_b == 0 , "select_support_cl only supports bitpatterns 0 or 1.");
+    public:
+        typedef bit_vector::size_type size_type;
+        typedef bit_vector_cl<t_ss>   bit_vector_type;
+        enum { bit_pat = t_b };
+        enum { bit_pat_len = (uint8_t)1 };
+    private:
+        const bit_vector_type* m_v;
+
+        //! Number of occurrences of the bit pattern before line l
+        size_type before(size_type l)const
+        {
+            size_type ones = m_v->ones_before(l);
+            return t_b ? ones : l*bit_vector_type::line_bits - ones;
+        }
+
+        //! Number of occurrences of the bit pattern before the data word w of the line with header h
+        static size_type before_word(uint64_t h, size_type w)
+        {
+            size_type ones = bit_vector_type::ones_before_word(h, w);
+            return t_b ? ones : 64*w - ones;
+        }
+
+    public:
+
+        select_support_cl(const bit_vector_type* v=nullptr)
+        {
+            set_vector(v);
+        }
+
+        //! Returns the position of the i-th occurrence in the bit vector.
+        size_type select(size_type i) const
+        {
+            const int_vector<>& samples = t_b ? m_v->m_sel_1 : m_v->m_sel_0;
+            size_type k  = (i-1) / t_ss;
+            size_type lb = samples[k];
+            size_type rb = k+1 < samples.size() ? samples[k+1] : m_v->m_lines-1;
+            // find the last line l in [lb..rb] with before(l) < i
+            while (rb - lb > 8) {
+                size_type mid = lb + (rb-lb+1)/2;
+                if (before(mid) < i) {
+                    lb = mid;
+                } else {
+                    rb = mid-1;
+                }
+            }
+            while (lb < rb and before(lb+1) < i) {
+                ++lb;
+            }
+            const uint64_t* p = m_v->line(lb);
+            uint64_t h = p[0];
+            i -= before(lb);
+            // number of pairs of data words before the i-th occurrence
+            size_type w = 2*((i > before_word(h, 2)) + (i > before_word(h, 4)) + (i > before_word(h, 6)));
+            i -= before_word(h, w);
+            uint64_t x = t_b ? p[1+w] : ~p[1+w];
+            size_type cnt = bits::cnt(x);
+            if (i > cnt) {
+                i -= cnt;
+                ++w;
+                x = t_b ? p[1+w] : ~p[1+w];
+            }
+            return lb*bit_vector_type::line_bits + 64*w + bits::sel(x, i);
+        }
+
+        size_type operator()(size_type i)const
+        {
+            return select(i);
+        }
+
+        //! Answers n independent select queries: out[j] = select(idx[j]) for \f$j\in[0..n-1]\f$.
+        void select_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            for (size_type j=0; j < n; ++j) {
+                out[j] = select(idx[j]);
+            }
+        }
+
+        size_type size()const
+        {
+            return m_v->size();
+        }
+
+        void set_vector(const bit_vector_type* v=nullptr)
+        {
+            m_v = v;
+        }
+
+        select_support_cl& operator=(const select_support_cl& rs)
+        {
+            if (this != &rs) {
+                set_vector(rs.m_v);
+            }
+            return *this;
+        }
+
+        void swap(select_support_cl&) { }
+
+        void load(std::istream&, const bit_vector_type* v=nullptr)
+        {
+            set_vector(v);
+        }
+
+        size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const
+        {
+            return serialize_empty_object(out, v, name, this);
+        }
+};
+
+} // end namespace sdsl
+#endif
@@ -267,14 +267,7 @@ class rank_support_il
             size_type SBlockPos = (SBlockNum << m_block_size_U64) + SBlockNum;
             uint64_t resp = m_v->m_data[SBlockPos];
             const uint64_t* B = (m_v->m_data.data() + (SBlockPos+1));
-            uint64_t rem = i&63;
-            uint64_t bits = (i&m_block_mask) - rem;
-            while (bits) {
-                resp += bits::cnt(*B++);
-                bits -= 64;
-            }
-            resp += bits::cnt(*B & bits::lo_set[rem]);
-            return resp;
+            return resp + bits::cnt_prefix(B, i&m_block_mask);
         }
 
 
@@ -284,14 +277,7 @@ class rank_support_il
             size_type SBlockPos = (SBlockNum << m_block_size_U64) + SBlockNum;
             uint64_t resp = (SBlockNum << m_block_shift) - m_v->m_data[SBlockPos];
             const uint64_t* B = (m_v->m_data.data() + (SBlockPos+1));
-            uint64_t rem = i&63;
-            uint64_t bits = (i&m_block_mask) - rem;
-            while (bits) {
-                resp += bits::cnt(~(*B)); B++;
-                bits -= 64;
-            }
-            resp += bits::cnt((~(*B)) & bits::lo_set[rem]);
-            return resp;
+            return resp + (i&m_block_mask) - bits::cnt_prefix(B, i&m_block_mask);
         }
 
     public:
@@ -316,6 +302,22 @@ class rank_support_il
             return rank(i);
         }
 
+        //! Answers n independent rank queries: out[j] = rank(idx[j]) for \f$j\in[0..n-1]\f$.
+        /*! The superblocks of a chunk of queries are prefetched before the
+         *  ranks are computed.
+         */
+        void rank_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            util::batch(n, [&](size_type j) {
+                size_type SBlockNum = idx[j] >> m_block_shift;
+                size_type SBlockPos = (SBlockNum << m_block_size_U64) + SBlockNum;
+                util::prefetch(m_v->m_data.data() + SBlockPos);
+                util::prefetch(m_v->m_data.data() + SBlockPos + 1 + ((idx[j]&m_block_mask)>>6));
+            }, [&](size_type j) {
+                out[j] = rank(idx[j]);
+            });
+        }
+
         size_type size()const
         {
             return m_v->size();
@@ -486,6 +488,14 @@ class select_support_il
             return select(i);
         }
 
+        //! Answers n independent select queries: out[j] = select(idx[j]) for \f$j\in[0..n-1]\f$.
+        void select_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            for (size_type j=0; j < n; ++j) {
+                out[j] = select(idx[j]);
+            }
+        }
+
         size_type size()const
         {
             return m_v->size();
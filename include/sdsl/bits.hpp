@@ -24,7 +24,7 @@
 #include <stdint.h> // for uint64_t uint32_t declaration
 #include <iostream>// for cerr
 #include <cassert>
-#ifdef __BMI2__
+#if defined(__BMI2__) or defined(__AVX2__) or defined(__AVX512F__)
 #include <immintrin.h>
 #endif
 #ifdef __SSE4_2__
@@ -35,6 +35,35 @@
 #include "iso646.h"
 #endif
 
+// Portable x86-64 builds (without -msse4.2, see SDSL_PORTABLE) compile the
+// query functions marked with SDSL_TARGET_CLONES once for the baseline, once
+// with popcnt and once with AVX2. The dynamic loader binds each function to
+// the best clone for the CPU (GNU ifunc), so a call costs an indirect jump
+// and no test of the CPU features.
+// All clones share one source, so bits::sel cannot use PDEP in them. Query
+// functions which call bits::sel are therefore declared with
+// SDSL_SEL_VERSIONS: it defines a baseline, a popcnt and a BMI2 version,
+// which inline the template impl with bits::sel_isa<false> (broadword) or
+// bits::sel_isa<true> (PDEP). gcc only accepts multiple versions of a member
+// function if they are defined in the class.
+// Define SDSL_NO_DISPATCH to compile only the baseline version.
+#if not defined(SDSL_NO_DISPATCH) and not defined(__SSE4_2__) and defined(__x86_64__) \
+    and defined(__ELF__) and defined(__GLIBC__) and defined(__GNUC__) \
+    and not defined(__clang__) and not defined(__INTEL_COMPILER) and __GNUC__ >= 8
+#define SDSL_DISPATCH
+#define SDSL_TARGET_CLONES __attribute__((target_clones("default","popcnt","avx2")))
+#define SDSL_SEL_IMPL inline __attribute__((always_inline))
+#define SDSL_SEL_VERSIONS(impl, args, ...) \
+    __attribute__((target("default"))) __VA_ARGS__ { return impl<false> args; } \
+    __attribute__((target("popcnt"))) __VA_ARGS__ { return impl<false> args; } \
+    __attribute__((target("popcnt,bmi2"))) __VA_ARGS__ { return impl<true> args; }
+#else
+#define SDSL_TARGET_CLONES
+#define SDSL_SEL_IMPL inline
+#define SDSL_SEL_VERSIONS(impl, args, ...) \
+    __VA_ARGS__ { return impl<false> args; }
+#endif
+
 //! Namespace for the succinct data structure library.
 namespace sdsl
 {
@@ -109,6 +138,33 @@ struct bits {
      */
     static uint64_t cnt(uint64_t x);
 
+    //! Counts the number of set bits in the words word[0..n-1].
+    /*! Uses AVX-512 VPOPCNTDQ or AVX2 kernels if the code is compiled for
+        them and a scalar loop over cnt(x) otherwise. Portable builds
+        (SDSL_DISPATCH) count long ranges with cnt_words.
+        \param word Pointer to the first word.
+        \param n    Number of words.
+        \return Number of set bits.
+     */
+    static uint64_t cnt(const uint64_t* word, uint64_t n);
+
+    //! Counts the number of set bits in the words word[0..n-1].
+    /*! Compiled into the library once per instruction set (baseline, popcnt
+        and AVX2); the version for the CPU is selected when the program is
+        loaded.
+        \param word Pointer to the first word.
+        \param n    Number of words.
+        \return Number of set bits.
+     */
+    static uint64_t cnt_words(const uint64_t* word, uint64_t n);
+
+    //! Counts the number of set bits in the first len bits starting at word.
+    /*! \param word Pointer to the first word.
+        \param len  Number of bits.
+        \return Number of set bits in the bit range [0..len-1].
+     */
+    static uint64_t cnt_prefix(const uint64_t* word, uint64_t len);
+
     //! Position of the most significant set bit the 64-bit word x
     /*! \param x 64-bit word
         \return The position (in 0..63) of the most significant set bit
@@ -176,6 +232,17 @@ struct bits {
      */
     static uint32_t sel(uint64_t x, uint32_t i);
     static uint32_t _sel(uint64_t x, uint32_t i);
+    static uint32_t _sel_broadword(uint64_t x, uint32_t i);
+
+    //! sel for the impl of SDSL_SEL_VERSIONS functions.
+    /*! sel_isa<false> equals sel. In portable builds sel_isa<true> uses PDEP
+        and may only be called from the BMI2 version of such a function.
+     */
+    template<bool t_pdep>
+    static uint32_t sel_isa(uint64_t x, uint32_t i)
+    {
+        return sel(x, i);
+    }
 
     //! Calculates the position of the i-th rightmost 11-bit-pattern which terminates a Fibonacci coded integer in x.
     /*!	\param x 64 bit integer.
@@ -256,6 +323,8 @@ inline uint64_t bits::cnt(uint64_t x)
            lt_cnt[(x>>32)&0xFFULL] + lt_cnt[(x>>40)&0xFFULL] +
            lt_cnt[(x>>48)&0xFFULL] + lt_cnt[(x>>56)&0xFFULL];
 #else
+    // gcc emits popcnt for this in functions compiled for it, e.g. the
+    // popcnt clones of SDSL_TARGET_CLONES functions
     x = x-((x>>1) & 0x5555555555555555ull);
     x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
     x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
@@ -264,6 +333,67 @@ inline uint64_t bits::cnt(uint64_t x)
 #endif
 }
 
+inline uint64_t bits::cnt(const uint64_t* word, uint64_t n)
+{
+    uint64_t res = 0, i = 0;
+#if defined(__AVX512F__) and defined(__AVX512VPOPCNTDQ__)
+    // the last n%8 words are counted with a masked load, so short ranges
+    // take a single step without branches
+    __m512i acc = _mm512_setzero_si512();
+    for (; i+8 <= n; i += 8) {
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_loadu_si512(word+i)));
+    }
+    if (i < n) {
+        __mmask8 mask = (1U << (n-i)) - 1;
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_maskz_loadu_epi64(mask, word+i)));
+    }
+    // _mm512_reduce_add_epi64, the cast and the unmasked extract use an
+    // undefined vector, which triggers -Wuninitialized in gcc's headers
+    __m256i sum = _mm256_add_epi64(_mm512_maskz_extracti64x4_epi64(0xFF, acc, 0),
+                                   _mm512_maskz_extracti64x4_epi64(0xFF, acc, 1));
+    return _mm256_extract_epi64(sum, 0) + _mm256_extract_epi64(sum, 1)
+           + _mm256_extract_epi64(sum, 2) + _mm256_extract_epi64(sum, 3);
+#elif defined(__AVX2__)
+    // Nibble lookup with pshufb (Mula, Kurz, Lemire); it beats the popcnt
+    // instruction only for longer ranges
+    if (n >= 32) {
+        const __m256i lut = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,
+                                             0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+        const __m256i low = _mm256_set1_epi8(0x0F);
+        __m256i acc = _mm256_setzero_si256();
+        for (; i+4 <= n; i += 4) {
+            __m256i v  = _mm256_loadu_si256((const __m256i*)(word+i));
+            __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, low));
+            __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+        }
+        res = _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1)
+              + _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+    }
+#elif defined(SDSL_DISPATCH)
+    if (n >= 32) {
+        return cnt_words(word, n);
+    }
+#endif
+    // four independent popcounts per iteration
+    for (; i+4 <= n; i += 4) {
+        res += (cnt(word[i]) + cnt(word[i+1])) + (cnt(word[i+2]) + cnt(word[i+3]));
+    }
+    for (; i < n; ++i) {
+        res += cnt(word[i]);
+    }
+    return res;
+}
+
+inline uint64_t bits::cnt_prefix(const uint64_t* word, uint64_t len)
+{
+    uint64_t res = cnt(word, len>>6);
+    if (len & 0x3F) {
+        res += cnt(word[len>>6] & lo_set[len&0x3F]);
+    }
+    return res;
+}
+
 inline uint32_t bits::cnt32(uint32_t x)
 {
     x = x-((x>>1) & 0x55555555);
@@ -329,7 +459,27 @@ inline uint32_t bits::sel(uint64_t x, uint32_t i)
 #ifdef __BMI2__
     // index i is 1-based here, (i-1) changes it to 0-based
     return __builtin_ctzll(_pdep_u64(1ull << (i-1), x));
-#elif defined(__SSE4_2__)
+#elif defined(__SSE4_2__) or defined(SDSL_DISPATCH)
+    return _sel_broadword(x, i);
+#else
+    return _sel(x, i);
+#endif
+}
+
+#ifdef SDSL_DISPATCH
+template<>
+inline uint32_t bits::sel_isa<true>(uint64_t x, uint32_t i)
+{
+    // gcc inlines _pdep_u64 only into functions compiled for BMI2, but not
+    // into the templates between them and sel_isa, e.g. select_support_trait
+    uint64_t res;
+    __asm__("pdep %2, %1, %0" : "=r"(res) : "r"(1ull << (i-1)), "rm"(x));
+    return __builtin_ctzll(res);
+}
+#endif
+
+inline uint32_t bits::_sel_broadword(uint64_t x, uint32_t i)
+{
     uint64_t s = x, b;
     s = s-((s>>1) & 0x5555555555555555ULL);
     s = (s & 0x3333333333333333ULL) + ((s >> 2) & 0x3333333333333333ULL);
@@ -347,9 +497,6 @@ inline uint32_t bits::sel(uint64_t x, uint32_t i)
     s <<= 8;
     i -= (s >> (byte_nr<<3)) & 0xFFULL;
     return (byte_nr << 3) + lt_sel[((i-1) << 8) + ((x>>(byte_nr<<3))&0xFFULL) ];
-#else
-    return _sel(x, i);
-#endif
 }
 
 inline uint32_t bits::_sel(uint64_t x, uint32_t i)
@@ -391,7 +538,7 @@ inline uint32_t bits::_sel(uint64_t x, uint32_t i)
 // http://www-graphics.stanford.edu/~seander/bithacks.html
 inline uint32_t bits::hi(uint64_t x)
 {
-#ifdef __SSE4_2__
+#if defined(__SSE4_2__) or defined(SDSL_DISPATCH)
     if (x == 0)
         return 0;
     return 63 - __builtin_clzll(x);
@@ -417,7 +564,7 @@ inline uint32_t bits::hi(uint64_t x)
 // or page 10, Knuth TAOCP Vol 4 F1A
 inline uint32_t bits::lo(uint64_t x)
 {
-#ifdef __SSE4_2__
+#if defined(__SSE4_2__) or defined(SDSL_DISPATCH)
     if (x==0)
         return 0;
     return __builtin_ctzll(x);
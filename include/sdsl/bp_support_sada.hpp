@@ -27,6 +27,7 @@
 #include "select_support.hpp"
 #include "bp_support_algorithm.hpp"
 #include "fast_cache.hpp"
+#include "query_stats.hpp"
 #include <stack>
 #include <map>
 #include <set>
@@ -96,9 +97,13 @@ class bp_support_sada
         size_type m_med_inner_blocks = 0; // number of inner nodes in the min max tree of the medium sized blocks
 //#define USE_CACHE
 #ifdef USE_CACHE
-        mutable fast_cache find_close_cache;
-        mutable fast_cache find_open_cache;
-        mutable fast_cache select_cache;
+        // the caches are thread local, see fast_cache
+        fast_cache find_close_cache;
+        fast_cache find_open_cache;
+        fast_cache select_cache;
+#endif
+#ifdef SDSL_QUERY_STATS
+        query_counters<bp_query_stats::COUNTERS> m_query_stats;
 #endif
 
         void copy(const bp_support_sada& bp_support)
@@ -116,6 +121,17 @@ class bp_support_sada
             m_sml_blocks       = bp_support.m_sml_blocks;
             m_med_blocks       = bp_support.m_med_blocks;
             m_med_inner_blocks = bp_support.m_med_inner_blocks;
+            clear_caches();
+        }
+
+        // Invalidates the cached answers after the structure changed
+        void clear_caches()
+        {
+#ifdef USE_CACHE
+            find_close_cache.clear();
+            find_open_cache.clear();
+            select_cache.clear();
+#endif
         }
 
         inline static size_type sml_block_idx(size_type i)
@@ -457,6 +473,7 @@ class bp_support_sada
                 m_sml_blocks       = std::move(bp_support.m_sml_blocks);
                 m_med_blocks       = std::move(bp_support.m_med_blocks);
                 m_med_inner_blocks = std::move(bp_support.m_med_inner_blocks);
+                clear_caches();
             }
             return *this;
         }
@@ -479,6 +496,8 @@ class bp_support_sada
             std::swap(m_sml_blocks, bp_support.m_sml_blocks);
             std::swap(m_med_blocks, bp_support.m_med_blocks);
             std::swap(m_med_inner_blocks, bp_support.m_med_inner_blocks);
+            clear_caches();
+            bp_support.clear_caches();
         }
 
         //! Assignment operator
@@ -526,11 +545,14 @@ class bp_support_sada
          */
         size_type select(size_type i)const
         {
+            SDSL_QUERY_COUNT(m_query_stats, bp_query_stats::SELECT);
 #ifdef USE_CACHE
             size_type a = 0;
             if (select_cache.exists(i, a)) {
+                SDSL_QUERY_COUNT(m_query_stats, bp_query_stats::CACHE_HIT);
                 return a;
             } else {
+                SDSL_QUERY_COUNT(m_query_stats, bp_query_stats::CACHE_MISS);
                 a = m_bp_select(i);
                 select_cache.write(i, a);
                 return a;
@@ -551,11 +573,14 @@ class bp_support_sada
             if (!(*m_bp)[i]) {// if there is a closing parenthesis at index i return i
                 return i;
             }
+            SDSL_QUERY_COUNT(m_query_stats, bp_query_stats::FIND_CLOSE);
 #ifdef USE_CACHE
             size_type a = 0;
             if (find_close_cache.exists(i, a)) {
+                SDSL_QUERY_COUNT(m_query_stats, bp_query_stats::CACHE_HIT);
                 return a;
             } else {
+                SDSL_QUERY_COUNT(m_query_stats, bp_query_stats::CACHE_MISS);
                 a = fwd_excess(i, -1);
                 find_close_cache.write(i, a);
                 return a;
@@ -576,11 +601,14 @@ class bp_support_sada
             if ((*m_bp)[i]) {// if there is a opening parenthesis at index i return i
                 return i;
             }
+            SDSL_QUERY_COUNT(m_query_stats, bp_query_stats::FIND_OPEN);
 #ifdef USE_CACHE
             size_type a = 0;
             if (find_open_cache.exists(i, a)) {
+                SDSL_QUERY_COUNT(m_query_stats, bp_query_stats::CACHE_HIT);
                 return a;
             } else {
+                SDSL_QUERY_COUNT(m_query_stats, bp_query_stats::CACHE_MISS);
                 size_type bwd_ex = bwd_excess(i,0);
                 if (bwd_ex == size())
                     a = size();
@@ -608,6 +636,7 @@ class bp_support_sada
             if (!(*m_bp)[i]) { // if there is closing parenthesis at position i
                 return find_open(i);
             }
+            SDSL_QUERY_COUNT(m_query_stats, bp_query_stats::ENCLOSE);
             size_type bwd_ex = bwd_excess(i, -2);
             if (bwd_ex == size())
                 return size();
@@ -920,6 +949,7 @@ class bp_support_sada
 
             written_bytes += m_sml_block_min_max.serialize(out, child, "sml_blocks");
             written_bytes += m_med_block_min_max.serialize(out, child, "med_blocks");
+            SDSL_QUERY_STATS_ONLY(m_query_stats.add_to(child, bp_query_stats::name);)
 
             structure_tree::add_size(child, written_bytes);
             return written_bytes;
@@ -944,6 +974,7 @@ class bp_support_sada
 
             m_sml_block_min_max.load(in);
             m_med_block_min_max.load(in);
+            clear_caches();
         }
 };
 
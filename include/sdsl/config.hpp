@@ -11,6 +11,12 @@ namespace conf  // namespace for library constant
 {
 // size of the buffer for reading and writing data in elements (not in bytes)
 const uint64_t SDSL_BLOCK_SIZE = (uint64_t)1<<22;
+// the memory_monitor merges the allocations of a thread into the global
+// usage after their sum changed by at least this many bytes
+const int64_t SDSL_MEMORY_MONITOR_MERGE_SIZE = (int64_t)1<<16;
+// number of fast_cache tables each thread keeps; the tables of the least
+// recently used caches are reused
+const uint64_t SDSL_FAST_CACHE_TABLES = 8;
 
 const char KEY_BWT[] 		= "bwt";
 const char KEY_BWT_INT[]	= "bwt_int";
@@ -32,6 +38,8 @@ enum format_type {JSON_FORMAT, R_FORMAT, HTML_FORMAT};
 
 enum byte_sa_algo_type {LIBDIVSUFSORT, SE_SAIS};
 
+enum byte_bwt_algo_type {BWT_FROM_SA, DIVBWT};
+
 //! Helper class for construction process
 struct cache_config {
     bool 		delete_files;   // Flag which indicates if all files which were created
@@ -42,7 +50,10 @@ struct cache_config {
     // a concatenation of PID and a unique ID inside the
     // current process.
     tMSS 		file_map;		// Files stored during the construction process.
-    cache_config(bool f_delete_files=true, std::string f_dir="./", std::string f_id="", tMSS f_file_map=tMSS());
+    uint64_t    memory_budget;  // Upper bound in bytes for the RAM used by
+    // semi-external construction algorithms. 0 means
+    // no bound.
+    cache_config(bool f_delete_files=true, std::string f_dir="./", std::string f_id="", tMSS f_file_map=tMSS(), uint64_t f_memory_budget=0);
 };
 
 //! Helper classes to transform width=0 and width=8 to corresponding text key
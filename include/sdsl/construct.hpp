@@ -137,21 +137,34 @@ void construct(t_index& idx, const std::string& file, cache_config& config, uint
         }
         register_cache_file(KEY_TEXT, config);
     }
-    {
-        // (2) check, if the suffix array is cached
-        auto event = memory_monitor::event("SA");
-        if (!cache_file_exists(conf::KEY_SA, config)) {
-            construct_sa<t_index::alphabet_category::WIDTH>(config);
-        }
-        register_cache_file(conf::KEY_SA, config);
-    }
-    {
-        //  (3) construct BWT
+    // The BWT can be calculated directly if the CSA does not need the SA for its samples
+    bool bwt_direct = t_index::alphabet_category::WIDTH == 8 and csa_without_sa<t_index>::value
+                      and construct_config::byte_algo_bwt == DIVBWT
+                      and !cache_file_exists(conf::KEY_SA, config);
+    if (bwt_direct) {
+        //  (2+3) construct BWT without SA
         auto event = memory_monitor::event("BWT");
         if (!cache_file_exists(KEY_BWT, config)) {
-            construct_bwt<t_index::alphabet_category::WIDTH>(config);
+            construct_bwt_direct(config);
         }
         register_cache_file(KEY_BWT, config);
+    } else {
+        {
+            // (2) check, if the suffix array is cached
+            auto event = memory_monitor::event("SA");
+            if (!cache_file_exists(conf::KEY_SA, config)) {
+                construct_sa<t_index::alphabet_category::WIDTH>(config);
+            }
+            register_cache_file(conf::KEY_SA, config);
+        }
+        {
+            //  (3) construct BWT
+            auto event = memory_monitor::event("BWT");
+            if (!cache_file_exists(KEY_BWT, config)) {
+                construct_bwt<t_index::alphabet_category::WIDTH>(config);
+            }
+            register_cache_file(KEY_BWT, config);
+        }
     }
     {
         //  (4) use BWT to construct the CSA
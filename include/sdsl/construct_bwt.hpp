@@ -65,8 +65,10 @@ void construct_bwt(cache_config& config)
     //  (2) Prepare to stream SA from disc and BWT to disc
     size_type buffer_size = 1000000; // buffer_size is a multiple of 8!, TODO: still true?
     int_vector_buffer<> sa_buf(cache_file_name(conf::KEY_SA, config), std::ios::in, buffer_size);
+    sa_buf.async_io(true);
     std::string bwt_file = cache_file_name(KEY_BWT, config);
     bwt_type bwt_buf(bwt_file, std::ios::out, buffer_size, bwt_width);
+    bwt_buf.async_io(true);
 
     //  (3) Construct BWT sequentially by streaming SA and random access to text
     size_type to_add[2] = {(size_type)-1,n-1};
@@ -77,6 +79,19 @@ void construct_bwt(cache_config& config)
     register_cache_file(KEY_BWT, config);
 }
 
+//! Constructs the Burrows and Wheeler Transform (BWT) from a text over byte-alphabet without a suffix array.
+/*!	The BWT is calculated in-place in the text by DivSufSort's divbwt and stored to disk.
+ *  The suffix array is neither stored nor required.
+ *  \param config	Reference to cache configuration
+ *  \par Space complexity
+ *		\f$ 5n \f$ byte for input < 2GB and \f$ 9n \f$ byte otherwise
+ *  \pre Text exist in the cache. Key
+ *         * conf::KEY_TEXT
+ *  \post BWT exist in the cache. Key
+ *         * conf::KEY_BWT
+ */
+void construct_bwt_direct(cache_config& config);
+
 }// end namespace
 
 #endif
@@ -10,6 +10,7 @@ class construct_config
 {
     public:
         static byte_sa_algo_type byte_algo_sa;
+        static byte_bwt_algo_type byte_algo_bwt;
 
         construct_config() = delete;
 };
@@ -74,6 +74,7 @@ void construct_lcp_kasai(cache_config& config)
             return;
         }
         int_vector_buffer<> isa_buf(cache_file_name(conf::KEY_ISA, config), std::ios::in, 1000000); // init isa file_buffer
+        isa_buf.async_io(true);
         int_vector<> sa;
         if (!load_from_cache(sa, conf::KEY_SA, config)) {
             return;
@@ -129,6 +130,7 @@ void construct_lcp_PHI(cache_config& config)
     typedef int_vector<t_width> text_type;
     const char* KEY_TEXT = key_text_trait<t_width>::KEY_TEXT;
     int_vector_buffer<> sa_buf(cache_file_name(conf::KEY_SA, config));
+    sa_buf.async_io(true);
     size_type n = sa_buf.size();
 
     assert(n > 0);
@@ -170,6 +172,7 @@ void construct_lcp_PHI(cache_config& config)
     std::string lcp_file = cache_file_name(conf::KEY_LCP, config);
     size_type buffer_size = 1000000; // buffer_size is a multiple of 8!
     int_vector_buffer<> lcp_buf(lcp_file, std::ios::out, buffer_size, lcp_width);   // open buffer for lcp
+    lcp_buf.async_io(true);
     lcp_buf[0] = 0;
     sa_buf.buffersize(buffer_size);
     for (size_type i=1; i < n; ++i) {
@@ -5,10 +5,15 @@
 #include "int_vector.hpp"
 #include "rank_support.hpp"
 #include "select_support.hpp"
+#include <algorithm>
 #include <cmath>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace sdsl
 {
@@ -45,17 +50,168 @@ uint64_t _get_next_lms_position(int_vector_type& text, uint64_t i)
 void
 _construct_sa_IS(int_vector<> &text, int_vector<> &sa,
                  std::string& filename_sa, size_t n, size_t text_offset,
-                 size_t sigma, uint64_t recursion);
+                 size_t sigma, uint64_t recursion, uint64_t buffersize=1024*1024/8);
 
+//! Maximal number of partitions of _construct_sa_se. All but one are buffered in a file on disk.
+const uint64_t sa_se_max_parts = 256;
+
+//! Number of entries which the threads of _construct_sa_se process at once.
+const uint64_t sa_se_window = (uint64_t)1<<14;
+
+//! Calls f(b, e) for up to threads disjoint chunks [b, e) of [begin, end) in parallel.
+template<class t_f>
+void _sa_se_parallel_for(uint64_t begin, uint64_t end, uint64_t threads, t_f f)
+{
+    // smaller chunks do not pay for starting a thread
+    const uint64_t min_chunk = 1024;
+    uint64_t chunks = std::max((uint64_t)1, std::min(threads, (end-begin)/min_chunk));
+    uint64_t chunk = (end-begin+chunks-1)/chunks;
+    std::vector<std::future<void>> done;
+    for (uint64_t b=begin+chunk; b < end; b+=chunk) {
+        done.push_back(std::async(std::launch::async, f, b, std::min(end, b+chunk)));
+    }
+    f(begin, std::min(end, begin+chunk));
+    for (auto& d : done) {
+        d.get();
+    }
+}
+
+//! Looks up the symbols which precede the suffixes of an induced sorting scan.
+/*! The symbols of the next sa_se_window entries of the partition are looked
+ *  up in parallel, which hides the latency of the random accesses to the
+ *  text. A symbol is only used if the entry still holds the same suffix when
+ *  the scan reaches it; suffixes induced into the window later are looked up
+ *  by the scan itself.
+ */
+template<class int_vector_type>
+class _sa_se_preceding_symbols
+{
+    private:
+        const int_vector_type& m_text;
+        uint64_t               m_threads;
+        bool                   m_forward; // direction of the scan
+        int_vector<64>         m_idx;     // suffixes of the window
+        int_vector<64>         m_sym;     // their preceding symbols
+        uint64_t               m_begin = 0, m_end = 0;
+
+        void fill(const int_vector<>& array, uint64_t i)
+        {
+            if (m_forward) {
+                m_begin = i;
+                m_end = std::min(array.size(), i+sa_se_window);
+            } else {
+                m_begin = i+1-std::min(i+1, sa_se_window);
+                m_end = i+1;
+            }
+            _sa_se_parallel_for(m_begin, m_end, m_threads, [&](uint64_t b, uint64_t e) {
+                for (uint64_t j=b; j<e; ++j) {
+                    uint64_t idx = array[j];
+                    m_idx[j-m_begin] = idx;
+                    m_sym[j-m_begin] = m_text[(idx == 0 ? m_text.size() : idx)-1];
+                }
+            });
+        }
+    public:
+        _sa_se_preceding_symbols(const int_vector_type& text, uint64_t threads, bool forward) :
+            m_text(text), m_threads(threads), m_forward(forward)
+        {
+            if (m_threads > 1) {
+                m_idx.resize(sa_se_window);
+                m_sym.resize(sa_se_window);
+            }
+        }
+
+        //! Symbol text[idx-1] (text[n-1] for idx=0) of the suffix idx which is stored in array[i].
+        uint64_t operator()(const int_vector<>& array, uint64_t i, uint64_t idx)
+        {
+            if (m_threads > 1) {
+                if (i < m_begin or i >= m_end) {
+                    fill(array, i);
+                }
+                if (m_idx[i-m_begin] == idx) {
+                    return m_sym[i-m_begin];
+                }
+            }
+            return m_text[(idx == 0 ? m_text.size() : idx)-1];
+        }
+
+        //! Has to be called after the partition was reloaded.
+        void reset()
+        {
+            m_begin = m_end = 0;
+        }
+};
+
+//! Determines the number of in-memory partitions and the buffer size of _construct_sa_se.
+/*! \param n              Length of the text.
+ *  \param int_width      Width of the partition entries.
+ *  \param resident_bytes Space which stays in memory during the whole construction.
+ *  \param memory_budget  Upper bound for the memory usage in bytes. 0 means no bound.
+ *  \param parts          Number of partitions. All but one are buffered on disk.
+ *  \param buffersize     Buffer size of the int_vector_buffers in bytes.
+ *  \throws std::invalid_argument if the budget does not cover the resident space,
+ *          at most sa_se_max_parts partitions and 4 KiB blocks for all buffers.
+ */
+inline void _construct_sa_se_params(uint64_t n, uint8_t int_width, uint64_t resident_bytes,
+                                    uint64_t memory_budget, size_t& parts, uint64_t& buffersize)
+{
+    parts = 10;
+    buffersize = 1024*1024/8;
+    if (0 == memory_budget) {
+        return;
+    }
+    uint64_t avail = memory_budget > resident_bytes ? memory_budget-resident_bytes : 0;
+    // Half of the available memory is used for the partition, the other half for the buffers
+    uint64_t array_bytes = (n*int_width+7)/8;
+    parts = avail/2 > 0 ? std::max((uint64_t)1, (array_bytes+avail/2-1)/(avail/2)) : sa_se_max_parts+1;
+    // The buffers of the partitions and a few small ones keep one block in memory,
+    // the at most four scan buffers with asynchronous I/O three blocks each
+    const uint64_t blocks = parts + 3*4;
+    if (parts > sa_se_max_parts or avail/2 < blocks*4096) {
+        throw std::invalid_argument("_construct_sa_se: memory budget of "+util::to_string(memory_budget)
+                                    +" bytes is too small for a text of length "+util::to_string(n));
+    }
+    buffersize = std::min(buffersize, avail/2/blocks);
+}
+
+//! Semi-external construction of the suffix array by induced sorting.
+/*! \param text          Text, terminated by a unique 0 symbol.
+ *  \param filename_sa   File the suffix array is written to.
+ *  \param sigma         Size of the alphabet of the text.
+ *  \param recursion     Recursion level, 0 for the initial call.
+ *  \param memory_budget Upper bound for the memory usage in bytes. 0 means no bound.
+ *  \param threads       Number of threads; 0 uses one per hardware thread.
+ *  \par The threads look up the text symbols of the induced sorting scans
+ *        ahead of the scans (see _sa_se_preceding_symbols), compare the LMS
+ *        strings when they are renamed (step 5) and map the suffix array of
+ *        the reduced text back to LMS positions (step 9). The scans themselves
+ *        are sequential, since each entry may be induced by the entries
+ *        scanned before it. Writing the text to disk overlaps steps 1 and 2.
+ *  \sa _construct_sa_se_params
+ */
 template <class int_vector_type >
-void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t sigma, uint64_t recursion)
+void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t sigma, uint64_t recursion,
+                      uint64_t memory_budget=0, uint64_t threads=0)
 {
-    std::string filename_text = tmp_file(filename_sa, "_text_rec"+util::to_string(recursion));
-    store_to_file(text, filename_text);
     uint64_t n = text.size();
     uint64_t nsize = bits::hi(n)+1;
     uint8_t int_width = bits::hi(n-1)+1;
-    uint64_t buffersize = 1024*1024/8;
+    uint64_t buffersize;
+    size_t parts;
+    if (threads == 0) {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    // Besides the text, n entries are reserved for the reduced text of step 7
+    // and the in-memory construction of its suffix array in the recursion,
+    // and two words and a byte per entry of a window for the threads
+    _construct_sa_se_params(n, int_width, size_in_bytes(text)+(n*int_width+63)/64*8+17*(sa_se_window+1),
+                            memory_budget, parts, buffersize);
+
+    std::string filename_text = tmp_file(filename_sa, "_text_rec"+util::to_string(recursion));
+    // Write the text to disk while it is scanned in step 1 and 2
+    std::future<void> text_stored = std::async(std::launch::async, [&]() {
+        store_to_file(text, filename_text);
+    });
 
     // Step 1 - Scan Text from right to left and count LMS, S and L characters and store lms_positions
 
@@ -68,7 +224,6 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
     int_vector<> bkt_s(sigma, 0, int_width);
     int_vector<> bkt_l(sigma, 0, int_width);
     std::string filename_lms_pos_b = tmp_file(filename_sa, "_lms_pos_b"+util::to_string(recursion));
-    size_t parts = 10;
 
     {
         int_vector_buffer<1> lms_pos_b(filename_lms_pos_b, std::ios::out, buffersize, 1);
@@ -105,8 +260,10 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
 
     // Step 2 - Scan Text from right to left and detect LMS-Positions. Sort and write them to disk
     int_vector_buffer<> right(tmp_file(filename_sa, "_right"+util::to_string(recursion)), std::ios::out, buffersize, nsize);
+    right.async_io(true);
     size_t right_pointer=0;
     int_vector_buffer<> left(tmp_file(filename_sa, "_left"+util::to_string(recursion)), std::ios::out, buffersize, nsize);
+    left.async_io(true);
     size_t left_pointer=0;
     {
         for (size_t i=0, tmp2=0, tmp=0; i<sigma; ++i) {
@@ -115,6 +272,7 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
             tmp2 = tmp;
         }
         int_vector_buffer<> lms_positions(tmp_file(filename_sa, "_lms_positions"+util::to_string(recursion)), std::ios::out, buffersize, nsize);
+        lms_positions.async_io(true);
         for (size_t i=n-2, was_s_typ=1, ci=text[n-1]; i<n; --i) {
             uint64_t cip1 = ci;
             ci = text[i];
@@ -129,6 +287,7 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
                 was_s_typ = 1;
             }
         }
+        text_stored.get();
         util::clear(text);
         {
             // Order lms_positions according to first character
@@ -162,6 +321,7 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
         size_t partsize = bkt_l_sum/parts+1;
 
         int_vector<> array(partsize, 0, int_width);
+        _sa_se_preceding_symbols<int_vector_type> preceding(text, threads, true);
         std::vector< int_vector_buffer<> > cached_array(parts-1);
         for (size_t i=0; i<cached_array.size(); ++i) {
             cached_array[i] = int_vector_buffer<>(tmp_file(filename_sa, "_rightbuffer"+util::to_string(i)+"_"+util::to_string(recursion)), std::ios::out, buffersize, nsize);
@@ -179,13 +339,14 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
                         array[src-offset] = val;
                     }
                     cached_array[pos/partsize-1].reset();
+                    preceding.reset();
                 }
 
                 size_t idx = array[pos-offset];
+                size_t symbol = preceding(array, pos-offset, idx);
                 if (idx == 0) {
                     right[right_pointer++] = idx;
                 } else {
-                    size_t symbol = text[idx-1];
                     if (symbol >= c) {
                         size_t val = idx-1;
                         size_t src = bkt_l[symbol];
@@ -259,6 +420,7 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
 
         size_t partsize = bound_s/parts+1;
         int_vector<> array(partsize, 0, int_width);
+        _sa_se_preceding_symbols<int_vector_type> preceding(text, threads, false);
         std::vector< int_vector_buffer<> > cached_array(parts-1);
         for (size_t i=0; i<cached_array.size(); ++i) {
             cached_array[i] = int_vector_buffer<>(tmp_file(filename_sa, "_leftbuffer"+util::to_string(i)+"_"+util::to_string(recursion)), std::ios::out, buffersize, nsize);
@@ -275,14 +437,15 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
                         array[src-offset] = val;
                     }
                     cached_array[offset/partsize].reset();
+                    preceding.reset();
                 }
 
                 size_t idx = array[pos-offset];
+                size_t symbol = preceding(array, pos-offset, idx);
                 if (idx==0) {
                     idx = n;
                 }
                 --idx;
-                size_t symbol = text[idx];
                 if (symbol <= c) {
                     bkt_s[symbol] = bkt_s[symbol] - 1;
                     size_t val = idx;
@@ -335,25 +498,48 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
 
     // Step 5 - Detect same lms-Strings, write text to file
     int_vector<1> same_lms(number_of_lms_strings, false);
-    size_t last_end_pos = first_lms_pos, order = number_of_lms_strings-1;
+    size_t order = number_of_lms_strings-1;
     same_lms[number_of_lms_strings-1] = true;
-    for (size_t i=number_of_lms_strings-2, a=0, b=0, last_a=left[number_of_lms_strings-1]; i<number_of_lms_strings; --i) {
-        b = last_a;
-        a = left[i];
-        last_a = a;
-
-        size_t end_pos = _get_next_lms_position(text, a);
-        if (end_pos-a == last_end_pos-b) {
-            while (a < end_pos and text[a] == text[b]) {
-                ++a;
-                ++b;
+    {
+        // The lms-Strings of a window are compared in parallel; entry k of the
+        // window is left[w-k], entry 0 is the last one of the previous window
+        int_vector<64> lms(sa_se_window+1), end_pos(sa_se_window+1);
+        int_vector<8> same(sa_se_window+1);
+        lms[0] = left[number_of_lms_strings-1];
+        end_pos[0] = first_lms_pos;
+        for (size_t w=number_of_lms_strings-2; w<number_of_lms_strings;) {
+            size_t cnt = std::min(w+1, sa_se_window);
+            for (size_t k=1; k<=cnt; ++k) {
+                lms[k] = left[w+1-k];
             }
-            if (text[a] == text[b]) {
-                same_lms[i] = true;
-                --order;
+            _sa_se_parallel_for(1, cnt+1, threads, [&](uint64_t kb, uint64_t ke) {
+                for (size_t k=kb; k<ke; ++k) {
+                    end_pos[k] = _get_next_lms_position(text, lms[k]);
+                }
+            });
+            _sa_se_parallel_for(1, cnt+1, threads, [&](uint64_t kb, uint64_t ke) {
+                for (size_t k=kb; k<ke; ++k) {
+                    size_t a = lms[k], b = lms[k-1];
+                    same[k] = false;
+                    if (end_pos[k]-a == end_pos[k-1]-b) {
+                        while (a < end_pos[k] and text[a] == text[b]) {
+                            ++a;
+                            ++b;
+                        }
+                        same[k] = (text[a] == text[b]);
+                    }
+                }
+            });
+            for (size_t k=1; k<=cnt; ++k) {
+                if (same[k]) {
+                    same_lms[w+1-k] = true;
+                    --order;
+                }
             }
+            lms[0] = lms[cnt];
+            end_pos[0] = end_pos[cnt];
+            w -= cnt;
         }
-        last_end_pos = end_pos;
     }
     util::clear(text);
 
@@ -407,7 +593,7 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
                 }
             }
             text_rec.resize(number_of_lms_strings);
-            int_vector_buffer<> buf(filename_text_rec_part2, std::ios::in, 1024*1024);
+            int_vector_buffer<> buf(filename_text_rec_part2, std::ios::in, buffersize);
             for (size_t i=0; i<buf.size(); ++i) {
                 text_rec[pos++] = buf[i];
             }
@@ -442,7 +628,9 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
     if (text_rec.size() > order+1) {
         if (recursion==0) {
             memory_monitor::event("begin _construct_sa");
-            _construct_sa_se<int_vector<> >(text_rec, filename_sa_rec, order+1, recursion+1);
+            // The text stays in memory while the recursion runs
+            uint64_t rec_budget = memory_budget ? memory_budget-std::min(memory_budget-1, size_in_bytes(text)) : 0;
+            _construct_sa_se<int_vector<> >(text_rec, filename_sa_rec, order+1, recursion+1, rec_budget, threads);
             memory_monitor::event("end   _construct_sa");
         } else {
             text_rec.resize(text_rec.size()*2);
@@ -451,7 +639,7 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
                 text_rec[i] = 0;
             }
             memory_monitor::event("begin sa_simple");
-            _construct_sa_IS(text_rec, text_rec, filename_sa_rec, number_of_lms_strings, number_of_lms_strings, order+1, recursion+1);
+            _construct_sa_IS(text_rec, text_rec, filename_sa_rec, number_of_lms_strings, number_of_lms_strings, order+1, recursion+1, buffersize);
             memory_monitor::event("end   sa_simple");
             // SA' in first half, S' in second half
             text_rec.resize(number_of_lms_strings);
@@ -472,12 +660,19 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
         sdsl::remove(filename_lms_pos_b);
         select_support_mcl<> lms_select_support;                 // select_support for bit_vector
         util::init_support(lms_select_support, &lms_pos_b);  // Create select_support
-        // write left
+        // write left; the positions of a window are selected in parallel
         int_vector<> tmp_left(number_of_lms_strings, 0, int_width);
-        for (size_t i=number_of_lms_strings-1; i<number_of_lms_strings; --i) {
-            size_t idx = isa_rec[i];
-            size_t val = lms_select_support.select(i+1); //TODO test alternative without select support: look for 1 in lms_pos_b (backwards)
-            tmp_left[idx] = val;
+        int_vector<64> pos(sa_se_window);
+        for (size_t w=0; w<number_of_lms_strings; w+=sa_se_window) {
+            size_t cnt = std::min(number_of_lms_strings-w, sa_se_window);
+            _sa_se_parallel_for(0, cnt, threads, [&](uint64_t kb, uint64_t ke) {
+                for (size_t k=kb; k<ke; ++k) {
+                    pos[k] = lms_select_support.select(w+k+1); //TODO test alternative without select support: look for 1 in lms_pos_b (backwards)
+                }
+            });
+            for (size_t k=0; k<cnt; ++k) {
+                tmp_left[isa_rec[w+k]] = pos[k];
+            }
         }
         util::clear(lms_select_support);
         util::clear(lms_pos_b);
@@ -500,11 +695,23 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
             sdsl::remove(filename_lms_pos_b);
             select_support_mcl<> lms_select_support;                 // select_support for bit_vector
             util::init_support(lms_select_support, &lms_pos_b);      // create select_support
-            // write to left sa_rec buffered
+            // write to left sa_rec buffered; the positions of a window are selected in parallel
             int_vector_buffer<> sa_rec_buf(filename_sa_rec, std::ios::in, buffersize, nsize);
-            for (uint64_t i=0; i<sa_rec_buf.size(); ++i) {
-                uint64_t pos = lms_select_support.select(sa_rec_buf[i]+1);
-                left[number_of_lms_strings-1-left_pointer++] = pos;
+            sa_rec_buf.async_io(true);
+            int_vector<64> pos(sa_se_window);
+            for (uint64_t w=0; w<sa_rec_buf.size(); w+=sa_se_window) {
+                uint64_t cnt = std::min(sa_rec_buf.size()-w, sa_se_window);
+                for (uint64_t k=0; k<cnt; ++k) {
+                    pos[k] = sa_rec_buf[w+k];
+                }
+                _sa_se_parallel_for(0, cnt, threads, [&](uint64_t kb, uint64_t ke) {
+                    for (uint64_t k=kb; k<ke; ++k) {
+                        pos[k] = lms_select_support.select(pos[k]+1);
+                    }
+                });
+                for (uint64_t k=0; k<cnt; ++k) {
+                    left[number_of_lms_strings-1-left_pointer++] = pos[k];
+                }
             }
             sa_rec_buf.close(true);
             left_pointer--;
@@ -521,10 +728,12 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
     right.buffersize(buffersize);
     right_pointer = 0;
     int_vector_buffer<> cached_sa(filename_sa, std::ios::out, buffersize, nsize);
+    cached_sa.async_io(true);
     size_t sa_pointer = 0;
     {
         size_t partsize = bkt_l_sum/parts+1;
         int_vector<> array(partsize, 0, int_width);
+        _sa_se_preceding_symbols<int_vector_type> preceding(text, threads, true);
         std::vector< int_vector_buffer<> > cached_array(parts-1);
         for (size_t i=0; i<cached_array.size(); ++i) {
             cached_array[i] = int_vector_buffer<>(tmp_file(filename_sa, "_rightbuffer"+util::to_string(i)+"_"+util::to_string(recursion)), std::ios::out, buffersize, nsize);
@@ -542,13 +751,14 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
                         array[src-offset] = val;
                     }
                     cached_array[pos/partsize-1].reset();
+                    preceding.reset();
                 }
                 size_t idx = array[pos-offset];
+                size_t symbol = preceding(array, pos-offset, idx);
                 if (idx == 0) {
                     cached_sa[sa_pointer++] = idx;
                     right[right_pointer++] = idx;
                 } else {
-                    size_t symbol = text[idx-1];
                     cached_sa[sa_pointer++] = idx;
                     if (symbol >= c) {
                         size_t val = idx-1;
@@ -599,6 +809,7 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
         size_t partsize = bound_s/parts+1;
 
         int_vector<> array(partsize, 0, int_width);
+        _sa_se_preceding_symbols<int_vector_type> preceding(text, threads, false);
         std::vector< int_vector_buffer<> > cached_array(parts-1);
         for (size_t i=0; i<cached_array.size(); ++i) {
             cached_array[i] = int_vector_buffer<>(tmp_file(filename_sa, "_leftbuffer"+util::to_string(i)+"_"+util::to_string(recursion)), std::ios::out, buffersize, nsize);
@@ -620,16 +831,17 @@ void _construct_sa_se(int_vector_type& text, std::string filename_sa, uint64_t s
                     }
                     assert((offset/partsize) < parts-1);
                     cached_array[offset/partsize].reset();
+                    preceding.reset();
                 }
 
                 assert((pos-offset) < array.size());
                 size_t idx = array[pos-offset];
+                size_t symbol = preceding(array, pos-offset, idx);
                 if (idx==0) {
                     idx = n;
                 }
                 --idx;
                 assert((idx) < text.size());
-                size_t symbol = text[idx];
                 if (symbol <= c) {
                     if (idx==n-1) {
                         cached_sa[sa_pointer--] = 0;
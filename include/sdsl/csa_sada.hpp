@@ -28,6 +28,7 @@
 #include "util.hpp"
 #include "csa_sampling_strategy.hpp"
 #include "csa_alphabet_strategy.hpp"
+#include "query_stats.hpp"
 #include <iostream>
 #include <algorithm>
 #include <cassert>
@@ -116,8 +117,9 @@ class csa_sada
         sa_sample_type  m_sa_sample;  // suffix array samples
         isa_sample_type m_isa_sample; // inverse suffix array samples
         alphabet_type   m_alphabet;   // alphabet component
-
-        mutable std::vector<uint64_t> m_psi_buf; // buffer for decoded psi values
+#ifdef SDSL_QUERY_STATS
+        query_counters<csa_query_stats::COUNTERS> m_query_stats;
+#endif
 
         void copy(const csa_sada& csa)
         {
@@ -128,11 +130,12 @@ class csa_sada
             m_alphabet   = csa.m_alphabet;
         };
 
-        void create_buffer()
+        // Returns the buffer for the decoded psi values of the calling thread.
+        // A thread local buffer keeps rank_bwt const-correct and thread-safe.
+        static uint64_t* psi_buffer()
         {
-            if (enc_vector_type::sample_dens < linear_decode_limit) {
-                m_psi_buf = std::vector<uint64_t>(enc_vector_type::sample_dens+1);
-            }
+            static thread_local std::vector<uint64_t> buf(enc_vector_type::sample_dens+1);
+            return buf.data();
         }
 
     public:
@@ -152,17 +155,13 @@ class csa_sada
 
 
         //! Default Constructor
-        csa_sada()
-        {
-            create_buffer();
-        }
+        csa_sada() { }
         //! Default Destructor
         ~csa_sada() { }
 
         //! Copy constructor
         csa_sada(const csa_sada& csa)
         {
-            create_buffer();
             copy(csa);
         }
 
@@ -264,7 +263,6 @@ class csa_sada
                 m_sa_sample  = std::move(csa.m_sa_sample);
                 m_isa_sample = std::move(csa.m_isa_sample);
                 m_alphabet   = std::move(csa.m_alphabet);
-                m_psi_buf    = std::move(csa.m_psi_buf);
             }
             return *this;
         }
@@ -323,24 +321,24 @@ class csa_sada
 // TODO: don't use get_inter_sampled_values if t_dens is really
 //       large
                 lower_b = lower_sb*sd;
-                if (0 == m_psi_buf.size()) {
+                if (enc_vector_type::sample_dens >= linear_decode_limit) {
                     upper_b = std::min(upper_sb*sd, C[cc+1]);
                     goto finish;
                 }
-                uint64_t* p = m_psi_buf.data();
+                uint64_t* psi_buf = psi_buffer();
+                uint64_t* p = psi_buf;
                 // extract the psi values between two samples
                 m_psi.get_inter_sampled_values(lower_sb, p);
-                p = m_psi_buf.data();
                 uint64_t smpl = m_psi.sample(lower_sb);
                 // handle border cases
                 if (lower_b + m_psi.get_sample_dens() >= C[cc+1])
-                    m_psi_buf[ C[cc+1]-lower_b ] = size()-smpl;
+                    psi_buf[ C[cc+1]-lower_b ] = size()-smpl;
                 else
-                    m_psi_buf[ m_psi.get_sample_dens() ] = size()-smpl;
+                    psi_buf[ m_psi.get_sample_dens() ] = size()-smpl;
                 // search the result linear
                 while ((*p++)+smpl < i);
 
-                return p-1-m_psi_buf.data() + lower_b - C[cc];
+                return p-1-psi_buf + lower_b - C[cc];
             } else { // lower_b == (m_C[cc]+sd-1)/sd and lower_sb < upper_sb
                 if (m_psi.sample(lower_sb) >= i) {
                     lower_b = C[cc];
@@ -389,12 +387,19 @@ finish:
         }
 };
 
+//! The samples of a csa_sada are calculated by traversing it, if the sampling strategies allow it.
+template<class t_enc_vec, uint32_t t_dens, uint32_t t_inv_dens, class t_sa_sample_strat, class t_isa, class t_alphabet_strat>
+struct csa_without_sa<csa_sada<t_enc_vec, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabet_strat>> {
+    typedef csa_sada<t_enc_vec, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabet_strat> csa_type;
+    static const bool value = sampling_without_sa<typename csa_type::sa_sample_type>::value and
+                              sampling_without_sa<typename csa_type::isa_sample_type>::value;
+};
+
 // == template functions ==
 
 template<class t_enc_vec, uint32_t t_dens, uint32_t t_inv_dens, class t_sa_sample_strat, class t_isa, class t_alphabet_strat>
 csa_sada<t_enc_vec, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabet_strat>::csa_sada(cache_config& config)
 {
-    create_buffer();
     if (!cache_file_exists(key_trait<alphabet_type::int_width>::KEY_BWT, config)) {
         return;
     }
@@ -431,13 +436,11 @@ csa_sada<t_enc_vec, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabet_str
     }
     {
         auto event = memory_monitor::event("sample SA");
-        sa_sample_type tmp_sa_sample(config);
-        m_sa_sample.swap(tmp_sa_sample);
+        construct_sa_sampling(m_sa_sample, config, this);
     }
     {
         auto event = memory_monitor::event("sample ISA");
-        isa_sample_type isa_s(config, &m_sa_sample);
-        util::swap_support(m_isa_sample, isa_s, &m_sa_sample, (const sa_sample_type*)nullptr);
+        construct_isa_sampling(m_isa_sample, config, &m_sa_sample, this);
     }
 }
 
@@ -449,6 +452,9 @@ inline auto csa_sada<t_enc_vec, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_
         i = psi[i];                       // go to the position where SA[i]+1 is located
         ++off;                            // add 1 to the offset
     }
+    SDSL_QUERY_COUNT(m_query_stats, csa_query_stats::SA_ACCESS);
+    SDSL_QUERY_COUNT_N(m_query_stats, csa_query_stats::STEPS, off);
+    SDSL_QUERY_COUNT_N(m_query_stats, csa_query_stats::SA_SAMPLE_HITS, off == 0);
     value_type result = m_sa_sample[i];
     if (result < off) {
         return m_psi.size()-(off-result);
@@ -466,6 +472,7 @@ auto csa_sada<t_enc_vec, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabe
     written_bytes += m_sa_sample.serialize(out, child, "sa_samples");
     written_bytes += m_isa_sample.serialize(out, child, "isa_samples");
     written_bytes += m_alphabet.serialize(out, child, "alphabet");
+    SDSL_QUERY_STATS_ONLY(m_query_stats.add_to(child, csa_query_stats::name);)
     structure_tree::add_size(child, written_bytes);
     return written_bytes;
 }
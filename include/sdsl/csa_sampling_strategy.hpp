@@ -61,6 +61,39 @@
 namespace sdsl
 {
 
+//! Calls f(i, SA[i]) for all suffix array positions i by following the LF function.
+/*! Only the parts of the CSA which are needed for LF have to be initialized.
+ *  The text has to be terminated by a unique smallest symbol.
+ */
+template<class t_csa, class t_f>
+void _enumerate_sa(const t_csa& csa, t_f f, lf_tag)
+{
+    typedef typename t_csa::size_type size_type;
+    size_type n = csa.size();
+    for (size_type i=0, j=n; j > 0; --j) { // SA[0]=n-1
+        f(i, j-1);
+        i = csa.lf[i];
+    }
+}
+
+//! Calls f(i, SA[i]) for all suffix array positions i by following the \f$\Psi\f$ function.
+/*! Only the parts of the CSA which are needed for \f$\Psi\f$ have to be initialized.
+ *  The text has to be terminated by a unique smallest symbol.
+ */
+template<class t_csa, class t_f>
+void _enumerate_sa(const t_csa& csa, t_f f, psi_tag)
+{
+    typedef typename t_csa::size_type size_type;
+    size_type n = csa.size();
+    if (n == 0) {
+        return;
+    }
+    for (size_type i=csa.psi[0], j=0; j < n; ++j) { // psi[0]=ISA[0]
+        f(i, j);
+        i = csa.psi[i];
+    }
+}
+
 template<class t_csa, uint8_t t_width=0>
 class _sa_order_sampling : public int_vector<t_width>
 {
@@ -78,13 +111,26 @@ class _sa_order_sampling : public int_vector<t_width>
         //! Constructor
         /*
          * \param cconfig Cache configuration (SA is expected to be cached.).
-         * \param csa     Pointer to the corresponding CSA. Not used in this class.
+         * \param csa     Pointer to the corresponding CSA. Only used if the SA is not
+         *                cached, the samples are then calculated by traversing the CSA.
          * \par Time complexity
          *      Linear in the size of the suffix array.
          */
-        _sa_order_sampling(const cache_config& cconfig, SDSL_UNUSED const t_csa* csa=nullptr)
+        _sa_order_sampling(const cache_config& cconfig, const t_csa* csa=nullptr)
         {
+            if (nullptr != csa and !cache_file_exists(conf::KEY_SA, cconfig)) {
+                size_type n = csa->size();
+                this->width(bits::hi(n)+1);
+                this->resize((n+sample_dens-1)/sample_dens);
+                _enumerate_sa(*csa, [this](size_type i, size_type sa) {
+                    if (0 == (i % sample_dens)) {
+                        base_type::operator[](i/sample_dens) = sa;
+                    }
+                }, typename t_csa::extract_category());
+                return;
+            }
             int_vector_buffer<>  sa_buf(cache_file_name(conf::KEY_SA, cconfig));
+            sa_buf.async_io(true);
             size_type n = sa_buf.size();
             this->width(bits::hi(n)+1);
             this->resize((n+sample_dens-1)/sample_dens);
@@ -147,13 +193,35 @@ class _text_order_sampling : public int_vector<t_width>
         //! Constructor
         /*
          * \param cconfig Cache configuration (SA is expected to be cached.).
-         * \param csa    Pointer to the corresponding CSA. Not used in this class.
+         * \param csa    Pointer to the corresponding CSA. Only used if the SA is not
+         *               cached, the samples are then calculated by traversing the CSA.
          * \par Time complexity
          *      Linear in the size of the suffix array.
          */
-        _text_order_sampling(const cache_config& cconfig, SDSL_UNUSED const t_csa* csa=nullptr)
+        _text_order_sampling(const cache_config& cconfig, const t_csa* csa=nullptr)
         {
+            if (nullptr != csa and !cache_file_exists(conf::KEY_SA, cconfig)) {
+                size_type n = csa->size();
+                bit_vector marked(n, 0);
+                this->width(bits::hi(n/sample_dens)+1);
+                this->resize((n+sample_dens-1)/sample_dens);
+                // positions of the samples in text order
+                int_vector<> pos(this->size(), 0, bits::hi(n)+1);
+                _enumerate_sa(*csa, [&](size_type i, size_type sa) {
+                    if (0 == (sa % sample_dens)) {
+                        marked[i] = 1;
+                        pos[sa / sample_dens] = i;
+                    }
+                }, typename t_csa::extract_category());
+                m_marked = std::move(t_bv(marked));
+                util::init_support(m_rank_marked, &m_marked);
+                for (size_type j=0; j < pos.size(); ++j) {
+                    base_type::operator[](m_rank_marked(pos[j])) = j;
+                }
+                return;
+            }
             int_vector_buffer<>  sa_buf(cache_file_name(conf::KEY_SA, cconfig));
+            sa_buf.async_io(true);
             size_type n = sa_buf.size();
             bit_vector marked(n, 0);                // temporary bitvector for the marked text positions
             this->width(bits::hi(n/sample_dens)+1);
@@ -496,8 +564,10 @@ class _bwt_sampling : public int_vector<t_width>
         _bwt_sampling(const cache_config& cconfig, SDSL_UNUSED const t_csa* csa=nullptr)
         {
             int_vector_buffer<>  sa_buf(cache_file_name(conf::KEY_SA, cconfig));
+            sa_buf.async_io(true);
             int_vector_buffer<t_csa::alphabet_type::int_width>
             bwt_buf(cache_file_name(key_trait<t_csa::alphabet_type::int_width>::KEY_BWT,cconfig));
+            bwt_buf.async_io(true);
             size_type n = sa_buf.size();
             bit_vector marked(n, 0);                // temporary bitvector for the marked text positions
             this->width(bits::hi(n)+1);
@@ -620,12 +690,29 @@ class _isa_sampling : public int_vector<t_width>
         /*
          * \param cconfig   Cache configuration (SA is expected to be cached.).
          * \param sa_sample Pointer to the corresponding SA sampling. Not used in this class.
+         * \param csa       Pointer to the corresponding CSA. Only used if the SA is not
+         *                  cached, the samples are then calculated by traversing the CSA.
          * \par Time complexity
          *      Linear in the size of the suffix array.
          */
-        _isa_sampling(const cache_config& cconfig, SDSL_UNUSED const sa_type* sa_sample=nullptr)
+        _isa_sampling(const cache_config& cconfig, SDSL_UNUSED const sa_type* sa_sample=nullptr,
+                      const t_csa* csa=nullptr)
         {
+            if (nullptr != csa and !cache_file_exists(conf::KEY_SA, cconfig)) {
+                size_type n = csa->size();
+                if (n >= 1) {
+                    this->width(bits::hi(n)+1);
+                    this->resize((n-1)/sample_dens+1);
+                }
+                _enumerate_sa(*csa, [this](size_type i, size_type sa) {
+                    if (0 == (sa % sample_dens)) {
+                        base_type::operator[](sa/sample_dens) = i;
+                    }
+                }, typename t_csa::extract_category());
+                return;
+            }
             int_vector_buffer<>  sa_buf(cache_file_name(conf::KEY_SA, cconfig));
+            sa_buf.async_io(true);
             size_type n = sa_buf.size();
             if (n >= 1) { // so n+t_csa::isa_sample_dens >= 2
                 this->width(bits::hi(n)+1);
@@ -706,11 +793,13 @@ class _text_order_isa_sampling_support
         /*
          * \param cconfig   Cache configuration. (Not used in this class)
          * \param sa_sample Pointer to the corresponding SA sampling..
+         * \param csa       Pointer to the corresponding CSA. Not used in this class.
          * \par Time complexity
          *      Linear in the size of the suffix array.
          */
         _text_order_isa_sampling_support(SDSL_UNUSED const cache_config& cconfig,
-                                         const typename std::enable_if<sa_type::text_order, sa_type*>::type sa_sample)
+                                         const typename std::enable_if<sa_type::text_order, sa_type*>::type sa_sample,
+                                         SDSL_UNUSED const t_csa* csa=nullptr)
         {
             // and initialize the select support on bitvector marked
             m_select_marked = t_sel(&(sa_sample->marked));
@@ -834,11 +923,13 @@ class _fuzzy_isa_sampling_support
         /*
          * \param cconfig   Cache configuration. (Not used in this class)
          * \param sa_sample Pointer to the corresponding SA sampling..
+         * \param csa       Pointer to the corresponding CSA. Not used in this class.
          * \par Time complexity
          *      Linear in the size of the suffix array.
          */
         _fuzzy_isa_sampling_support(SDSL_UNUSED const cache_config& cconfig,
-                                    const sa_type* sa_sample) :
+                                    const sa_type* sa_sample,
+                                    SDSL_UNUSED const t_csa* csa=nullptr) :
             m_sa_p(sa_sample)
         {
             util::init_support(m_select_marked_sa,  &(sa_sample->marked_sa));
@@ -947,6 +1038,89 @@ struct fuzzy_isa_sampling_support {
     using sampling_category = isa_sampling_tag;
 };
 
+//! Indicates if a sampling strategy can be constructed without a cached SA.
+/*! These strategies traverse the CSA (LF or \f$\Psi\f$) instead of reading the SA.
+ */
+template<class t_sampling>
+struct sampling_without_sa {
+    static const bool value = false;
+};
+
+template<class t_csa, uint8_t t_width>
+struct sampling_without_sa<_sa_order_sampling<t_csa, t_width>> {
+    static const bool value = true;
+};
+
+template<class t_csa, class t_bv, class t_rank, uint8_t t_width>
+struct sampling_without_sa<_text_order_sampling<t_csa, t_bv, t_rank, t_width>> {
+    static const bool value = true;
+};
+
+template<class t_csa, uint8_t t_width>
+struct sampling_without_sa<_isa_sampling<t_csa, t_width>> {
+    static const bool value = true;
+};
+
+template<class t_csa, class t_inv_perm, class t_sel>
+struct sampling_without_sa<_text_order_isa_sampling_support<t_csa, t_inv_perm, t_sel>> {
+    static const bool value = true;
+};
+
+template<class t_sa_sample, class t_csa>
+void _construct_sa_sampling(t_sa_sample& sa_sample, cache_config& config, const t_csa* csa, std::true_type)
+{
+    t_sa_sample tmp_sa_sample(config, csa);
+    sa_sample.swap(tmp_sa_sample);
+}
+
+template<class t_sa_sample, class t_csa>
+void _construct_sa_sampling(t_sa_sample& sa_sample, cache_config& config, SDSL_UNUSED const t_csa* csa, std::false_type)
+{
+    t_sa_sample tmp_sa_sample(config);
+    sa_sample.swap(tmp_sa_sample);
+}
+
+//! Constructs the SA sampling of a CSA.
+/*! The CSA is only passed to strategies which can be constructed without a
+ *  cached SA, so user defined strategies only need the constructor
+ *  `t_sa_sample(cache_config&)`.
+ */
+template<class t_sa_sample, class t_csa>
+void construct_sa_sampling(t_sa_sample& sa_sample, cache_config& config, const t_csa* csa)
+{
+    _construct_sa_sampling(sa_sample, config, csa,
+                           std::integral_constant<bool, sampling_without_sa<t_sa_sample>::value>());
+}
+
+template<class t_isa_sample, class t_sa_sample, class t_csa>
+void _construct_isa_sampling(t_isa_sample& isa_sample, cache_config& config,
+                             t_sa_sample* sa_sample, const t_csa* csa, std::true_type)
+{
+    t_isa_sample isa_s(config, sa_sample, csa);
+    util::swap_support(isa_sample, isa_s, sa_sample, (const t_sa_sample*)nullptr);
+}
+
+template<class t_isa_sample, class t_sa_sample, class t_csa>
+void _construct_isa_sampling(t_isa_sample& isa_sample, cache_config& config,
+                             t_sa_sample* sa_sample, SDSL_UNUSED const t_csa* csa, std::false_type)
+{
+    t_isa_sample isa_s(config, sa_sample);
+    util::swap_support(isa_sample, isa_s, sa_sample, (const t_sa_sample*)nullptr);
+}
+
+//! Constructs the ISA sampling of a CSA and sets it to the SA sampling.
+/*! The CSA is only passed to strategies which can be constructed without a
+ *  cached SA, so user defined strategies only need the constructor
+ *  `t_isa_sample(cache_config&, t_sa_sample*)`.
+ */
+template<class t_isa_sample, class t_sa_sample, class t_csa>
+void construct_isa_sampling(t_isa_sample& isa_sample, cache_config& config,
+                            t_sa_sample* sa_sample, const t_csa* csa)
+{
+    _construct_isa_sampling(isa_sample, config, sa_sample, csa,
+                            std::integral_constant<bool, sampling_without_sa<t_isa_sample>::value>());
+}
+
 } // end namespace
 
 #endif
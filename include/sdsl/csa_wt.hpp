@@ -26,6 +26,7 @@
 #include "iterators.hpp"
 #include "util.hpp"
 #include "fast_cache.hpp"
+#include "query_stats.hpp"
 #include "csa_sampling_strategy.hpp"
 #include "csa_alphabet_strategy.hpp"
 #include <iostream>
@@ -123,7 +124,10 @@ class csa_wt
         alphabet_type   m_alphabet;
 //#define USE_CSA_CACHE
 #ifdef USE_CSA_CACHE
-        mutable fast_cache csa_cache;
+        fast_cache csa_cache; // thread local, see fast_cache
+#endif
+#ifdef SDSL_QUERY_STATS
+        query_counters<csa_query_stats::COUNTERS> m_query_stats;
 #endif
 
         void copy(const csa_wt& csa)
@@ -259,6 +263,18 @@ class csa_wt
          */
         void load(std::istream& in);
 
+        //! Number of members which can be loaded separately (see serialized_members).
+        static const size_type member_count = 4;
+
+        //! Serialize the i-th member to a stream.
+        size_type serialize_member(size_type i, std::ostream& out, structure_tree_node* v)const;
+
+        //! Load the i-th member from a stream.
+        void load_member(size_type i, std::istream& in);
+
+        //! Set the pointers between the members after load_member.
+        void load_members_finish();
+
     private:
 
         // Calculates how many symbols c are in the prefix [0..i-1] of the BWT of the original text.
@@ -296,6 +312,14 @@ class csa_wt
         }
 };
 
+//! The samples of a csa_wt are calculated by traversing it, if the sampling strategies allow it.
+template<class t_wt, uint32_t t_dens, uint32_t t_inv_dens, class t_sa_sample_strat, class t_isa, class t_alphabet_strat>
+struct csa_without_sa<csa_wt<t_wt, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabet_strat>> {
+    typedef csa_wt<t_wt, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabet_strat> csa_type;
+    static const bool value = sampling_without_sa<typename csa_type::sa_sample_type>::value and
+                              sampling_without_sa<typename csa_type::isa_sample_type>::value;
+};
+
 // == template functions ==
 
 template<class t_wt, uint32_t t_dens, uint32_t t_inv_dens, class t_sa_sample_strat, class t_isa, class t_alphabet_strat>
@@ -320,13 +344,11 @@ csa_wt<t_wt, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabet_strat>::cs
     }
     {
         auto event = memory_monitor::event("sample SA");
-        sa_sample_type tmp_sa_sample(config);
-        m_sa_sample.swap(tmp_sa_sample);
+        construct_sa_sampling(m_sa_sample, config, this);
     }
     {
         auto event = memory_monitor::event("sample ISA");
-        isa_sample_type isa_s(config, &m_sa_sample);
-        util::swap_support(m_isa_sample, isa_s, &m_sa_sample, &m_sa_sample);
+        construct_isa_sampling(m_isa_sample, config, &m_sa_sample, this);
     }
 }
 
@@ -339,6 +361,9 @@ inline auto csa_wt<t_wt, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabe
         i = lf[i];
         ++off;
     }
+    SDSL_QUERY_COUNT(m_query_stats, csa_query_stats::SA_ACCESS);
+    SDSL_QUERY_COUNT_N(m_query_stats, csa_query_stats::STEPS, off);
+    SDSL_QUERY_COUNT_N(m_query_stats, csa_query_stats::SA_SAMPLE_HITS, off == 0);
     value_type result = m_sa_sample[i];
     if (result + off < size()) {
         return result + off;
@@ -375,10 +400,10 @@ auto csa_wt<t_wt, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabet_strat
 {
     structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
     size_type written_bytes = 0;
-    written_bytes += m_wavelet_tree.serialize(out, child, "wavelet_tree");
-    written_bytes += m_sa_sample.serialize(out, child, "sa_samples");
-    written_bytes += m_isa_sample.serialize(out, child, "isa_samples");
-    written_bytes += m_alphabet.serialize(out, child, "alphabet");
+    for (size_type i=0; i < member_count; ++i) {
+        written_bytes += serialize_member(i, out, child);
+    }
+    SDSL_QUERY_STATS_ONLY(m_query_stats.add_to(child, csa_query_stats::name);)
     structure_tree::add_size(child, written_bytes);
     return written_bytes;
 }
@@ -386,10 +411,38 @@ auto csa_wt<t_wt, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabet_strat
 template<class t_wt, uint32_t t_dens, uint32_t t_inv_dens, class t_sa_sample_strat, class t_isa, class t_alphabet_strat>
 void csa_wt<t_wt, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabet_strat>::load(std::istream& in)
 {
-    m_wavelet_tree.load(in);
-    m_sa_sample.load(in);
-    m_isa_sample.load(in, &m_sa_sample);
-    m_alphabet.load(in);
+    for (size_type i=0; i < member_count; ++i) {
+        load_member(i, in);
+    }
+    load_members_finish();
+}
+
+template<class t_wt, uint32_t t_dens, uint32_t t_inv_dens, class t_sa_sample_strat, class t_isa, class t_alphabet_strat>
+auto csa_wt<t_wt, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabet_strat>::serialize_member(size_type i, std::ostream& out, structure_tree_node* v)const -> size_type
+{
+    switch (i) {
+        case 0: return m_wavelet_tree.serialize(out, v, "wavelet_tree");
+        case 1: return m_sa_sample.serialize(out, v, "sa_samples");
+        case 2: return m_isa_sample.serialize(out, v, "isa_samples");
+        default: return m_alphabet.serialize(out, v, "alphabet");
+    }
+}
+
+template<class t_wt, uint32_t t_dens, uint32_t t_inv_dens, class t_sa_sample_strat, class t_isa, class t_alphabet_strat>
+void csa_wt<t_wt, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabet_strat>::load_member(size_type i, std::istream& in)
+{
+    switch (i) {
+        case 0: m_wavelet_tree.load(in); break;
+        case 1: m_sa_sample.load(in); break;
+        case 2: m_isa_sample.load(in); break;
+        default: m_alphabet.load(in);
+    }
+}
+
+template<class t_wt, uint32_t t_dens, uint32_t t_inv_dens, class t_sa_sample_strat, class t_isa, class t_alphabet_strat>
+void csa_wt<t_wt, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabet_strat>::load_members_finish()
+{
+    m_isa_sample.set_vector(&m_sa_sample);
 }
 
 template<class t_wt, uint32_t t_dens, uint32_t t_inv_dens, class t_sa_sample_strat, class t_isa, class t_alphabet_strat>
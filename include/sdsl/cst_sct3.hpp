@@ -486,6 +486,21 @@ class cst_sct3
          */
         void load(std::istream& in);
 
+        //! Number of members which can be loaded separately (see serialized_members).
+        /*! The members of the CSA are followed by the LCP array, the balanced
+         *  parentheses with their support and the first child marks.
+         */
+        static const size_type member_count = serialized_members<csa_type>::count + 3;
+
+        //! Serialize the i-th member to a stream.
+        size_type serialize_member(size_type i, std::ostream& out, structure_tree_node* v)const;
+
+        //! Load the i-th member from a stream.
+        void load_member(size_type i, std::istream& in);
+
+        //! Set the pointers between the members after load_member.
+        void load_members_finish();
+
         /*! \defgroup cst_sct3_tree_methods Tree methods of cst_sct3 */
         /* @{ */
 
@@ -1202,6 +1217,53 @@ void cst_sct3<t_csa, t_lcp, t_bp_support, t_bv, t_rank, t_sel>::load(std::istrea
     read_member(m_nodes, in);
 }
 
+template<class t_csa, class t_lcp, class t_bp_support, class t_bv, class t_rank, class t_sel>
+auto cst_sct3<t_csa, t_lcp, t_bp_support, t_bv, t_rank, t_sel>::serialize_member(size_type i, std::ostream& out, structure_tree_node* v)const -> size_type
+{
+    const size_type csa_members = serialized_members<csa_type>::count;
+    if (i < csa_members) {
+        return serialized_members<csa_type>::serialize(m_csa, i, out, v);
+    }
+    size_type written_bytes = 0;
+    if (i == csa_members) {
+        written_bytes += m_lcp.serialize(out, v, "lcp");
+    } else if (i == csa_members+1) {
+        written_bytes += m_bp.serialize(out, v, "bp");
+        written_bytes += m_bp_support.serialize(out, v, "bp_support");
+    } else {
+        written_bytes += m_first_child.serialize(out, v, "mark_child");
+        written_bytes += m_first_child_rank.serialize(out, v, "mark_child_rank");
+        written_bytes += m_first_child_select.serialize(out, v, "mark_child_select");
+        written_bytes += write_member(m_nodes, out, v, "node_cnt");
+    }
+    return written_bytes;
+}
+
+template<class t_csa, class t_lcp, class t_bp_support, class t_bv, class t_rank, class t_sel>
+void cst_sct3<t_csa, t_lcp, t_bp_support, t_bv, t_rank, t_sel>::load_member(size_type i, std::istream& in)
+{
+    const size_type csa_members = serialized_members<csa_type>::count;
+    if (i < csa_members) {
+        serialized_members<csa_type>::load(m_csa, i, in);
+    } else if (i == csa_members) {
+        load_lcp(m_lcp, in, *this);
+    } else if (i == csa_members+1) {
+        m_bp.load(in);
+        m_bp_support.load(in, &m_bp);
+    } else {
+        m_first_child.load(in);
+        m_first_child_rank.load(in,&m_first_child);
+        m_first_child_select.load(in,&m_first_child);
+        read_member(m_nodes, in);
+    }
+}
+
+template<class t_csa, class t_lcp, class t_bp_support, class t_bv, class t_rank, class t_sel>
+void cst_sct3<t_csa, t_lcp, t_bp_support, t_bv, t_rank, t_sel>::load_members_finish()
+{
+    serialized_members<csa_type>::finish(m_csa);
+}
+
 template<class t_csa, class t_lcp, class t_bp_support, class t_bv, class t_rank, class t_sel>
 cst_sct3<t_csa, t_lcp, t_bp_support, t_bv, t_rank, t_sel>& cst_sct3<t_csa, t_lcp, t_bp_support, t_bv, t_rank, t_sel>::operator=(const cst_sct3& cst)
 {
@@ -3,35 +3,109 @@
 #define INCLUDED_SDSL_FAST_CACHE
 
 #include "int_vector.hpp"
+#include <atomic>
+#include <memory>
 
 namespace sdsl
 {
 
 #define CACHE_SIZE 0x3FFULL
 
-struct fast_cache {
-    typedef int_vector<>::size_type size_type;
-    size_type m_table[2*(CACHE_SIZE+1)];
-    // Constructor
-    fast_cache() {
-        for (size_type i=0; i < (CACHE_SIZE+1); ++i) {
-            m_table[i<<1] = (size_type)-1;
+//! A direct mapped cache for the answers of queries.
+/*! The table of a cache is thread local: each thread which queries a
+ *  structure gets its own table, so a const structure can be shared
+ *  between threads without locking. A thread keeps the tables of the
+ *  conf::SDSL_FAST_CACHE_TABLES most recently used caches.
+ */
+class fast_cache
+{
+    public:
+        typedef int_vector<>::size_type size_type;
+    private:
+        struct table {
+            uint64_t  owner = 0; // id of the cache, 0 for an unused table
+            uint64_t  used  = 0; // time of the last lookup
+            size_type m_table[2*(CACHE_SIZE+1)];
+        };
+
+        struct thread_tables {
+            std::unique_ptr<table[]> tables;
+            table*                   last  = nullptr;
+            uint64_t                 clock = 0;
+        };
+
+        uint64_t m_id; // unique id; is never reused
+
+        static uint64_t next_id()
+        {
+            static std::atomic<uint64_t> id(0);
+            return ++id;
+        }
+
+        // Returns the table of the calling thread for this cache
+        table& local_table()const
+        {
+            static thread_local thread_tables tt;
+            if (tt.last != nullptr and tt.last->owner == m_id) {
+                return *tt.last;
+            }
+            if (!tt.tables) {
+                tt.tables.reset(new table[conf::SDSL_FAST_CACHE_TABLES]);
+            }
+            table* t = tt.tables.get();
+            for (size_type i=0; i < conf::SDSL_FAST_CACHE_TABLES; ++i) {
+                if (tt.tables[i].owner == m_id) {
+                    t = &tt.tables[i];
+                    break;
+                }
+                if (tt.tables[i].used < t->used) {
+                    t = &tt.tables[i];
+                }
+            }
+            if (t->owner != m_id) { // take over the least recently used table
+                t->owner = m_id;
+                for (size_type i=0; i < (CACHE_SIZE+1); ++i) {
+                    t->m_table[i<<1] = (size_type)-1;
+                }
+            }
+            t->used = ++tt.clock;
+            tt.last = t;
+            return *t;
+        }
+
+    public:
+        // Constructor
+        fast_cache() : m_id(next_id()) {}
+        // A copy is a new cache
+        fast_cache(const fast_cache&) : m_id(next_id()) {}
+        fast_cache& operator=(const fast_cache&)
+        {
+            clear();
+            return *this;
+        }
+        // Invalidates the cached answers of all threads
+        void clear()
+        {
+            m_id = next_id();
+        }
+        // Returns true if the request i is cached and
+        // x is set to the answer of request i
+        bool exists(size_type i, size_type& x)const
+        {
+            const size_type* m_table = local_table().m_table;
+            if (m_table[(i&CACHE_SIZE)<<1 ] == i) {
+                x = m_table[((i&CACHE_SIZE)<<1) + 1 ];
+                return true;
+            } else
+                return false;
+        }
+        // Writes the answer for request i to the cache
+        void write(size_type i, size_type x)const
+        {
+            size_type* m_table = local_table().m_table;
+            m_table[(i&CACHE_SIZE)<<1 ] = i;
+            m_table[((i&CACHE_SIZE)<<1) + 1 ] = x;
         }
-    }
-    // Returns true if the request i is cached and
-    // x is set to the answer of request i
-    bool exists(size_type i, size_type& x) {
-        if (m_table[(i&CACHE_SIZE)<<1 ] == i) {
-            x = m_table[((i&CACHE_SIZE)<<1) + 1 ];
-            return true;
-        } else
-            return false;
-    }
-    // Writes the answer for request i to the cache
-    void write(size_type i, size_type x) {
-        m_table[(i&CACHE_SIZE)<<1 ] = i;
-        m_table[((i&CACHE_SIZE)<<1) + 1 ] = x;
-    }
 };
 
 } // end namespace sdsl
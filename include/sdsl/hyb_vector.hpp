@@ -26,7 +26,6 @@
  *     - replace std::vectors by int_vectors
  *     - add support for rank0
  *     - added naive implementation of method get_int
- *     - TODO: added a naive implementation of select
 */
 #ifndef INCLUDED_SDSL_HYB_VECTOR
 #define INCLUDED_SDSL_HYB_VECTOR
@@ -36,6 +35,7 @@
 #include "iterators.hpp"
 #include "io.hpp"
 #include <cstdlib>
+#include <cstring>
 #include <vector>
 #include <algorithm>
 #include <iostream>
@@ -503,6 +503,70 @@ class hyb_vector
             }
         }
 
+        //! Number of ones before superblock sblock_id.
+        size_type sblock_rank(size_type sblock_id) const
+        {
+            const uint8_t* header_ptr8 = ((const uint8_t*)m_sblock_header.data()) + (sblock_id * k_sblock_header_size);
+            return m_hblock_header[2 * ((sblock_id * k_sblock_rate) / k_hblock_rate) + 1] + *((const uint32_t*)header_ptr8 + 1);
+        }
+
+        //! Returns the header of block block_id and sets trunk_ptr to the start of its encoding.
+        uint16_t block_header(size_type block_id, size_type& trunk_ptr) const
+        {
+            size_type sblock_id = block_id / k_sblock_rate;
+            const uint8_t* header_ptr8 = ((const uint8_t*)m_sblock_header.data()) + (sblock_id * k_sblock_header_size);
+            trunk_ptr = m_hblock_header[2 * (block_id / k_hblock_rate)] + ((*(const uint32_t*)header_ptr8) & 0x3fffffff);
+            const uint16_t* header_ptr16 = (const uint16_t*)(header_ptr8 + 8);
+            for (size_type j = sblock_id * k_sblock_rate; j != block_id; ++j) {
+                trunk_ptr += ((*header_ptr16++) >> 10);
+            }
+            return *header_ptr16;
+        }
+
+        //! Sets the bits [beg..end-1] of the 256-bit block w.
+        static void set_bits(uint64_t* w, uint32_t beg, uint32_t end)
+        {
+            for (; beg < end; beg = (beg | 63) + 1) {
+                uint32_t e = std::min(end, (beg | 63) + 1);
+                w[beg >> 6] |= bits::lo_set[e - (beg & ~63U)] & bits::lo_unset[beg & 63];
+            }
+        }
+
+        //! Decodes the block with header header, whose encoding starts at trunk_ptr, into w[0..3].
+        void decode_block(uint16_t header, size_type trunk_ptr, uint64_t* w) const
+        {
+            uint32_t encoding_size = (header >> 10);
+            uint32_t ones = (header & 0x1ff);
+            uint32_t special_bit = ((header & 0x200) >> 9);
+            const uint8_t* trunk_p = ((const uint8_t*)m_trunk.data()) + trunk_ptr;
+
+            if (encoding_size >= k_block_bytes) { // plain encoding
+                std::memcpy(w, trunk_p, k_block_bytes);
+                return;
+            }
+            w[0] = w[1] = w[2] = w[3] = 0;
+            if (!encoding_size) { // number of runs <= 2
+                if (special_bit) set_bits(w, 0, ones);
+                else set_bits(w, k_block_size - ones, k_block_size);
+            } else if (std::min(ones, k_block_size - ones) == encoding_size) { // minority encoding
+                if (!special_bit) set_bits(w, 0, k_block_size);
+                for (uint32_t j = 0; j < encoding_size; ++j) {
+                    w[trunk_p[j] >> 6] ^= 1ULL << (trunk_p[j] & 63);
+                }
+            } else { // runs encoding; the last two runs are implied by the number of ones
+                uint32_t beg = 0, placed = 0, bit = special_bit;
+                for (uint32_t j = 0; j < encoding_size; ++j, bit ^= 1) {
+                    if (bit) {
+                        set_bits(w, beg, trunk_p[j] + 1);
+                        placed += trunk_p[j] + 1 - beg;
+                    }
+                    beg = trunk_p[j] + 1;
+                }
+                if (bit) set_bits(w, beg, beg + ones - placed);
+                else set_bits(w, k_block_size - (ones - placed), k_block_size);
+            }
+        }
+
     public:
         //! Swap method
         void swap(hyb_vector& hybrid)
@@ -522,15 +586,29 @@ class hyb_vector
          *
          *  \pre idx+len-1 in [0..size()-1]
          *  \pre len in [1..64]
+         *  \par Time complexity
+         *       Decodes the (at most two) blocks which contain the bits.
+         *       Reading the bitvector sequentially with get_int(i, 64) is
+         *       therefore about as fast as decoding it block by block.
          */
         uint64_t get_int(size_type idx, const uint8_t len=64) const
         {
-            uint64_t res = 0;
-            for (size_t i=0; i<len; ++i) {
-                res <<= 1;
-                res |= (*this)[idx+len-1-i];
+            assert(idx + len - 1 < m_size);
+            uint64_t w[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+            size_type block_id = idx / k_block_size;
+            size_type trunk_ptr = 0;
+            uint32_t offset = idx - block_id * k_block_size;
+            uint16_t header = block_header(block_id, trunk_ptr);
+            decode_block(header, trunk_ptr, w);
+            if (offset + len > k_block_size) {
+                header = block_header(block_id + 1, trunk_ptr);
+                decode_block(header, trunk_ptr, w + 4);
             }
-            return res;
+            uint64_t res = w[offset >> 6] >> (offset & 63);
+            if ((offset & 63) + len > 64) {
+                res |= w[(offset >> 6) + 1] << (64 - (offset & 63));
+            }
+            return res & bits::lo_set[len];
         }
 
         //! Accessing the i-th element of the original bitvector
@@ -765,11 +843,7 @@ class rank_support_hyb
             } else {
                 // plain encoding.
                 uint64_t* trunk_ptr64 = (uint64_t*)(((uint8_t*)m_v->m_trunk.data()) + trunk_ptr);
-                uint32_t bit;
-                for (bit = 0; bit + 64 <= local_i; bit += 64)
-                    block_rank += bits::cnt(*trunk_ptr64++);
-                if (bit != local_i)
-                    block_rank += bits::cnt((*trunk_ptr64) & (((uint64_t)1 << (local_i - bit)) - 1));
+                block_rank += bits::cnt_prefix(trunk_ptr64, local_i);
 
                 return rank_result<t_b>::adapt(hblock_rank + sblock_rank + block_rank, i);
             }
@@ -781,6 +855,14 @@ class rank_support_hyb
             return rank(i);
         }
 
+        //! Answers n independent rank queries: out[j] = rank(idx[j]) for \f$j\in[0..n-1]\f$.
+        void rank_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            for (size_type j=0; j < n; ++j) {
+                out[j] = rank(idx[j]);
+            }
+        }
+
         //! Return the size of the original vector
         const size_type size() const
         {
@@ -822,9 +904,16 @@ class rank_support_hyb
 
 //! Select support for the hyb_vector class
 /*!
+ * The superblock of every \f$s\f$-th argument is sampled, where \f$s\f$ is
+ * the power of two which yields about one sample per superblock. A query
+ * binary searches the superblocks between two samples (usually one or
+ * two) by their rank, walks the block headers of the superblock and
+ * selects inside the decoded block with bits::sel.
+ * The samples are not serialized; load and set_vector rebuild them from
+ * the vector in one pass over the superblock ranks.
+ *
  * \tparam t_b            The bit pattern of size one. (so `0` or `1`)
  * \tparam k_sblock_rate  Superblock rate (number of blocks inside superblock)
- * TODO: implement select queries, currently this is dummy class.
  */
 template<uint8_t t_b, uint32_t k_sblock_rate>
 class select_support_hyb
@@ -836,6 +925,46 @@ class select_support_hyb
         enum { bit_pat_len = (uint8_t)1 };
     private:
         const bit_vector_type* m_v;
+        uint8_t      m_log_s = 0; // log of the sample rate
+        int_vector<> m_samples;   // superblock of every (1<<m_log_s)-th argument
+
+        //! Number of sblocks of the supported vector
+        size_type sblocks() const
+        {
+            size_type n_blocks = (m_v->size() + bit_vector_type::k_block_size - 1) / bit_vector_type::k_block_size;
+            return (n_blocks + k_sblock_rate - 1) / k_sblock_rate;
+        }
+
+        //! Number of arguments before superblock sblock_id
+        size_type sblock_args(size_type sblock_id) const
+        {
+            size_type ones = m_v->sblock_rank(sblock_id);
+            return t_b ? ones : sblock_id * bit_vector_type::k_sblock_size - ones;
+        }
+
+        void build()
+        {
+            m_log_s = 0;
+            m_samples = int_vector<>();
+            if (m_v == nullptr or m_v->size() == 0) {
+                return;
+            }
+            size_type ones = rank_support_hyb<1, k_sblock_rate>(m_v)(m_v->size());
+            size_type arg_cnt = t_b ? ones : m_v->size() - ones;
+            if (arg_cnt == 0) {
+                return;
+            }
+            size_type n_sblocks = sblocks();
+            size_type args_per_sblock = arg_cnt / n_sblocks;
+            m_log_s = args_per_sblock ? bits::hi(args_per_sblock) : 0;
+            m_samples = int_vector<>(((arg_cnt - 1) >> m_log_s) + 1, 0, bits::hi(n_sblocks) + 1);
+            for (size_type sb = 0, next = 0; sb < n_sblocks; ++sb) {
+                size_type end = sb + 1 < n_sblocks ? sblock_args(sb + 1) : arg_cnt;
+                while (next < m_samples.size() and (next << m_log_s) < end) {
+                    m_samples[next++] = sb;
+                }
+            }
+        }
 
     public:
         //! Standard constructor
@@ -845,10 +974,46 @@ class select_support_hyb
         }
 
         //! Answers select queries
-        size_type select(size_type) const
+        size_type select(size_type i) const
         {
-            fprintf(stderr, "\nhyb_vector: select queries are not currently supported\n");
-            std::exit(EXIT_FAILURE);
+            assert(m_v != nullptr);
+            // (1) superblock: the last one with less than i arguments before it
+            size_type k = (i - 1) >> m_log_s;
+            size_type lb = m_samples[k];
+            size_type rb = k + 1 < m_samples.size() ? (size_type)m_samples[k + 1] : sblocks() - 1;
+            while (lb < rb) {
+                size_type mid = lb + (rb - lb + 1) / 2;
+                if (sblock_args(mid) < i) lb = mid;
+                else rb = mid - 1;
+            }
+            // (2) block: walk the headers of the superblock
+            size_type args = sblock_args(lb);
+            size_type block_id = lb * k_sblock_rate;
+            size_type trunk_ptr = 0;
+            uint16_t header = m_v->block_header(block_id, trunk_ptr);
+            const uint16_t* header_ptr16 = (const uint16_t*)(((const uint8_t*)m_v->m_sblock_header.data()) +
+                                           lb * bit_vector_type::k_sblock_header_size + 8);
+            while (true) {
+                uint32_t ones = (header & 0x1ff);
+                size_type block_args = t_b ? ones : bit_vector_type::k_block_size - ones;
+                if (args + block_args >= i) break;
+                args += block_args;
+                trunk_ptr += (header >> 10);
+                header = *(++header_ptr16);
+                ++block_id;
+            }
+            // (3) position inside the decoded block
+            uint64_t w[4];
+            m_v->decode_block(header, trunk_ptr, w);
+            size_type r = i - args;
+            for (uint32_t j = 0; ; ++j) {
+                uint64_t x = t_b ? w[j] : ~w[j];
+                size_type c = bits::cnt(x);
+                if (r <= c) {
+                    return block_id * bit_vector_type::k_block_size + 64 * j + bits::sel(x, r);
+                }
+                r -= c;
+            }
         }
 
         //! Shorthand for select(i)
@@ -857,31 +1022,48 @@ class select_support_hyb
             return select(i);
         }
 
+        //! Answers n independent select queries: out[j] = select(idx[j]) for \f$j\in[0..n-1]\f$.
+        void select_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            for (size_type j=0; j < n; ++j) {
+                out[j] = select(idx[j]);
+            }
+        }
+
         //! Return the size of the original vector
         const size_type size() const
         {
             return m_v->size();
         }
 
-        //! Set the supported vector
+        //! Set the supported vector and rebuild the samples from it
         void set_vector(const bit_vector_type* v = nullptr)
         {
             m_v = v;
+            build();
         }
 
         //! Assignment operator
-        select_support_hyb& operator=(const select_support_hyb& rs)
+        select_support_hyb& operator=(const select_support_hyb& ss)
         {
-            if (this != &rs) {
-                set_vector(rs.m_v);
+            if (this != &ss) {
+                m_log_s = ss.m_log_s;
+                m_samples = ss.m_samples;
+                m_v = ss.m_v;
             }
             return *this;
         }
 
         //! Swap method
-        void swap(select_support_hyb&) {}
+        void swap(select_support_hyb& ss)
+        {
+            std::swap(m_log_s, ss.m_log_s);
+            m_samples.swap(ss.m_samples);
+        }
 
         //! Load the data structure from a stream and set the supported vector
+        /*! Nothing is stored; the samples are rebuilt from the vector.
+         */
         void load(std::istream&, const bit_vector_type* v = nullptr)
         {
             set_vector(v);
@@ -29,6 +29,7 @@
 #include "uintx_t.hpp"
 
 #include "memory_management.hpp"
+#include "mmap_filebuf.hpp"
 #include "ram_fs.hpp"
 #include "sfstream.hpp"
 
@@ -283,6 +284,17 @@ struct int_vector_trait<8> {
  *
  *  \tparam t_width Width of the integer. If set to `0` it is variable
  *          during runtime, otherwise fixed at compile time.
+ *
+ *  \par Serialized format
+ *       The size in bits (8 bytes) and, for `t_width=0`, the width (1 byte)
+ *       are followed by the words of the vector. Streams which request
+ *       aligned words (see store_to_mapped_file) get a padded header if the
+ *       words would not start at a multiple of 8 bytes of the stream: the
+ *       most significant bit of the size is set and one byte \f$p\f$
+ *       followed by \f$p\f$ zero bytes aligns the words. Aligned words can be
+ *       loaded without copying from a memory mapped file (see
+ *       load_from_mapped_file). Files with padded headers cannot be read by
+ *       versions which predate this padding.
  *  @ingroup int_vector
  */
 template<uint8_t t_width>
@@ -320,6 +332,9 @@ class int_vector
 
         enum { fixed_int_width = t_width }; // make template parameter accessible
 
+        //! Set in the serialized size if padding aligns the words (see write_header).
+        static constexpr uint64_t aligned_flag = 1ULL<<63;
+
     private:
 
         size_type      m_size;  //!< Number of bits needed to store int_vector.
@@ -589,22 +604,40 @@ class int_vector
             }
         }
 
-        //! Read the size and int_width of a int_vector
+        //! Read the size and int_width of a int_vector and skip the padding which aligns its words
         static void read_header(int_vector_size_type& size, int_width_type& int_width, std::istream& in)
         {
             read_member(size, in);
             if (0 == t_width) {
                 read_member(int_width, in);
             }
+            if (size & aligned_flag) {
+                size &= ~aligned_flag;
+                uint8_t pad = 0;
+                read_member(pad, in);
+                in.ignore(pad);
+            }
         }
 
         //! Write the size and int_width of a int_vector
-        static uint64_t write_header(uint64_t size, uint8_t int_width, std::ostream& out)
+        /*! \param align If true and the position of out is known, the header is
+         *               padded such that the words start at a multiple of 8 bytes.
+         */
+        static uint64_t write_header(uint64_t size, uint8_t int_width, std::ostream& out, bool align=false)
         {
-            uint64_t written_bytes = write_member(size, out);
+            uint64_t header_bytes = t_width ? 8 : 9;
+            std::streamoff pos = align ? (std::streamoff)out.tellp() : -1;
+            bool padded = pos >= 0 and (pos+header_bytes)%8 != 0;
+            uint64_t written_bytes = write_member(padded ? size|aligned_flag : size, out);
             if (0 == t_width) {
                 written_bytes += write_member(int_width, out);
             }
+            if (padded) {
+                uint8_t pad = (8 - (pos+header_bytes+1)%8)%8;
+                written_bytes += write_member(pad, out);
+                out.write("\0\0\0\0\0\0\0", pad);
+                written_bytes += pad;
+            }
             return written_bytes;
         }
 
@@ -1567,10 +1600,11 @@ typename int_vector<t_width>::size_type int_vector<t_width>::serialize(std::ostr
 {
     structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
     size_type written_bytes = 0;
+    bool align = out.iword(aligned_words_iword()) != 0;
     if (t_width > 0 and write_fixed_as_variable) {
-        written_bytes += int_vector<0>::write_header(m_size, t_width, out);
+        written_bytes += int_vector<0>::write_header(m_size, t_width, out, align);
     } else {
-        written_bytes += int_vector<t_width>::write_header(m_size, m_width, out);
+        written_bytes += int_vector<t_width>::write_header(m_size, m_width, out, align);
     }
     written_bytes += write_data(out);
     structure_tree::add_size(child, written_bytes);
@@ -1583,6 +1617,17 @@ void int_vector<t_width>::load(std::istream& in)
     size_type size;
     int_vector<t_width>::read_header(size, m_width, in);
 
+    // zero-copy load: point into the file mapping (see load_from_mapped_file)
+    mmap_filebuf* mbuf = dynamic_cast<mmap_filebuf*>(in.rdbuf());
+    if (mbuf != nullptr and size > 0) {
+        uint64_t* data = mbuf->share(((size+63)>>6)<<3);
+        if (data != nullptr) {
+            memory_manager::clear(*this);
+            m_data = data;
+            m_size = size;
+            return;
+        }
+    }
     bit_resize(size);
     uint64_t* p = m_data;
     size_type idx = 0;
@@ -24,14 +24,89 @@
 #include "int_vector.hpp"
 #include "iterators.hpp"
 #include <cassert>
+#include <condition_variable>
+#include <exception>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <stdio.h>
 #include <string>
+#include <thread>
 
 namespace sdsl
 {
 
+//! Thread which runs the background I/O tasks of an int_vector_buffer one at a time.
+class int_vector_buffer_io
+{
+    private:
+        std::mutex              m_mtx;
+        std::condition_variable m_cv;
+        std::function<void()>   m_task;
+        bool                    m_busy = false;
+        bool                    m_stop = false;
+        std::exception_ptr      m_error;
+        std::thread             m_thread;
+
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(m_mtx);
+            while (true) {
+                m_cv.wait(lock, [this]() { return m_busy or m_stop; });
+                if (!m_busy) {
+                    return;
+                }
+                lock.unlock();
+                try {
+                    m_task();
+                } catch (...) {
+                    m_error = std::current_exception();
+                }
+                lock.lock();
+                m_task = nullptr;
+                m_busy = false;
+                m_cv.notify_all();
+            }
+        }
+    public:
+        int_vector_buffer_io() : m_thread([this]() { run(); }) {}
+        int_vector_buffer_io(const int_vector_buffer_io&) = delete;
+        int_vector_buffer_io& operator=(const int_vector_buffer_io&) = delete;
+
+        ~int_vector_buffer_io()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mtx);
+                m_stop = true;
+            }
+            m_cv.notify_all();
+            m_thread.join();
+        }
+
+        //! Runs task in the background; the previous task has to be finished (see wait).
+        void submit(std::function<void()> task)
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_task = std::move(task);
+            m_busy = true;
+            m_cv.notify_all();
+        }
+
+        //! Waits until the last task is finished and rethrows its exception.
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(m_mtx);
+            m_cv.wait(lock, [this]() { return !m_busy; });
+            if (m_error) {
+                std::exception_ptr e = m_error;
+                m_error = nullptr;
+                std::rethrow_exception(e);
+            }
+        }
+};
+
 template<uint8_t t_width=0>
 class int_vector_buffer
 {
@@ -47,59 +122,137 @@ class int_vector_buffer
         std::string         m_filename;
         int_vector<t_width> m_buffer;
         bool                m_need_to_write = false;
-        // length of int_vector header in bytes: 0 for plain, 8 for int_vector<t_width> (0 < t_width), 9 for int_vector<0>
+        // length of int_vector header in bytes: 0 for plain, 8 for int_vector<t_width> (0 < t_width), 9 for int_vector<0>,
+        // or up to 16 if the header of an existing file is padded
         uint64_t            m_offset     = 0;
         uint64_t            m_buffersize = 8;    // in elements! m_buffersize*width() must be a multiple of 8!
         uint64_t            m_size       = 0;    // size of int_vector_buffer
         uint64_t            m_begin      = 0;    // number in elements
-
-        //! Read block containing element at index idx.
-        void read_block(const uint64_t idx)
+        // Asynchronous mode (see async_io): the I/O thread writes the previous
+        // block (write-behind) and reads the next block in scan direction
+        // (read-ahead). At most one task is pending and only that task
+        // touches the streams while it runs.
+        bool                m_async      = false;
+        int_vector<t_width> m_wbuf;              // block which is written behind
+        int_vector<t_width> m_pbuf;              // block which is read ahead
+        bool                m_prefetched = false;// true if m_pbuf will contain block m_pbegin
+        uint64_t            m_pbegin     = 0;    // number in elements
+        std::unique_ptr<int_vector_buffer_io> m_io; // I/O thread, exists only in asynchronous mode
+
+        //! Read the block starting at element begin into buf. Elements at positions >= size are set to 0.
+        void load_block(int_vector<t_width>& buf, const uint64_t begin, const uint64_t size)
         {
-            m_begin = (idx/m_buffersize)*m_buffersize;
-            if (m_begin >= m_size) {
-                util::set_to_value(m_buffer, 0);
+            if (begin >= size) {
+                util::set_to_value(buf, 0);
             } else {
-                m_ifile.seekg(m_offset+(m_begin*width())/8);
+                m_ifile.seekg(m_offset+(begin*width())/8);
                 assert(m_ifile.good());
-                m_ifile.read((char*) m_buffer.data(), (m_buffersize*width())/8);
+                m_ifile.read((char*) buf.data(), (m_buffersize*width())/8);
                 if ((uint64_t)m_ifile.gcount() < (m_buffersize*width())/8) {
                     m_ifile.clear();
                 }
                 assert(m_ifile.good());
-                for (uint64_t i=m_size-m_begin; i<m_buffersize; ++i) {
-                    m_buffer[i] = 0;
+                for (uint64_t i=size-begin; i<m_buffersize; ++i) {
+                    buf[i] = 0;
                 }
             }
         }
 
+        //! Write the block starting at element begin from buf to file. Only elements at positions < size are written.
+        void store_block(const int_vector<t_width>& buf, const uint64_t begin, const uint64_t size)
+        {
+            m_ofile.seekp(m_offset+(begin*width())/8);
+            assert(m_ofile.good());
+            if (begin+m_buffersize >= size) {
+                //last block in file
+                uint64_t wb = ((size-begin)*width()+7)/8;
+                m_ofile.write((const char*) buf.data(), wb);
+            } else {
+                m_ofile.write((const char*) buf.data(), (m_buffersize*width())/8);
+            }
+            m_ofile.flush();
+            assert(m_ofile.good());
+        }
+
+        //! Read block containing element at index idx.
+        void read_block(const uint64_t idx)
+        {
+            m_begin = (idx/m_buffersize)*m_buffersize;
+            load_block(m_buffer, m_begin, m_size);
+        }
+
         //! Write current block to file.
         void write_block()
         {
             if (m_need_to_write) {
-                m_ofile.seekp(m_offset+(m_begin*width())/8);
-                assert(m_ofile.good());
-                if (m_begin+m_buffersize >= m_size) {
-                    //last block in file
-                    uint64_t wb = ((m_size-m_begin)*width()+7)/8;
-                    m_ofile.write((char*) m_buffer.data(), wb);
-                } else {
-                    m_ofile.write((char*) m_buffer.data(), (m_buffersize*width())/8);
-                }
-                m_ofile.flush();
-                assert(m_ofile.good());
+                store_block(m_buffer, m_begin, m_size);
                 m_need_to_write = false;
             }
         }
 
+        //! Wait until the pending background I/O is finished.
+        void wait_for_io()
+        {
+            if (m_io) {
+                m_io->wait();
+            }
+        }
+
+        //! Wait for background I/O and forget the read-ahead block.
+        void sync_io()
+        {
+            wait_for_io();
+            m_prefetched = false;
+        }
+
+        //! Write current block and make the block containing idx the current block.
+        void switch_block(const uint64_t idx)
+        {
+            if (!m_async) {
+                write_block();
+                read_block(idx);
+                return;
+            }
+            wait_for_io();
+            const uint64_t begin      = (idx/m_buffersize)*m_buffersize;
+            const uint64_t old_begin  = m_begin;
+            const bool     wrt_behind = m_need_to_write;
+            if (wrt_behind) {
+                m_wbuf.swap(m_buffer);
+                m_need_to_write = false;
+            }
+            if (m_prefetched and m_pbegin == begin) {
+                m_buffer.swap(m_pbuf);
+                m_begin = begin;
+            } else {
+                read_block(idx);
+            }
+            // read ahead in the direction of the last block switch
+            uint64_t next = begin + m_buffersize;
+            if (begin < old_begin) {
+                next = (begin >= m_buffersize) ? begin - m_buffersize : m_size;
+            }
+            m_prefetched = next < m_size;
+            m_pbegin     = next;
+            if (wrt_behind or m_prefetched) {
+                const uint64_t size = m_size;
+                const bool     prefetch = m_prefetched;
+                m_io->submit([this, wrt_behind, old_begin, prefetch, next, size]() {
+                    if (wrt_behind)
+                        store_block(m_wbuf, old_begin, size);
+                    if (prefetch)
+                        load_block(m_pbuf, next, size);
+                });
+            }
+        }
+
         //! Read value from idx.
         uint64_t read(const uint64_t idx)
         {
             assert(is_open());
             assert(idx < m_size);
             if (idx < m_begin or m_begin+m_buffersize <= idx) {
-                write_block();
-                read_block(idx);
+                switch_block(idx);
             }
             return m_buffer[idx-m_begin];
         }
@@ -110,8 +263,7 @@ class int_vector_buffer
             assert(is_open());
             // If idx is not in current block, write current block and load needed block
             if (idx < m_begin or m_begin+m_buffersize <= idx) {
-                write_block();
-                read_block(idx);
+                switch_block(idx);
             }
             if (m_size <= idx) {
                 m_size = idx+1;
@@ -166,6 +318,7 @@ class int_vector_buffer
                     uint8_t width = 0;
                     int_vector<t_width>::read_header(size, width, m_ifile);
                     m_buffer.width(width);
+                    m_offset = m_ifile.tellg();
                 }
                 assert(m_ifile.good());
                 m_size = size/width();
@@ -176,13 +329,18 @@ class int_vector_buffer
         //! Move constructor.
         int_vector_buffer(int_vector_buffer&& ivb) :
             m_filename(std::move(ivb.m_filename)),
-            m_buffer(std::move(ivb.m_buffer)),
             m_need_to_write(ivb.m_need_to_write),
             m_offset(ivb.m_offset),
             m_buffersize(ivb.m_buffersize),
             m_size(ivb.m_size),
             m_begin(ivb.m_begin)
         {
+            ivb.sync_io();
+            m_buffer = std::move(ivb.m_buffer);
+            m_async = ivb.m_async;
+            m_wbuf = std::move(ivb.m_wbuf);
+            m_pbuf = std::move(ivb.m_pbuf);
+            m_io = std::move(ivb.m_io);
             ivb.m_ifile.close();
             ivb.m_ofile.close();
             m_ifile.open(m_filename, std::ios::in|std::ios::binary);
@@ -197,6 +355,7 @@ class int_vector_buffer
             ivb.m_buffersize = 8;
             ivb.m_size = 0;
             ivb.m_begin = 0;
+            ivb.m_async = false;
         }
 
         //! Destructor.
@@ -209,6 +368,7 @@ class int_vector_buffer
         int_vector_buffer<t_width>& operator=(int_vector_buffer&& ivb)
         {
             close();
+            ivb.sync_io();
             ivb.m_ifile.close();
             ivb.m_ofile.close();
             m_filename = ivb.m_filename;
@@ -223,6 +383,10 @@ class int_vector_buffer
             m_buffersize = ivb.m_buffersize;
             m_size = ivb.m_size;
             m_begin = ivb.m_begin;
+            m_async = ivb.m_async;
+            m_wbuf = (int_vector<t_width>&&)ivb.m_wbuf;
+            m_pbuf = (int_vector<t_width>&&)ivb.m_pbuf;
+            m_io = std::move(ivb.m_io);
             // set ivb to default-constructor state
             ivb.m_filename = "";
             ivb.m_buffer = int_vector<t_width>();
@@ -231,6 +395,7 @@ class int_vector_buffer
             ivb.m_buffersize = 8;
             ivb.m_size = 0;
             ivb.m_begin = 0;
+            ivb.m_async = false;
             return *this;
         }
 
@@ -264,6 +429,7 @@ class int_vector_buffer
         {
             if (0ULL == buffersize)
                 buffersize = 8;
+            sync_io();
             write_block();
             if (0==(buffersize*8)%width()) {
                 m_buffersize = buffersize*8/width(); // m_buffersize might not be multiple of 8, but m_buffersize*width() is.
@@ -272,9 +438,36 @@ class int_vector_buffer
                 m_buffersize = element_buffersize+7 - (element_buffersize+7)%8; // take next multiple of 8
             }
             m_buffer = int_vector<t_width>(m_buffersize, 0, width());
+            async_io(m_async);
             if (0!=m_buffersize) read_block(0);
         }
 
+        //! Returns whether read-ahead and write-behind are enabled.
+        bool async_io() const
+        {
+            return m_async;
+        }
+
+        //! Enables or disables read-ahead and write-behind.
+        /*! In asynchronous mode a background thread writes the block which the
+         *  cursor left and reads the next block in scan direction. Two more blocks
+         *  of buffersize() bytes are allocated, so the buffer uses three times
+         *  buffersize() bytes. Disabled by default.
+         */
+        void async_io(bool enable)
+        {
+            sync_io();
+            m_async = enable;
+            uint64_t size = m_async ? m_buffersize : 0;
+            m_wbuf = int_vector<t_width>(size, 0, width());
+            m_pbuf = int_vector<t_width>(size, 0, width());
+            if (m_async and !m_io) {
+                m_io.reset(new int_vector_buffer_io());
+            } else if (!m_async) {
+                m_io.reset();
+            }
+        }
+
         //! Returns whether state of underlying streams are good
         bool good()
         {
@@ -291,6 +484,7 @@ class int_vector_buffer
         void reset()
         {
             // reset file
+            sync_io();
             assert(m_ifile.good());
             assert(m_ofile.good());
             m_ifile.close();
@@ -332,12 +526,14 @@ class int_vector_buffer
         void close(bool remove_file=false)
         {
             if (is_open()) {
+                sync_io();
                 if (!remove_file) {
                     write_block();
                     if (0 < m_offset) { // in case of int_vector, write header and trailing zeros
                         uint64_t size = m_size*width();
                         m_ofile.seekp(0, std::ios::beg);
-                        int_vector<t_width>::write_header(size, width(), m_ofile);
+                        // keep the padding of an existing file, new files are written unpadded
+                        int_vector<t_width>::write_header(size, width(), m_ofile, m_offset%8 == 0);
                         assert(m_ofile.good());
                         uint64_t wb = (size+7)/8;
                         if (wb%8) {
@@ -372,6 +568,8 @@ class int_vector_buffer
         void swap(int_vector_buffer<t_width>& ivb)
         {
             if (this != &ivb) {
+                sync_io();
+                ivb.sync_io();
                 m_ifile.close();
                 ivb.m_ifile.close();
                 m_ofile.close();
@@ -391,6 +589,10 @@ class int_vector_buffer
                 std::swap(m_buffersize, ivb.m_buffersize);
                 std::swap(m_size, ivb.m_size);
                 std::swap(m_begin, ivb.m_begin);
+                std::swap(m_async, ivb.m_async);
+                std::swap(m_wbuf, ivb.m_wbuf);
+                std::swap(m_pbuf, ivb.m_pbuf);
+                std::swap(m_io, ivb.m_io);
             }
         }
 
@@ -43,8 +43,9 @@ class int_vector_mapper
                         // update size in the on disk representation and
                         // truncate if necessary
                         uint64_t* size_in_file = (uint64_t*)m_mapped_data;
-                        if (*size_in_file != m_wrapper.m_size) {
-                            *size_in_file = m_wrapper.m_size;
+                        uint64_t size = m_wrapper.m_size | (*size_in_file & int_vector<t_width>::aligned_flag);
+                        if (*size_in_file != size) {
+                            *size_in_file = size;
                         }
                         if (t_width==0) {
                             // if size is variable and we map a sdsl vector
@@ -139,13 +140,12 @@ class int_vector_mapper
                 }
                 if (!is_plain) {
                     int_vector<t_width>::read_header(size_in_bits, int_width, f);
+                    m_data_offset = f.tellg();
                 }
             }
             m_file_size_bytes = util::file_size(m_file_name);
 
-            if (!is_plain) {
-                m_data_offset = t_width ? 8 : 9;
-            } else {
+            if (is_plain) {
                 if (8 != t_width and 16 != t_width and 32 != t_width and 64 != t_width) {
                     throw std::runtime_error("int_vector_mapper: plain vector can "
                                              "only be of width 8, 16, 32, 64.");
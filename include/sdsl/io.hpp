@@ -24,8 +24,11 @@
 #include "util.hpp"
 #include "sdsl_concepts.hpp"
 #include "structure_tree.hpp"
+#include "mmap_filebuf.hpp"
 #include <algorithm>
+#include <atomic>
 #include <string>
+#include <thread>
 #include <vector>
 #include <iostream>
 #include <cctype>
@@ -171,6 +174,100 @@ void load(std::vector<X>& x, std::istream& in)
 template<class T>
 bool load_from_file(T& v, const std::string& file);
 
+//! Load sdsl-object v from a file without copying its int_vectors.
+/*!
+ * The file is mapped copy-on-write into memory and the int_vectors of v
+ * point into the mapping. Unmodified pages are shared with the page cache
+ * and therefore with all processes which map the same file. An int_vector
+ * is copied to the heap when it is resized. Memory of the mapping is not
+ * reported to the memory_monitor.
+ * Only int_vectors whose words start at a multiple of 8 bytes in the file
+ * are mapped; the others are copied. Use store_to_mapped_file to write
+ * files in which all int_vectors are mapped.
+ * If the file cannot be mapped (e.g. it is a RAM-file), load_from_file is used.
+ * \param v sdsl-object
+ * \param file Name of the serialized file.
+ */
+template<class T>
+bool load_from_mapped_file(T& v, const std::string& file);
+
+//! Members of a structure which can be serialized and loaded separately.
+/*! A type T with a static `member_count` provides
+ *  `serialize_member(i, out, node)` and `load_member(i, in)` for
+ *  `i < member_count`. serialize writes the members in this order, and
+ *  different members can be loaded by different threads. Afterwards
+ *  `load_members_finish()` sets the pointers between the members. All
+ *  other types consist of a single member.
+ */
+template<class T, class = void>
+struct serialized_members {
+    static const size_t count = 1;
+
+    static uint64_t serialize(const T& v, size_t, std::ostream& out, structure_tree_node* node)
+    {
+        return v.serialize(out, node, "");
+    }
+    static void load(T& v, size_t, std::istream& in)
+    {
+        v.load(in);
+    }
+    static void finish(T&) {}
+};
+
+template<class T>
+struct serialized_members<T, typename std::enable_if<(T::member_count > 0)>::type> {
+    static const size_t count = T::member_count;
+
+    static uint64_t serialize(const T& v, size_t i, std::ostream& out, structure_tree_node* node)
+    {
+        return v.serialize_member(i, out, node);
+    }
+    static void load(T& v, size_t i, std::istream& in)
+    {
+        v.load_member(i, in);
+    }
+    static void finish(T& v)
+    {
+        v.load_members_finish();
+    }
+};
+
+//! Store a data structure followed by a table of the offsets of its members.
+/*! The file starts with the same bytes as written by store_to_file, so
+ *  load_from_file and earlier versions read it unchanged. The trailing
+ *  table lets load_from_file_parallel load the members in parallel (see
+ *  serialized_members).
+ *  \param v Data structure to store.
+ *  \param file Name of the file where to store the data structure.
+ *  \return If the data structure was stored successfully.
+ */
+template<class T>
+bool store_to_file_with_offsets(const T& v, const std::string& file);
+
+//! Reads the member offsets written by store_to_file_with_offsets.
+/*! \param file    Name of the file.
+ *  \param offsets Offsets of the members followed by the end of the last member.
+ *  \return False if the file has no valid table of offsets.
+ */
+bool read_member_offsets(const std::string& file, std::vector<uint64_t>& offsets);
+
+//! Load sdsl-object v from a file which is read by several threads.
+/*!
+ * If the file was written by store_to_file_with_offsets, the members of v
+ * are read and deserialized by parallel threads, each through its own
+ * stream. A member which does not end at the recorded offset fails the load.
+ * Otherwise, the file is read with parallel positioned reads into one
+ * memory region and v is deserialized from there without further copying
+ * (as in load_from_mapped_file).
+ * If the file cannot be read this way (e.g. it is a RAM-file), load_from_file is used.
+ * \param v       sdsl-object
+ * \param file    Name of the serialized file.
+ * \param threads Number of reading threads; 0 uses one per hardware thread.
+ * \return False if the file could not be loaded.
+ */
+template<class T>
+bool load_from_file_parallel(T& v, const std::string& file, uint64_t threads=0);
+
 //! Load an int_vector from a plain array of `num_bytes`-byte integers with X in \{0, 1,2,4,8\} from disk.
 // TODO: Remove ENDIAN dependency.
 template<class t_int_vec>
@@ -254,6 +351,27 @@ bool load_vector_from_file(t_int_vec& v, const std::string& file, uint8_t num_by
 template<class T>
 bool store_to_file(const T& v, const std::string& file);
 
+//! Index of the stream word (std::ios_base::iword) which requests aligned int_vector words.
+/*! If it is non-zero for an output stream, int_vector::serialize pads the
+ *  headers (see int_vector). Set by store_to_mapped_file.
+ */
+inline int aligned_words_iword()
+{
+    static const int index = std::ios_base::xalloc();
+    return index;
+}
+
+//! Store a data structure such that load_from_mapped_file maps all its int_vectors.
+/*! The int_vector headers are padded to align the words (see int_vector).
+ *  Earlier versions cannot read the file; store_to_file writes the
+ *  unpadded format.
+ *  \param v Data structure to store.
+ *  \param file Name of the file where to store the data structure.
+ *  \return If the data structure was stored successfully.
+ */
+template<class T>
+bool store_to_mapped_file(const T& v, const std::string& file);
+
 //! Specialization of store_to_file for a char array
 bool store_to_file(const char* v, const std::string& file);
 
@@ -670,6 +788,25 @@ bool store_to_file(const T& t, const std::string& file)
     return true;
 }
 
+template<class T>
+bool store_to_mapped_file(const T& t, const std::string& file)
+{
+    osfstream out(file, std::ios::binary | std::ios::trunc | std::ios::out);
+    if (!out) {
+        if (util::verbose) {
+            std::cerr<<"ERROR: store_to_mapped_file not successful for: `"<<file<<"`"<<std::endl;
+        }
+        return false;
+    }
+    out.iword(aligned_words_iword()) = 1;
+    serialize(t,out);
+    out.close();
+    if (util::verbose) {
+        std::cerr<<"INFO: store_to_mapped_file: `"<<file<<"`"<<std::endl;
+    }
+    return true;
+}
+
 template<class T>
 bool store_to_checked_file(const T& t, const std::string& file)
 {
@@ -743,6 +880,126 @@ bool load_from_file(T& v, const std::string& file)
     return true;
 }
 
+template<class T>
+bool load_from_mapped_file(T& v, const std::string& file)
+{
+    mmap_filebuf buf;
+    if (is_ram_file(file) or buf.open(file) == nullptr) {
+        return load_from_file(v, file);
+    }
+    std::istream in(&buf);
+    load(v, in);
+    buf.close();
+    if (util::verbose) {
+        std::cerr << "Load mapped file `" << file << "`" << std::endl;
+    }
+    return true;
+}
+
+//! Magic number which ends a file with a table of member offsets
+const uint64_t member_offsets_magic = 0x7364736c6d656d73ULL;
+
+template<class T>
+bool store_to_file_with_offsets(const T& v, const std::string& file)
+{
+    osfstream out(file, std::ios::binary | std::ios::trunc | std::ios::out);
+    if (!out) {
+        if (util::verbose) {
+            std::cerr<<"ERROR: store_to_file_with_offsets not successful for: `"<<file<<"`"<<std::endl;
+        }
+        return false;
+    }
+    std::vector<uint64_t> offsets(1, 0);
+    for (size_t i=0; i < serialized_members<T>::count; ++i) {
+        offsets.push_back(offsets.back() + serialized_members<T>::serialize(v, i, out, nullptr));
+    }
+    for (uint64_t offset : offsets) {
+        write_member(offset, out);
+    }
+    write_member((uint64_t)serialized_members<T>::count, out);
+    write_member(member_offsets_magic, out);
+    out.close();
+    if (util::verbose) {
+        std::cerr<<"INFO: store_to_file_with_offsets: `"<<file<<"`"<<std::endl;
+    }
+    return true;
+}
+
+//! Loads the members of v in parallel; see load_from_file_parallel
+template<class T>
+bool _load_members_parallel(T& v, const std::string& file, const std::vector<uint64_t>& offsets, uint64_t threads)
+{
+    const size_t count = serialized_members<T>::count;
+    // the largest members first
+    std::vector<size_t> order(count);
+    for (size_t i=0; i < count; ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return offsets[a+1]-offsets[a] > offsets[b+1]-offsets[b];
+    });
+    std::atomic<size_t> next(0);
+    std::atomic<bool> ok(true);
+    auto load_members = [&]() {
+        isfstream in(file, std::ios::binary | std::ios::in);
+        for (size_t k; ok and (k = next++) < count;) {
+            size_t i = order[k];
+            try {
+                in.seekg(offsets[i]);
+                serialized_members<T>::load(v, i, in);
+                if (!in or (uint64_t)in.tellg() != offsets[i+1]) {
+                    ok = false;
+                }
+            } catch (const std::exception&) {
+                ok = false;
+            }
+        }
+    };
+    std::vector<std::thread> loaders;
+    for (uint64_t t=1; t < std::min(threads, (uint64_t)count); ++t) {
+        loaders.emplace_back(load_members);
+    }
+    load_members();
+    for (auto& t : loaders) {
+        t.join();
+    }
+    if (!ok) {
+        if (util::verbose) {
+            std::cerr << "A member of `" << file << "` does not match its recorded offset" << std::endl;
+        }
+        return false;
+    }
+    serialized_members<T>::finish(v);
+    if (util::verbose) {
+        std::cerr << "Load " << count << " members of `" << file << "` with " << threads << " threads" << std::endl;
+    }
+    return true;
+}
+
+template<class T>
+bool load_from_file_parallel(T& v, const std::string& file, uint64_t threads)
+{
+    if (threads == 0) {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    std::vector<uint64_t> offsets;
+    if (serialized_members<T>::count > 1 and read_member_offsets(file, offsets)
+        and offsets.size() == serialized_members<T>::count+1) {
+        return _load_members_parallel(v, file, offsets, threads);
+    }
+    mmap_filebuf buf;
+    if (is_ram_file(file) or buf.read(file, threads) == nullptr) {
+        return load_from_file(v, file);
+    }
+    std::istream in(&buf);
+    load(v, in);
+    buf.close();
+    if (util::verbose) {
+        std::cerr << "Load file `" << file << "` with " << threads << " threads" << std::endl;
+    }
+    return true;
+}
+
 template<class T>
 bool load_from_checked_file(T& v, const std::string& file)
 {
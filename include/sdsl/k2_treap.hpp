@@ -408,8 +408,21 @@ class k2_treap
         std::vector<node_type>
         children(const node_type& v) const
         {
-            using namespace k2_treap_ns;
             std::vector<node_type> res;
+            children(v, res);
+            return res;
+        }
+
+        //! Writes the children of node v to res.
+        /*! res keeps its capacity, so repeated calls with the same container
+         *  do not allocate.
+         */
+        template<class t_vec>
+        void
+        children(const node_type& v, t_vec& res) const
+        {
+            using namespace k2_treap_ns;
+            res.clear();
             if (!is_leaf(v)) {
                 uint64_t rank = m_bp_rank(v.idx);
                 auto x = std::real(v.p);
@@ -438,7 +451,6 @@ class k2_treap
                     }
                 }
             }
-            return res;
         }
 
 };
@@ -24,6 +24,7 @@
 #include "sdsl/vectors.hpp"
 #include "sdsl/bits.hpp"
 #include "sdsl/k2_treap_helper.hpp"
+#include "sdsl/query_context.hpp"
 #include <tuple>
 #include <algorithm>
 #include <iterator>
@@ -88,6 +89,7 @@ class top_k_iterator
 
         const t_k2_treap* m_treap = nullptr;
         std::priority_queue<t_nt_b> m_pq;
+        std::vector<node_type> m_nodes; // buffer for the children of a node
         t_point_val m_point_val;
         point_type m_p1;
         point_type m_p2;
@@ -117,8 +119,8 @@ class top_k_iterator
                 auto is_contained = std::get<1>(m_pq.top());
                 m_pq.pop();
                 if (is_contained) {
-                    auto nodes = m_treap->children(v);
-                    for (auto node : nodes)
+                    m_treap->children(v, m_nodes);
+                    for (auto node : m_nodes)
                         m_pq.emplace(node, true);
                     m_point_val = t_point_val(v.max_p, v.max_v);
                     m_valid = true;
@@ -127,8 +129,8 @@ class top_k_iterator
                     if (contained<t_k2_treap::k>(m_p1, m_p2, v)) {
                         m_pq.emplace(v, true);
                     } else if (overlap<t_k2_treap::k>(m_p1, m_p2, v)) {
-                        auto nodes = m_treap->children(v);
-                        for (auto node : nodes)
+                        m_treap->children(v, m_nodes);
+                        for (auto node : m_nodes)
                             m_pq.emplace(node, false);
                         if (contained(v.max_p, m_p1, m_p2)) {
                             m_point_val = t_point_val(v.max_p, v.max_v);
@@ -178,6 +180,7 @@ class range_iterator
 
         const t_k2_treap* m_treap = nullptr;
         std::priority_queue<t_nt_b> m_pq;
+        std::vector<node_type> m_nodes; // buffer for the children of a node
         t_point_val m_point_val;
         point_type m_p1;
         point_type m_p2;
@@ -215,8 +218,8 @@ class range_iterator
                 auto is_contained = std::get<1>(m_pq.top());
                 m_pq.pop();
                 if (is_contained) {
-                    auto nodes = m_treap->children(v);
-                    for (auto node : nodes)
+                    m_treap->children(v, m_nodes);
+                    for (auto node : m_nodes)
                         pq_emplace(node, true);
                     if (v.max_v <= imag(m_r)) {
                         m_point_val = t_point_val(v.max_p, v.max_v);
@@ -227,8 +230,8 @@ class range_iterator
                     if (contained<t_k2_treap::k>(m_p1, m_p2, v)) {
                         m_pq.emplace(v, true);
                     } else if (overlap<t_k2_treap::k>(m_p1, m_p2, v)) {
-                        auto nodes = m_treap->children(v);
-                        for (auto node : nodes)
+                        m_treap->children(v, m_nodes);
+                        for (auto node : m_nodes)
                             pq_emplace(node, false);
                         if (contained(v.max_p, m_p1, m_p2) and v.max_v <= imag(m_r)) {
                             m_point_val = t_point_val(v.max_p, v.max_v);
@@ -330,6 +333,54 @@ count(const t_k2_treap& treap,
 }
 
 
+//! Count how many points are in the rectangle (p1,p2)
+/*! Version which takes the stack of the traversal from ctx. Repeated calls
+ *  with the same ctx do not allocate.
+ *  \param treap k2-treap
+ *  \param p1    Lower left corner of the rectangle.
+ *  \param p2    Upper right corner of the rectangle.
+ *  \param ctx   Query context which is reset by the call.
+ *  \return The number of points in rectangle (p1,p2).
+ *  \pre real(p1) <= real(p2) and imag(p1)<=imag(p2)
+ */
+template<typename t_k2_treap>
+uint64_t
+count(const t_k2_treap& treap,
+      k2_treap_ns::point_type p1,
+      k2_treap_ns::point_type p2,
+      query_context& ctx)
+{
+    using namespace k2_treap_ns;
+    typedef typename t_k2_treap::node_type node_type;
+    typedef std::pair<node_type, bool> t_nt_b; // (node, node is contained in (p1,p2))
+    if (treap.size() == 0) {
+        return 0;
+    }
+    ctx.reset();
+    arena_vector<t_nt_b> stack((arena_allocator<t_nt_b>(ctx)));
+    arena_vector<node_type> nodes((arena_allocator<node_type>(ctx)));
+    uint64_t res = 0;
+    stack.emplace_back(treap.root(), false);
+    while (!stack.empty()) {
+        node_type v = stack.back().first;
+        bool is_contained = stack.back().second or contained<t_k2_treap::k>(p1, p2, v);
+        stack.pop_back();
+        if (is_contained) {
+            res += 1; // count the point at the node
+        } else if (overlap<t_k2_treap::k>(p1, p2, v)) {
+            res += contained(v.max_p, p1, p2);
+        } else {
+            continue;
+        }
+        treap.children(v, nodes);
+        for (auto node : nodes) {
+            stack.emplace_back(node, is_contained);
+        }
+    }
+    return res;
+}
+
+
 template<typename t_k2_treap>
 uint64_t
 _count(const t_k2_treap& treap,
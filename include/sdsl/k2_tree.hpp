@@ -28,6 +28,7 @@
 #include "sdsl/bit_vectors.hpp"
 #include "sdsl/k2_tree_helper.hpp"
 #include "sdsl/int_vector_buffer.hpp"
+#include "sdsl/query_context.hpp"
 
 
 //! Namespace for the succint data structure library
@@ -110,6 +111,52 @@ class k2_tree
         }
 
 
+        // Stack entry of the traversal of range
+        struct range_state {
+            idx_type n, row1, row2, col1, col2, dr, dc, z;
+            range_state(idx_type n, idx_type row1, idx_type row2, idx_type col1, idx_type col2,
+                        idx_type dr, idx_type dc, idx_type z)
+                : n(n), row1(row1), row2(row2), col1(col1), col2(col2), dr(dr), dc(dc), z(z) {}
+        };
+
+        template<class t_states>
+        void _range(idx_type row1, idx_type row2, idx_type col1, idx_type col2,
+                    std::vector<std::pair<idx_type,idx_type>>& res,
+                    t_states& states) const
+        {
+            res.clear();
+            size_type n = static_cast<size_type>(std::pow(k_k, k_height)) / k_k;
+            // z = max marks the root, which has no bit in k_t
+            const idx_type root = std::numeric_limits<idx_type>::max();
+            states.emplace_back(n, row1, row2, col1, col2, 0, 0, root);
+
+            while (!states.empty()) {
+                range_state s = states.back();
+                states.pop_back();
+
+                if (s.z != root && s.z >= k_t.size()) { // Last level
+                    if (k_l[s.z - k_t.size()] == 1) {
+                        res.emplace_back(s.dr, s.dc);
+                    }
+                } else if (s.z == root || k_t[s.z] == 1) {
+                    auto y = k_t_rank(s.z+1) * k_k * k_k;
+
+                    for (idx_type i=s.row1/s.n; i<=s.row2/s.n; ++i) {
+                        idx_type row1new = (i == s.row1/s.n) ? s.row1 % s.n : 0;
+                        idx_type row2new = (i == s.row2/s.n) ? s.row2 % s.n : s.n - 1;
+
+                        for (idx_type j=s.col1/s.n; j<=s.col2/s.n; ++j) {
+                            idx_type col1new = (j == s.col1/s.n) ? s.col1 % s.n : 0;
+                            idx_type col2new = (j == s.col2/s.n) ? s.col2 % s.n : s.n - 1;
+
+                            states.emplace_back(s.n/k_k, row1new, row2new, col1new, col2new,
+                                                s.dr + s.n*i, s.dc + s.n*j, y + k_k*i+j);
+                        }
+                    }
+                }
+            }
+        }
+
         /*! Recursive function to retrieve list of neighbors.
          *
          *  \param n Size of the submatrix in the next recursive step.
@@ -480,8 +527,21 @@ class k2_tree
         std::vector<idx_type> neigh(idx_type i) const
         {
             std::vector<idx_type> acc{};
+            neigh(i, acc);
+            return acc;
+        }
+
+        //! Writes the list of neighbors of node i to acc.
+        /*! acc keeps its capacity, so repeated calls with the same vector
+         *  do not allocate.
+         *  \param i   Node to get neighbors from.
+         *  \param acc Holds the neighbors of node i after the call.
+         */
+        void neigh(idx_type i, std::vector<idx_type>& acc) const
+        {
+            acc.clear();
             if (k_l.size() == 0 && k_t.size() == 0)
-                return acc;
+                return;
 			// n = k^h / k
 			// k^h - dimension n of matrix nxn
 			// /k  - to calculate div only once and not for for all parameter again, always (n/k)
@@ -491,7 +551,6 @@ class k2_tree
             idx_type y = k_k * std::floor(i/static_cast<double>(n));
             for (unsigned j = 0; j < k_k; j++)
                 _neigh(n/k_k, i % n, n * j, y + j, acc);
-            return acc;
         }
 
         //! Returns a list of reverse neighbors of node i.
@@ -502,70 +561,58 @@ class k2_tree
         std::vector<idx_type> reverse_neigh(idx_type i) const
         {
             std::vector<idx_type> acc{};
+            reverse_neigh(i, acc);
+            return acc;
+        }
+
+        //! Writes the list of reverse neighbors of node i to acc.
+        /*! acc keeps its capacity, so repeated calls with the same vector
+         *  do not allocate.
+         *  \param i   Node to get reverse neighbors from.
+         *  \param acc Holds the reverse neighbors of node i after the call.
+         */
+        void reverse_neigh(idx_type i, std::vector<idx_type>& acc) const
+        {
+            acc.clear();
             if (k_l.size() == 0 && k_t.size() == 0)
-                return acc;
+                return;
             // Size of the first square division
             size_type n =
                 static_cast<size_type>(std::pow(k_k, k_height)) / k_k;
             idx_type y = std::floor(i/static_cast<double>(n));
             for (unsigned j = 0; j < k_k; j++)
                 _reverse_neigh(n/k_k, n * j, i % n, y + j * k_k, acc);
-
-            return acc;
         }
 
+        //! Returns the edges (r,c) with row1 <= r <= row2 and col1 <= c <= col2.
         std::vector<std::pair<idx_type,idx_type>> range(
 			idx_type row1, idx_type row2,
 			idx_type col1, idx_type col2
 		) const {
 			std::vector<std::pair<idx_type,idx_type>> res;
-
-			size_type n = static_cast<size_type>(std::pow(k_k, k_height)) / k_k;
-			struct state{
-				idx_type n, row1, row2, col1, col2, dr, dc, z;
-				state(idx_type n, idx_type row1, idx_type row2, idx_type col1, idx_type col2,
-					  idx_type dr, idx_type dc, idx_type z)
-					: n(n), row1(row1), row2(row2), col1(col1), col2(col2), dr(dr), dc(dc), z(z) {}
-			};
-			std::vector<state> states;
+			std::vector<range_state> states;
 			states.reserve(k_height); // minimum
-			states.emplace_back(n, row1, row2, col1, col2, 0, 0, std::numeric_limits<idx_type>::max());
-
-			while(!states.empty()){
-				state s = states.back();
-				states.pop_back();
-
-				//TODO: peel first loop where z==-1 atm
-				if(s.z!=std::numeric_limits<idx_type>::max() && s.z >= k_t.size()){ // Last level
-					if(k_l[s.z - k_t.size()] == 1){
-						res.emplace_back(s.dr, s.dc);
-					}
-				}else if(s.z==std::numeric_limits<idx_type>::max() || k_t[s.z]==1){
-
-					auto y = k_t_rank(s.z+1) * k_k * k_k;
-
-					for(idx_type i=s.row1/s.n; i<=s.row2/s.n; ++i){
-						idx_type row1new, row2new;
-						//TODO: loop peeling, first iteration and last iteration special
-						if(i==s.row1/s.n) row1new = s.row1 % s.n; else row1new = 0;
-						if(i==s.row2/s.n) row2new = s.row2 % s.n; else row2new = s.n - 1;
-
-						for(idx_type j=s.col1/s.n; j<=s.col2/s.n; ++j){
-							idx_type col1new, col2new;
-							//TODO: loop peeling, first iteration and last iteration special
-							if(j==s.col1/s.n) col1new = s.col1 % s.n; else col1new = 0;
-							if(j==s.col2/s.n) col2new = s.col2 % s.n; else col2new = s.n - 1;
-
-							states.emplace_back(s.n/k_k, row1new, row2new, col1new, col2new,
-												s.dr + s.n*i, s.dc + s.n*j, y + k_k*i+j);
-						}
-					}
-				}
-			}
-
+			_range(row1, row2, col1, col2, res, states);
 			return res;
         };
 
+        //! Writes the edges (r,c) with row1 <= r <= row2 and col1 <= c <= col2 to res.
+        /*! The stack of the traversal is taken from ctx. Repeated calls with
+         *  the same res and ctx do not allocate.
+         *  \param res Holds the edges after the call.
+         *  \param ctx Query context which is reset by the call.
+         */
+        void range(idx_type row1, idx_type row2,
+                   idx_type col1, idx_type col2,
+                   std::vector<std::pair<idx_type,idx_type>>& res,
+                   query_context& ctx) const
+        {
+            ctx.reset();
+            arena_vector<range_state> states((arena_allocator<range_state>(ctx)));
+            states.reserve(k_height); // minimum
+            _range(row1, row2, col1, col2, res, states);
+        }
+
         //! Serialize to a stream
         /*! Serialize the k2_tree data structure
          *  \param out Outstream to write the k2_tree.
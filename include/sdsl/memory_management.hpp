@@ -8,12 +8,15 @@
 #include "uintx_t.hpp"
 #include "util.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <iostream>
 #include <cstdlib>
 #include <mutex>
 #include <chrono>
 #include <cstring>
+#include <list>
 #include <set>
 #include <cstddef>
 #include <stack>
@@ -38,6 +41,16 @@ class memory_monitor;
 template<format_type F>
 void write_mem_log(std::ostream& out, const memory_monitor& m);
 
+//! Records the memory usage of int_vectors and the events of a program.
+/*! Each thread sums up its allocations in a thread local counter. The sum is
+ *  merged into the global usage, when it changed by at least
+ *  conf::SDSL_MEMORY_MONITOR_MERGE_SIZE bytes, when the thread opens or closes
+ *  an event, and when the thread exits. Only merges take the lock and read
+ *  the clock, so recording is cheap and may be called from several threads.
+ *  The usage of a merge is added to the innermost event of the thread, or if
+ *  the thread has no event, to the most recently opened event of any thread.
+ *  Within the log granularity the samples are combined into their maximum.
+ */
 class memory_monitor
 {
     public:
@@ -66,53 +79,94 @@ class memory_monitor
                 return true;
             }
         };
+    private:
+        typedef std::list<mm_event>::iterator event_iterator;
+        // state of a thread
+        struct thread_state {
+            uint64_t epoch = 0;                 // start/stop epoch of the state
+            int64_t pending = 0;                // allocated bytes not yet merged
+            std::vector<event_iterator> events; // open events of the thread
+            ~thread_state()
+            {
+                if (pending != 0) {
+                    merge(*this);
+                }
+            }
+        };
+        static thread_state& local_state()
+        {
+            static thread_local thread_state s;
+            return s;
+        }
+    public:
         struct mm_event_proxy {
             bool add;
             timer::time_point created;
-            mm_event_proxy(const std::string& name, int64_t usage, bool a) : add(a)
+            uint64_t epoch = 0;
+            mm_event_proxy(const std::string& name, int64_t, bool a) : add(a)
             {
                 if (add) {
                     auto& m = the_monitor();
+                    auto& s = local_state();
+                    merge(s);
                     std::lock_guard<util::spin_lock> lock(m.spinlock);
-                    m.event_stack.emplace(name, usage);
+                    if (!m.track_usage or s.epoch != m.epoch) {
+                        add = false;
+                        return;
+                    }
+                    m.open_events.emplace_back(name, m.current_usage);
+                    s.events.push_back(std::prev(m.open_events.end()));
+                    epoch = s.epoch;
                 }
             }
+            mm_event_proxy(mm_event_proxy&& p) : add(p.add), created(p.created), epoch(p.epoch)
+            {
+                p.add = false;
+            }
+            mm_event_proxy(const mm_event_proxy&) = delete;
+            mm_event_proxy& operator=(const mm_event_proxy&) = delete;
             ~mm_event_proxy()
             {
                 if (add) {
                     auto& m = the_monitor();
+                    auto& s = local_state();
+                    merge(s);
                     std::lock_guard<util::spin_lock> lock(m.spinlock);
-                    auto& cur = m.event_stack.top();
+                    // the monitor was stopped or restarted meanwhile
+                    if (epoch != m.epoch or s.epoch != m.epoch or s.events.empty()) {
+                        return;
+                    }
+                    auto cur = s.events.back();
+                    s.events.pop_back();
                     auto cur_time = timer::now();
-                    cur.allocations.emplace_back(cur_time, m.current_usage);
-                    m.completed_events.emplace_back(std::move(cur));
-                    m.event_stack.pop();
-                    // add a point to the new "top" with the same memory
-                    // as before but just ahead in time
-                    if (!m.event_stack.empty()) {
-                        if (m.event_stack.top().allocations.size()) {
-                            auto last_usage = m.event_stack.top().allocations.back().usage;
-                            m.event_stack.top().allocations.emplace_back(cur_time, last_usage);
-                        }
+                    cur->allocations.emplace_back(cur_time, m.current_usage);
+                    m.completed_events.emplace_back(std::move(*cur));
+                    m.open_events.erase(cur);
+                    // add a point to the new "top" just ahead in time
+                    auto& top = m.current_event(s);
+                    if (top.allocations.size()) {
+                        top.allocations.emplace_back(cur_time, m.current_usage);
                     }
                 }
             }
         };
         std::chrono::milliseconds log_granularity = std::chrono::milliseconds(20ULL);
-        int64_t current_usage = 0;
-        bool track_usage = false;
+        std::atomic<int64_t> current_usage{0};
+        std::atomic<bool> track_usage{false};
         std::vector<mm_event> completed_events;
-        std::stack<mm_event> event_stack;
+        std::list<mm_event> open_events; // the first one is the "unknown" event
         timer::time_point start_log;
         timer::time_point last_event;
+        std::atomic<uint64_t> epoch{0};  // incremented by start and stop
         util::spin_lock spinlock;
     private:
         // disable construction of the object
         memory_monitor() {};
         ~memory_monitor()
         {
+            std::lock_guard<util::spin_lock> lock(spinlock);
             if (track_usage) {
-                stop();
+                close_events();
             }
         }
         memory_monitor(const memory_monitor&) = delete;
@@ -123,18 +177,69 @@ class memory_monitor
             static memory_monitor m;
             return m;
         }
+        // innermost event of the thread; the spinlock has to be held
+        mm_event& current_event(const thread_state& s)
+        {
+            if (!s.events.empty()) {
+                return *s.events.back();
+            }
+            return open_events.back();
+        }
+        // completes all open events; the spinlock has to be held
+        void close_events()
+        {
+            while (!open_events.empty()) {
+                completed_events.emplace_back(std::move(open_events.back()));
+                open_events.pop_back();
+            }
+            track_usage = false;
+            ++epoch;
+        }
+        // adds the pending bytes of a thread to the usage
+        static void merge(thread_state& s)
+        {
+            auto& m = the_monitor();
+            std::lock_guard<util::spin_lock> lock(m.spinlock);
+            if (!m.track_usage) {
+                s.pending = 0;
+                return;
+            }
+            if (s.epoch != m.epoch) { // first merge after a restart
+                s.epoch = m.epoch;
+                s.pending = 0;
+                s.events.clear();
+                return;
+            }
+            if (s.pending == 0) {
+                return;
+            }
+            m.current_usage += s.pending;
+            s.pending = 0;
+            int64_t usage = m.current_usage;
+            auto cur = timer::now();
+            auto& ev = m.current_event(s);
+            if (m.last_event + m.log_granularity < cur or ev.allocations.empty()) {
+                ev.allocations.emplace_back(cur, usage);
+                m.last_event = cur;
+            } else {
+                ev.allocations.back().usage = std::max(ev.allocations.back().usage, usage);
+                ev.allocations.back().timestamp = cur;
+            }
+        }
     public:
         static void granularity(std::chrono::milliseconds ms)
         {
             auto& m = the_monitor();
+            std::lock_guard<util::spin_lock> lock(m.spinlock);
             m.log_granularity = ms;
         }
         static int64_t peak()
         {
             auto& m = the_monitor();
+            std::lock_guard<util::spin_lock> lock(m.spinlock);
             int64_t max = 0;
-            for (auto events : m.completed_events) {
-                for (auto alloc : events.allocations) {
+            for (const auto& events : m.completed_events) {
+                for (const auto& alloc : events.allocations) {
                     if (max < alloc.usage) {
                         max = alloc.usage;
                     }
@@ -146,55 +251,51 @@ class memory_monitor
         static void start()
         {
             auto& m = the_monitor();
-            m.track_usage = true;
+            auto& s = local_state();
+            std::lock_guard<util::spin_lock> lock(m.spinlock);
             // clear if there is something there
-            if (m.completed_events.size()) {
-                m.completed_events.clear();
-            }
-            while (m.event_stack.size()) {
-                m.event_stack.pop();
-            }
+            m.completed_events.clear();
+            m.open_events.clear();
             m.start_log = timer::now();
             m.current_usage = 0;
             m.last_event = m.start_log;
-            m.event_stack.emplace("unknown", 0);
+            m.open_events.emplace_back("unknown", 0);
+            s.epoch = ++m.epoch;
+            s.pending = 0;
+            s.events.clear();
+            m.track_usage = true;
         }
         static void stop()
         {
             auto& m = the_monitor();
-            while (!m.event_stack.empty()) {
-                m.completed_events.emplace_back(std::move(m.event_stack.top()));
-                m.event_stack.pop();
+            merge(local_state());
+            std::lock_guard<util::spin_lock> lock(m.spinlock);
+            if (m.track_usage) {
+                m.close_events();
             }
-            m.track_usage = false;
         }
         static void record(int64_t delta)
         {
             auto& m = the_monitor();
-            if (m.track_usage) {
-                std::lock_guard<util::spin_lock> lock(m.spinlock);
-                auto cur = timer::now();
-                if (m.last_event + m.log_granularity < cur) {
-                    m.event_stack.top().allocations.emplace_back(cur, m.current_usage);
-                    m.current_usage = m.current_usage + delta;
-                    m.event_stack.top().allocations.emplace_back(cur, m.current_usage);
-                    m.last_event = cur;
-                } else {
-                    if (m.event_stack.top().allocations.size()) {
-                        m.current_usage = m.current_usage + delta;
-                        m.event_stack.top().allocations.back().usage = m.current_usage;
-                        m.event_stack.top().allocations.back().timestamp = cur;
-                    }
+            if (m.track_usage.load(std::memory_order_relaxed)) {
+                auto& s = local_state();
+                uint64_t epoch = m.epoch.load(std::memory_order_relaxed);
+                if (s.epoch != epoch) { // first allocation after a restart
+                    s.epoch = epoch;
+                    s.pending = 0;
+                    s.events.clear();
+                }
+                s.pending += delta;
+                if (s.pending >= conf::SDSL_MEMORY_MONITOR_MERGE_SIZE or
+                    s.pending <= -conf::SDSL_MEMORY_MONITOR_MERGE_SIZE) {
+                    merge(s);
                 }
             }
         }
         static mm_event_proxy event(const std::string& name)
         {
             auto& m = the_monitor();
-            if (m.track_usage) {
-                return mm_event_proxy(name, m.current_usage, true);
-            }
-            return mm_event_proxy(name, m.current_usage, false);
+            return mm_event_proxy(name, m.current_usage, m.track_usage);
         }
         template<format_type F>
         static void write_memory_log(std::ostream& out)
@@ -217,14 +318,24 @@ typedef struct bfoot {
 
 
 #ifndef MSVC_COMPILER
+//! Allocator for one hugepage-backed region.
+/*! The region is managed as one heap of blocks, which is protected by a
+ *  mutex. Small blocks (up to 32 KiB) are additionally kept in a cache per
+ *  thread after they are freed, so that threads which allocate and free small
+ *  vectors concurrently (parallel construction, query threads) rarely contend
+ *  for the heap.
+ */
 class hugepage_allocator
 {
     private:
+        struct thread_cache;
+
         uint8_t* m_base = nullptr;
         mm_block_t* m_first_block = nullptr;
         uint8_t* m_top = nullptr;
         size_t m_total_size = 0;
         std::multimap<size_t, mm_block_t*> m_free_large;
+        std::mutex m_heap_mutex; // protects the heap, i.e. all members above except m_base and m_total_size
     private:
         size_t determine_available_hugepage_memory();
         void coalesce_block(mm_block_t* block);
@@ -236,8 +347,18 @@ class hugepage_allocator
         mm_block_t* find_free_block(size_t size_in_bytes);
         mm_block_t* last_block();
         void print_heap();
+        // Heap operations. The caller has to hold m_heap_mutex.
+        void* heap_alloc(size_t size_in_bytes);
+        void heap_free(void* ptr);
+        void* heap_realloc(void* ptr, size_t size);
+        static thread_cache& local_cache();
     public:
-        void init(SDSL_UNUSED size_t size_in_bytes = 0)
+        //! Maps the heap of the allocator.
+        /*! \param size_in_bytes Size of the heap. 0 means all free hugepages.
+         *  \param hugepages     If false, the heap is mapped with normal pages,
+         *                       e.g. to test the allocator on systems without hugepages.
+         */
+        void init(SDSL_UNUSED size_t size_in_bytes = 0, SDSL_UNUSED bool hugepages = true)
         {
 #ifdef MAP_HUGETLB
             if (size_in_bytes == 0) {
@@ -247,7 +368,7 @@ class hugepage_allocator
             m_total_size = size_in_bytes;
             m_base = (uint8_t*)mmap(nullptr, m_total_size,
                                     (PROT_READ | PROT_WRITE),
-                                    (MAP_HUGETLB | MAP_ANONYMOUS | MAP_PRIVATE), 0, 0);
+                                    ((hugepages ? MAP_HUGETLB : 0) | MAP_ANONYMOUS | MAP_PRIVATE), 0, 0);
             if (m_base == MAP_FAILED) {
                 throw std::system_error(ENOMEM, std::system_category(),
                                         "hugepage_allocator could not allocate hugepages");
@@ -266,11 +387,12 @@ class hugepage_allocator
         void mm_free(void* ptr);
         bool in_address_space(void* ptr)
         {
-            // check if ptr is in the hugepage address space
+            // check if ptr is in the hugepage address space. The whole mapping is
+            // checked, as m_top may be moved concurrently by other threads.
             if (ptr == nullptr) {
                 return true;
             }
-            if (ptr >= m_base && ptr < m_top) {
+            if (ptr >= m_base && ptr < m_base + m_total_size) {
                 return true;
             }
             return false;
@@ -283,17 +405,97 @@ class hugepage_allocator
 };
 #endif
 
+//! NUMA placement of the int_vector storage allocated by a thread.
+enum numa_placement {
+    NUMA_FIRST_TOUCH, // pages are placed on the node which touches them first (OS default)
+    NUMA_INTERLEAVE,  // pages are interleaved over all nodes
+    NUMA_NODE         // pages are placed on a given node
+};
+
 class memory_manager
 {
     private:
+        struct numa_policy {
+            numa_placement placement = NUMA_FIRST_TOUCH;
+            uint32_t       node      = 0;
+        };
+        struct mapped_region {
+            size_t   size;    // length of the mapping in bytes
+            uint64_t refs;    // number of owners (int_vectors and open mmap_filebufs)
+            uint64_t counted; // bytes of the region reported to the memory_monitor
+        };
         bool hugepages = false;
+        std::map<const uint8_t*, mapped_region> mapped;  // file mappings used by load_from_mapped_file
+        std::atomic<size_t> mapped_cnt{0};               // == mapped.size(); read without lock
+        util::spin_lock mapped_lock;
     private:
         static memory_manager& the_manager()
         {
             static memory_manager m;
             return m;
         }
+        std::map<const uint8_t*, mapped_region>::iterator find_region(const void* ptr);
+        static numa_policy& thread_numa_policy()
+        {
+            static thread_local numa_policy p;
+            return p;
+        }
+        //! Applies the NUMA policy of the calling thread to the whole pages in [ptr, ptr+size_in_bytes).
+        static void numa_place(void* ptr, size_t size_in_bytes);
     public:
+        //! Sets the NUMA placement of int_vector storage which is allocated by the calling thread.
+        /*! Storage which is already allocated is not moved. See numa_support.hpp for
+         *  per-node replicas of an index and a thread pool which is pinned to nodes.
+         *  \param placement The placement policy.
+         *  \param node      The node for NUMA_NODE.
+         */
+        static void set_numa_placement(numa_placement placement, uint32_t node=0)
+        {
+            auto& p = thread_numa_policy();
+            p.placement = placement;
+            p.node = node;
+        }
+        //! Map a file copy-on-write into memory.
+        /*! The mapping is followed by at least 8 zero bytes, so that the padding word
+         *  of an int_vector which ends at the end of the file is readable.
+         *  \param file      Name of the file.
+         *  \param file_size Will contain the size of the file in bytes.
+         *  \return Start of the mapping (owned once by the caller) or nullptr on failure.
+         */
+        static uint8_t* map_file_private(const std::string& file, uint64_t& file_size);
+        //! Read a file with several threads into a new anonymous mapping.
+        /*! The returned region is managed like the result of map_file_private,
+         *  but is counted by the memory_monitor.
+         *  \param file      Name of the file.
+         *  \param file_size Will contain the size of the file in bytes.
+         *  \param threads   Number of reading threads.
+         *  \return Start of the region (owned once by the caller) or nullptr on failure.
+         */
+        static uint8_t* read_file_private(const std::string& file, uint64_t& file_size, uint64_t threads);
+        //! Returns whether ptr points into a mapping created by map_file_private.
+        static bool is_mapped(const void* ptr)
+        {
+            auto& m = the_manager();
+            if (m.mapped_cnt.load(std::memory_order_acquire) == 0) {
+                return false;
+            }
+            std::lock_guard<util::spin_lock> lock(m.mapped_lock);
+            return m.find_region(ptr) != m.mapped.end();
+        }
+        //! Add an owner to the mapping which contains ptr.
+        static void acquire_mapped(const void* ptr);
+        //! Return the pages of a region created by read_file_private which no owner uses.
+        /*! Only whole pages outside of the given ranges are returned to the system.
+         *  Nothing is done if the caller is the only owner or the region is a file mapping.
+         *  \param base   Start of the region.
+         *  \param shared Sorted byte ranges [first, second) of the region which are still in use.
+         */
+        static void trim_mapped(const void* base, const std::vector<std::pair<uint64_t, uint64_t>>& shared);
+        //! Remove an owner from the mapping which contains ptr. The mapping is removed with its last owner.
+        /*! \return false if ptr does not point into a mapping.
+         */
+        static bool release_mapped(const void* ptr);
+
         static uint64_t* alloc_mem(size_t size_in_bytes)
         {
 #ifndef MSVC_COMPILER
@@ -302,10 +504,17 @@ class memory_manager
                 return (uint64_t*)hugepage_allocator::the_allocator().mm_alloc(size_in_bytes);
             }
 #endif
-            return (uint64_t*)calloc(size_in_bytes, 1);
+            uint64_t* ptr = (uint64_t*)calloc(size_in_bytes, 1);
+            if (thread_numa_policy().placement != NUMA_FIRST_TOUCH) {
+                numa_place(ptr, size_in_bytes);
+            }
+            return ptr;
         }
         static void free_mem(uint64_t* ptr)
         {
+            if (release_mapped(ptr)) {
+                return;
+            }
 #ifndef MSVC_COMPILER
             auto& m = the_manager();
             if (m.hugepages and hugepage_allocator::the_allocator().in_address_space(ptr)) {
@@ -327,6 +536,9 @@ class memory_manager
             if (temp == NULL) {
                 throw std::bad_alloc();
             }
+            if (thread_numa_policy().placement != NUMA_FIRST_TOUCH) {
+                numa_place(temp, size);
+            }
             return temp;
         }
     public:
@@ -346,14 +558,25 @@ class memory_manager
             uint64_t old_size_in_bytes = ((v.m_size + 63) >> 6) << 3;
             uint64_t new_size_in_bytes = ((size + 63) >> 6) << 3;
             bool do_realloc = old_size_in_bytes != new_size_in_bytes;
+            bool mapped = is_mapped(v.m_data);
             v.m_size = size;
-            if (do_realloc || v.m_data == nullptr) {
+            if (do_realloc || v.m_data == nullptr || mapped) {
                 // Note that we allocate 8 additional bytes if m_size % 64 == 0.
                 // We need this padding since rank data structures do a memory
                 // access to this padding to answer rank(size()) if size()%64 ==0.
                 // Note that this padding is not counted in the serialize method!
                 size_t allocated_bytes = (size_t)(((size + 64) >> 6) << 3);
-                v.m_data = memory_manager::realloc_mem(v.m_data, allocated_bytes);
+                if (mapped) { // a resized vector leaves the file mapping
+                    uint64_t* data = memory_manager::alloc_mem(allocated_bytes);
+                    if (allocated_bytes != 0 && data == nullptr) {
+                        throw std::bad_alloc();
+                    }
+                    memcpy(data, v.m_data, std::min((size_t)old_size_in_bytes, allocated_bytes));
+                    release_mapped(v.m_data);
+                    v.m_data = data;
+                } else {
+                    v.m_data = memory_manager::realloc_mem(v.m_data, allocated_bytes);
+                }
                 if (allocated_bytes != 0 && v.m_data == nullptr) {
                     throw std::bad_alloc();
                 }
@@ -368,7 +591,9 @@ class memory_manager
                 }
 
                 // update stats
-                if (do_realloc) {
+                if (mapped) {
+                    memory_monitor::record((int64_t)new_size_in_bytes);
+                } else if (do_realloc) {
                     memory_monitor::record((int64_t)new_size_in_bytes - (int64_t)old_size_in_bytes);
                 }
             }
@@ -377,6 +602,11 @@ class memory_manager
         static void clear(t_vec& v)
         {
             int64_t size_in_bytes = ((v.m_size + 63) >> 6) << 3;
+            // memory of mapped files is not counted by the memory_monitor
+            if (release_mapped(v.m_data)) {
+                v.m_data = nullptr;
+                return;
+            }
             // remove mem
             memory_manager::free_mem(v.m_data);
             v.m_data = nullptr;
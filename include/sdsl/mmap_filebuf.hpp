@@ -0,0 +1,72 @@
+/*!\file mmap_filebuf.hpp
+   \brief mmap_filebuf.hpp contains a stream buffer which reads from a memory mapped file.
+*/
+#ifndef INCLUDED_SDSL_MMAP_FILEBUF
+#define INCLUDED_SDSL_MMAP_FILEBUF
+
+#include <cstdint>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sdsl
+{
+
+//! Read-only stream buffer over a file mapped or read into memory.
+/*! int_vector::load recognizes this buffer and lets the vector point
+ *  into the mapping instead of copying the data to the heap. The
+ *  mapping is released when the buffer is closed and the last such
+ *  vector is destroyed or resized. When a buffer filled by read is
+ *  closed, the pages which no vector points to are returned to the
+ *  system. See load_from_mapped_file and load_from_file_parallel.
+ */
+class mmap_filebuf : public std::streambuf
+{
+    private:
+        uint8_t* m_base = nullptr;  // start of the mapping
+        uint64_t m_size = 0;        // size of the file in bytes
+        std::vector<std::pair<uint64_t, uint64_t>> m_shared; // byte ranges handed out by share
+
+        mmap_filebuf* set_region(uint8_t* base, uint64_t size);
+
+    public:
+        virtual ~mmap_filebuf();
+
+        mmap_filebuf();
+        mmap_filebuf(const mmap_filebuf&) = delete;
+        mmap_filebuf& operator=(const mmap_filebuf&) = delete;
+
+        //! Map the file copy-on-write.
+        mmap_filebuf*
+        open(const std::string& file);
+
+        //! Read the file with threads parallel readers into an anonymous mapping.
+        mmap_filebuf*
+        read(const std::string& file, uint64_t threads);
+
+        bool is_open() const;
+
+        mmap_filebuf*
+        close();
+
+        //! Hand out the next bytes of the get area to a new owner and skip them.
+        /*! \param bytes Number of bytes.
+         *  \return Pointer to the bytes or nullptr if fewer than bytes bytes are left
+         *          or the current position is not 8-byte aligned.
+         *  \par The caller has to release the returned memory with memory_manager::free_mem.
+         */
+        uint64_t* share(uint64_t bytes);
+
+        pos_type
+        seekpos(pos_type sp,
+                std::ios_base::openmode which = std::ios_base::in) override;
+
+        pos_type
+        seekoff(off_type off, std::ios_base::seekdir way,
+                std::ios_base::openmode which = std::ios_base::in) override;
+};
+
+}
+
+#endif
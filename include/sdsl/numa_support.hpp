@@ -0,0 +1,132 @@
+/*!\file numa_support.hpp
+   \brief numa_support.hpp contains helpers to place indexes and query threads on NUMA nodes.
+*/
+#ifndef INCLUDED_SDSL_NUMA_SUPPORT
+#define INCLUDED_SDSL_NUMA_SUPPORT
+
+#include "io.hpp"
+#include "memory_management.hpp"
+#include "numa_topology.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sdsl
+{
+
+//! One copy of a read-only structure per NUMA node.
+/*! Each copy is loaded by a thread which is pinned to the node and allocates
+ *  with the NUMA_NODE placement. So all int_vectors of a copy (e.g. the
+ *  bitvectors and rank supports of a wavelet tree) reside on the memory of
+ *  the node. Use the copy of the node a query thread runs on; the workers of
+ *  numa_thread_pool receive their node for that purpose.
+ *
+ *  To spread a single copy evenly over all nodes instead, call
+ *  memory_manager::set_numa_placement(NUMA_INTERLEAVE) before loading it.
+ */
+template<class t_index>
+class numa_replicas
+{
+    private:
+        std::vector<t_index> m_replica;
+    public:
+        //! Loads one copy of the serialized structure in file per node.
+        /*! Throws std::runtime_error if one of the copies could not be loaded.
+         */
+        explicit numa_replicas(const std::string& file) : m_replica(numa_topology::nodes())
+        {
+            std::vector<std::thread> loaders;
+            std::vector<char> loaded(m_replica.size(), 0);
+            for (uint32_t node=0; node < m_replica.size(); ++node) {
+                loaders.emplace_back([this, &file, &loaded, node]() {
+                    numa_topology::pin_thread(node);
+                    memory_manager::set_numa_placement(NUMA_NODE, node);
+                    loaded[node] = load_from_file(m_replica[node], file);
+                });
+            }
+            for (auto& t : loaders) {
+                t.join();
+            }
+            for (auto l : loaded) {
+                if (!l) {
+                    throw std::runtime_error("numa_replicas: could not load "+file);
+                }
+            }
+        }
+
+        //! Number of copies, i.e. number of nodes.
+        size_t size() const
+        {
+            return m_replica.size();
+        }
+
+        //! Copy which resides on a node.
+        const t_index& operator[](size_t node) const
+        {
+            return m_replica[node];
+        }
+
+        //! Copy which resides on the node of the calling thread.
+        const t_index& local() const
+        {
+            return m_replica[numa_topology::current_node() % m_replica.size()];
+        }
+};
+
+//! Thread pool whose workers are pinned to NUMA nodes.
+/*! Each node has its own task queue which is only served by the workers of
+ *  the node. A task is called with the node of the executing worker, so that
+ *  it can query the local copy of a numa_replicas object. The workers use the
+ *  NUMA_NODE placement for the int_vectors they allocate.
+ */
+class numa_thread_pool
+{
+    public:
+        typedef std::function<void(uint32_t)> task_type;
+    private:
+        struct node_queue {
+            std::mutex                                  mtx;
+            std::condition_variable                     cv;
+            std::deque<std::packaged_task<void(uint32_t)>> tasks;
+            size_t                                      pending = 0; // queued or running tasks
+            bool                                        stop = false;
+        };
+        std::vector<std::unique_ptr<node_queue>> m_queues;
+        std::vector<std::thread>                 m_workers;
+
+        void work(uint32_t node);
+    public:
+        //! Starts the workers.
+        /*! \param threads_per_node Number of workers per node. 0 means one worker per CPU of the node.
+         */
+        explicit numa_thread_pool(uint32_t threads_per_node=0);
+        //! Finishes all queued tasks and joins the workers.
+        ~numa_thread_pool();
+
+        numa_thread_pool(const numa_thread_pool&) = delete;
+        numa_thread_pool& operator=(const numa_thread_pool&) = delete;
+
+        //! Number of nodes served by the pool.
+        uint32_t nodes() const
+        {
+            return m_queues.size();
+        }
+
+        //! Enqueues a task for the workers of a node.
+        std::future<void> submit(uint32_t node, task_type task);
+
+        //! Enqueues a task for the node with the fewest pending tasks.
+        std::future<void> submit(task_type task);
+};
+
+} // end namespace sdsl
+
+#endif
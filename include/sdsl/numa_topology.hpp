@@ -0,0 +1,48 @@
+/*!\file numa_topology.hpp
+   \brief numa_topology.hpp contains the NUMA topology of the machine and the pinning of threads to nodes.
+*/
+#ifndef INCLUDED_SDSL_NUMA_TOPOLOGY
+#define INCLUDED_SDSL_NUMA_TOPOLOGY
+
+#include <cstdint>
+#include <vector>
+
+namespace sdsl
+{
+
+//! NUMA topology of the machine and pinning of threads to nodes.
+/*! On systems without NUMA information one node with all CPUs is reported.
+ */
+class numa_topology
+{
+    private:
+        std::vector<std::vector<uint32_t>> m_cpus; // cpus of each node
+
+        numa_topology();
+        static const numa_topology& the_topology()
+        {
+            static numa_topology t;
+            return t;
+        }
+    public:
+        //! Number of nodes.
+        static uint32_t nodes()
+        {
+            return the_topology().m_cpus.size();
+        }
+        //! CPUs of a node.
+        static const std::vector<uint32_t>& cpus(uint32_t node)
+        {
+            return the_topology().m_cpus[node];
+        }
+        //! Node of the CPU the calling thread currently runs on.
+        static uint32_t current_node();
+        //! Restricts the calling thread to the CPUs of a node.
+        /*! \return True if the affinity could be set.
+         */
+        static bool pin_thread(uint32_t node);
+};
+
+}
+
+#endif
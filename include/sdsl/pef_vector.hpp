@@ -0,0 +1,745 @@
+/*!\file pef_vector.hpp
+   \brief pef_vector.hpp contains the sdsl::pef_vector class, a partitioned
+          Elias-Fano bitvector, and classes which support rank and select for it.
+*/
+#ifndef INCLUDED_SDSL_PEF_VECTOR
+#define INCLUDED_SDSL_PEF_VECTOR
+
+#include "int_vector.hpp"
+#include "util.hpp"
+#include "iterators.hpp"
+
+#include <vector>
+
+//! Namespace for the succinct data structure library
+namespace sdsl
+{
+
+template<uint8_t t_b=1, uint32_t t_part=1024>// forward declaration needed for friend declaration
+class rank_support_pef;  // in pef_vector
+
+template<uint8_t t_b=1, uint32_t t_part=1024>// forward declaration needed for friend declaration
+class select_support_pef;  // in pef_vector
+
+//! A bit vector which stores the positions of the ones in a partitioned Elias-Fano representation.
+/*!
+ * The sequence of ones is split into partitions of at most t_part ones. A
+ * partition covers the positions from its first one up to the first one of
+ * the next partition and is encoded, relative to its first position, as
+ *   - a run (the ones form a prefix of the partition; no payload),
+ *   - a bitmap of the partition, or
+ *   - an Elias-Fano sequence (high part in unary, then the low parts),
+ * whichever is smallest. The partition boundaries are chosen at construction
+ * time by dynamic programming: the partitioning minimizes the total space,
+ * including the per partition header, among all partitionings whose
+ * boundaries are multiples of part_granularity ones.
+ *
+ * Clustered bitvectors (e.g. runs of marked positions separated by large
+ * gaps) are therefore encoded much smaller than by a single Elias-Fano
+ * sequence as in sdsl::sd_vector.
+ *
+ * The partition of a position or of a one is found by a binary search on
+ * the partition headers between two entries of a directory, which samples
+ * the position space and the ones at about one entry per partition.
+ * Queries then scan at most the payload of one partition.
+ *
+ * \tparam t_part Maximal number of ones in a partition; a multiple of part_granularity.
+ *
+ * \par Reference
+ *      G. Ottaviano, R. Venturini: Partitioned Elias-Fano Indexes. SIGIR 2014.
+ */
+template<uint32_t t_part=1024>
+class pef_vector
+{
+    public:
+        //! Partition boundaries are multiples of this number of ones.
+        static const uint32_t part_granularity = 16;
+        static_assert(t_part >= part_granularity and t_part % part_granularity == 0,
+                      "pef_vector: t_part must be a positive multiple of 16.");
+
+        typedef bit_vector::size_type                    size_type;
+        typedef size_type                                value_type;
+        typedef bit_vector::difference_type              difference_type;
+        typedef random_access_const_iterator<pef_vector> iterator;
+        typedef iterator                                 const_iterator;
+        typedef bv_tag                                   index_category;
+
+        friend class rank_support_pef<1,t_part>;
+        friend class rank_support_pef<0,t_part>;
+        friend class select_support_pef<1,t_part>;
+        friend class select_support_pef<0,t_part>;
+
+        typedef rank_support_pef<1,t_part>     rank_1_type;
+        typedef rank_support_pef<0,t_part>     rank_0_type;
+        typedef select_support_pef<1,t_part> select_1_type;
+        typedef select_support_pef<0,t_part> select_0_type;
+
+        //! Encodings of a partition
+        enum { ef_enc = 0, bitmap_enc = 1, run_enc = 2 };
+    private:
+        size_type      m_size = 0;      //!< Size of the original bitvector
+        size_type      m_ones = 0;      //!< Number of ones
+        int_vector<>   m_pos;           //!< First position of each partition; m_pos[P] = m_size
+        int_vector<>   m_rank;          //!< Number of ones before each partition; m_rank[P] = m_ones
+        int_vector<>   m_ptr;           //!< Word offset of the payload of each partition in m_data
+        int_vector<8>  m_info;          //!< Encoding (upper two bits) and low width (lower six bits)
+        int_vector<64> m_data;          //!< Payloads of the partitions, word aligned
+        int_vector<>   m_pos_dir;       //!< m_pos_dir[j]: number of partitions starting at or before j<<m_pos_shift
+        int_vector<>   m_rank_dir;      //!< m_rank_dir[j]: number of partitions with at most j<<m_rank_shift ones before them
+        uint8_t        m_pos_shift  = 0;
+        uint8_t        m_rank_shift = 0;
+
+        //! Number of partitions
+        size_type parts()const
+        {
+            return m_info.size();
+        }
+
+        //! Returns the encoding, the low width and the size in bits of the smallest
+        //! encoding of c ones in a universe of u positions; the last one is at last.
+        static size_type encoding(size_type u, size_type c, size_type last, uint8_t& enc, uint8_t& l)
+        {
+            l = 0;
+            if (last+1 == c) {
+                enc = run_enc;
+                return 0;
+            }
+            uint8_t ef_l = u > c ? bits::hi(u/c) : 0;
+            size_type ef_bits = c + ((u-1) >> ef_l) + 1 + c*ef_l;
+            if (u <= ef_bits) {
+                enc = bitmap_enc;
+                return ((u+63)>>6)<<6;
+            }
+            enc = ef_enc;
+            l = ef_l;
+            return ((ef_bits+63)>>6)<<6;
+        }
+
+        //! Number of bits of the unary high part of an Elias-Fano partition
+        static size_type high_bits(size_type u, size_type c, uint8_t l)
+        {
+            return c + ((u-1) >> l) + 1;
+        }
+
+        //! Position of the (k+1)-th one in the words starting at w
+        static size_type scan_select_1(const uint64_t* w, size_type k)
+        {
+            size_type off = 0, cnt;
+            while ((cnt = bits::cnt(*w)) <= k) {
+                k -= cnt;
+                ++w;
+                off += 64;
+            }
+            return off + bits::sel(*w, k+1);
+        }
+
+        //! Position of the (k+1)-th zero in the words starting at w
+        static size_type scan_select_0(const uint64_t* w, size_type k)
+        {
+            size_type off = 0, cnt;
+            while ((cnt = bits::cnt(~*w)) <= k) {
+                k -= cnt;
+                ++w;
+                off += 64;
+            }
+            return off + bits::sel(~*w, k+1);
+        }
+
+        //! Number of entries e in [0..n-1] of the sorted keys with key[e] <= x; lb and rb bound the result.
+        static size_type upper_bound(const int_vector<>& key, size_type lb, size_type rb, size_type x)
+        {
+            while (lb < rb) {
+                size_type mid = lb + (rb-lb+1)/2;
+                if (key[mid-1] <= x) {
+                    lb = mid;
+                } else {
+                    rb = mid-1;
+                }
+            }
+            return lb;
+        }
+
+        //! Number of partitions which start at or before position i, i < m_size
+        size_type parts_before_pos(size_type i)const
+        {
+            size_type j = i >> m_pos_shift;
+            return upper_bound(m_pos, m_pos_dir[j], m_pos_dir[j+1], i);
+        }
+
+        //! Number of partitions with at most k ones before them, k < m_ones
+        size_type parts_before_rank(size_type k)const
+        {
+            size_type j = k >> m_rank_shift;
+            return upper_bound(m_rank, m_rank_dir[j], m_rank_dir[j+1], k);
+        }
+
+        //! Local parameters of partition p
+        struct part {
+            size_type u;       // universe
+            size_type c;       // ones
+            uint8_t   enc;     // encoding
+            uint8_t   l;       // low width of ef_enc
+            const uint64_t* w; // payload
+        };
+
+        part get_part(size_type p)const
+        {
+            part q;
+            q.u   = m_pos[p+1] - m_pos[p];
+            q.c   = m_rank[p+1] - m_rank[p];
+            q.enc = m_info[p] >> 6;
+            q.l   = m_info[p] & 0x3F;
+            q.w   = m_data.data() + m_ptr[p];
+            return q;
+        }
+
+        //! Low part of the e-th one of an Elias-Fano partition
+        static uint64_t low(const part& q, size_type e)
+        {
+            if (q.l == 0) {
+                return 0;
+            }
+            size_type idx = high_bits(q.u, q.c, q.l) + e*q.l;
+            uint64_t res = q.w[idx>>6] >> (idx&63);
+            if ((idx&63) + q.l > 64) {
+                res |= q.w[(idx>>6)+1] << (64-(idx&63));
+            }
+            return res & bits::lo_set[q.l];
+        }
+
+        static bool bit(const uint64_t* w, size_type i)
+        {
+            return (w[i>>6] >> (i&63)) & 1ULL;
+        }
+
+        //! Number of ones before local position x, x <= u
+        static size_type local_rank(const part& q, size_type x)
+        {
+            if (x >= q.u) {
+                return q.c;
+            }
+            switch (q.enc) {
+                case run_enc:
+                    return std::min(x, q.c);
+                case bitmap_enc:
+                    return bits::cnt(q.w, x>>6) + ((x&63) ? bits::cnt(q.w[x>>6] & bits::lo_set[x&63]) : 0);
+                default: {
+                        size_type h = x >> q.l;
+                        // start of bucket h in the high part
+                        size_type j = h ? scan_select_0(q.w, h-1) + 1 : 0;
+                        size_type e = j - h;
+                        uint64_t x_low = x & bits::lo_set[q.l];
+                        while (e < q.c and bit(q.w, j) and low(q, e) < x_low) {
+                            ++j; ++e;
+                        }
+                        return e;
+                    }
+            }
+        }
+
+        //! Local position of the (k+1)-th one, k < c
+        static size_type local_select_1(const part& q, size_type k)
+        {
+            switch (q.enc) {
+                case run_enc:
+                    return k;
+                case bitmap_enc:
+                    return scan_select_1(q.w, k);
+                default:
+                    return ((scan_select_1(q.w, k) - k) << q.l) | low(q, k);
+            }
+        }
+
+        //! Local position of the (k+1)-th zero, k < u-c
+        static size_type local_select_0(const part& q, size_type k)
+        {
+            switch (q.enc) {
+                case run_enc:
+                    return q.c + k;
+                case bitmap_enc:
+                    return scan_select_0(q.w, k);
+                default: {
+                        // number r of ones before the zero: the ones e with
+                        // local_select_1(e)-e <= k
+                        size_type lb = 0, rb = q.c;
+                        while (lb < rb) {
+                            size_type mid = lb + (rb-lb+1)/2;
+                            if (local_select_1(q, mid-1) - (mid-1) <= k) {
+                                lb = mid;
+                            } else {
+                                rb = mid-1;
+                            }
+                        }
+                        return k + lb;
+                    }
+            }
+        }
+
+        //! Bit at local position x, x < u
+        static bool local_access(const part& q, size_type x)
+        {
+            switch (q.enc) {
+                case run_enc:
+                    return x < q.c;
+                case bitmap_enc:
+                    return bit(q.w, x);
+                default: {
+                        size_type h = x >> q.l;
+                        size_type j = h ? scan_select_0(q.w, h-1) + 1 : 0;
+                        size_type e = j - h;
+                        uint64_t x_low = x & bits::lo_set[q.l];
+                        while (e < q.c and bit(q.w, j)) {
+                            uint64_t v = low(q, e);
+                            if (v >= x_low) {
+                                return v == x_low;
+                            }
+                            ++j; ++e;
+                        }
+                        return false;
+                    }
+            }
+        }
+
+        //! Bits of partition q, which starts at position base, in [idx..end-1] shifted by idx; end-idx <= 64
+        static uint64_t local_get_int(const part& q, size_type base, size_type idx, size_type end)
+        {
+            size_type lo = idx > base ? idx-base : 0;         // local range [lo..hi-1]
+            size_type hi = std::min(end-base, q.u);
+            if (lo >= hi) {
+                return 0;
+            }
+            uint8_t shift = base+lo-idx;
+            switch (q.enc) {
+                case run_enc: {
+                        size_type run_end = std::min(hi, q.c);
+                        return lo < run_end ? bits::lo_set[run_end-lo] << shift : 0;
+                    }
+                case bitmap_enc:
+                    return bits::read_int(q.w + (lo>>6), lo&63, hi-lo) << shift;
+                default: {
+                        // walk the ones of the high part from bucket lo>>l on
+                        size_type h = lo >> q.l;
+                        size_type j = h ? scan_select_0(q.w, h-1) + 1 : 0;
+                        size_type e = j - h;
+                        const uint64_t* w = q.w + (j>>6);
+                        uint64_t word = *w & bits::lo_unset[j&63];
+                        uint64_t res = 0;
+                        for (; e < q.c; ++e) {
+                            while (word == 0) {
+                                word = *(++w);
+                            }
+                            size_type v = (((w - q.w)*64 + bits::lo(word) - e) << q.l) | low(q, e);
+                            if (v >= hi) {
+                                break;
+                            }
+                            if (v >= lo) {
+                                res |= 1ULL << (v-lo);
+                            }
+                            word &= word-1;
+                        }
+                        return res << shift;
+                    }
+            }
+        }
+
+        //! Number of ones in [0..i-1], i <= m_size
+        size_type rank_1(size_type i)const
+        {
+            if (i == 0 or m_ones == 0) {
+                return 0;
+            }
+            size_type p = parts_before_pos(i-1);
+            if (p == 0) {
+                return 0;
+            }
+            --p;
+            return m_rank[p] + local_rank(get_part(p), i - m_pos[p]);
+        }
+
+        //! Position of the i-th one, i in [1..m_ones]
+        size_type select_1(size_type i)const
+        {
+            size_type p = parts_before_rank(i-1) - 1;
+            return m_pos[p] + local_select_1(get_part(p), i-1-m_rank[p]);
+        }
+
+        //! Position of the i-th zero, i in [1..m_size-m_ones]
+        size_type select_0(size_type i)const
+        {
+            size_type k = i-1;
+            if (parts() == 0 or k < m_pos[0]) {
+                return k;
+            }
+            // last partition p with m_pos[p]-m_rank[p] <= k
+            size_type lb = 1, rb = parts();
+            while (lb < rb) {
+                size_type mid = lb + (rb-lb+1)/2;
+                if (m_pos[mid-1] - m_rank[mid-1] <= k) {
+                    lb = mid;
+                } else {
+                    rb = mid-1;
+                }
+            }
+            size_type p = lb-1;
+            return m_pos[p] + local_select_0(get_part(p), k - (m_pos[p] - m_rank[p]));
+        }
+
+        //! Directory entries dir[j] = number of keys <= j<<shift, for j in [0..(n>>shift)+1]
+        static void build_dir(const int_vector<>& key, size_type k, size_type n, uint8_t& shift, int_vector<>& dir)
+        {
+            shift = n/std::max(k, (size_type)1) ? bits::hi(n/std::max(k, (size_type)1)) : 0;
+            size_type entries = (n >> shift) + 2;
+            dir = int_vector<>(entries, 0, bits::hi(k)+1);
+            size_type e = 0;
+            for (size_type j=0; j < entries; ++j) {
+                while (e < k and key[e] <= (j << shift)) {
+                    ++e;
+                }
+                dir[j] = e;
+            }
+        }
+
+    public:
+        pef_vector() {}
+
+        pef_vector(const bit_vector& bv)
+        {
+            m_size = bv.size();
+            m_ones = util::cnt_one_bits(bv);
+            const size_type m = m_ones;
+            const uint8_t pos_width = bits::hi(m_size)+1;
+            // (1) positions of the ones
+            int_vector<> x(m, 0, pos_width);
+            const uint64_t* bvp = bv.data();
+            for (size_type w=0, e=0; e < m; ++w) {
+                uint64_t word = bvp[w];
+                while (word and e < m) {
+                    x[e++] = 64*w + bits::lo(word);
+                    word &= word-1;
+                }
+            }
+            // (2) optimal partitioning on granule boundaries:
+            //     cost[b] = minimal size of the ones before granule b
+            const size_type g = part_granularity;
+            const size_type granules = (m+g-1)/g;
+            const size_type header = 2*pos_width + (bits::hi(m_size/64+1)+1) + 8 + 2*(bits::hi(granules+1)+1);
+            std::vector<size_type> cost(granules+1, 0), from(granules+1, 0);
+            uint8_t enc, l;
+            for (size_type b=1; b <= granules; ++b) {
+                size_type end_one = std::min(b*g, m);
+                size_type end_pos = end_one < m ? (size_type)x[end_one] : m_size;
+                cost[b] = (size_type)-1;
+                for (size_type a = b > t_part/g ? b - t_part/g : 0; a < b; ++a) {
+                    size_type start = x[a*g];
+                    size_type c = end_one - a*g;
+                    size_type s = cost[a] + header + encoding(end_pos-start, c, x[end_one-1]-start, enc, l);
+                    if (s < cost[b]) {
+                        cost[b] = s;
+                        from[b] = a;
+                    }
+                }
+            }
+            std::vector<size_type> bounds; // granule boundaries of the partitions
+            for (size_type b = granules; b > 0; b = from[b]) {
+                bounds.push_back(b);
+            }
+            bounds.push_back(0);
+            std::reverse(bounds.begin(), bounds.end());
+            // (3) headers and payloads
+            const size_type P = bounds.size()-1;
+            m_pos  = int_vector<>(P+1, 0, pos_width);
+            m_rank = int_vector<>(P+1, 0, bits::hi(m)+1);
+            m_info = int_vector<8>(P, 0);
+            std::vector<size_type> ptr(P+1, 0);
+            for (size_type p=0; p < P; ++p) {
+                size_type a = bounds[p]*g, b = std::min(bounds[p+1]*g, m);
+                m_pos[p]  = x[a];
+                m_rank[p] = a;
+                size_type end_pos = b < m ? (size_type)x[b] : m_size;
+                size_type len = encoding(end_pos-x[a], b-a, x[b-1]-x[a], enc, l);
+                m_info[p] = (enc << 6) | l;
+                ptr[p+1] = ptr[p] + (len>>6);
+            }
+            m_pos[P]  = m_size;
+            m_rank[P] = m;
+            m_ptr = int_vector<>(P+1, 0, bits::hi(ptr[P])+1);
+            std::copy(ptr.begin(), ptr.end(), m_ptr.begin());
+            m_data = int_vector<64>(ptr[P]+1, 0); // one extra word for the scans
+            for (size_type p=0; p < P; ++p) {
+                part q = get_part(p);
+                uint64_t* w = m_data.data() + ptr[p];
+                for (size_type e=0; e < q.c; ++e) {
+                    size_type v = x[m_rank[p]+e] - m_pos[p];
+                    if (q.enc == bitmap_enc) {
+                        w[v>>6] |= 1ULL << (v&63);
+                    } else if (q.enc == ef_enc) {
+                        size_type h = (v >> q.l) + e;
+                        w[h>>6] |= 1ULL << (h&63);
+                        if (q.l > 0) {
+                            size_type idx = high_bits(q.u, q.c, q.l) + e*q.l;
+                            uint64_t lo = v & bits::lo_set[q.l];
+                            w[idx>>6] |= lo << (idx&63);
+                            if ((idx&63) + q.l > 64) {
+                                w[(idx>>6)+1] |= lo >> (64-(idx&63));
+                            }
+                        }
+                    }
+                }
+            }
+            build_dir(m_pos, P, m_size, m_pos_shift, m_pos_dir);
+            build_dir(m_rank, P, m, m_rank_shift, m_rank_dir);
+        }
+
+        //! Accessing the i-th element of the original bit_vector
+        /*! \param i An index i with \f$ 0 \leq i < size()  \f$.
+         *  \return The i-th bit of the original bit_vector
+         */
+        value_type operator[](size_type i)const
+        {
+            assert(i < m_size);
+            if (m_ones == 0) {
+                return 0;
+            }
+            size_type p = parts_before_pos(i);
+            if (p == 0) {
+                return 0;
+            }
+            --p;
+            return local_access(get_part(p), i - m_pos[p]);
+        }
+
+        //! Get the integer value of the binary string of length len starting at position idx.
+        /*! \param idx Starting index of the binary representation of the integer.
+         *  \param len Length of the binary representation of the integer. Default value is 64.
+         *   \returns The integer value of the binary string of length len starting at position idx.
+         *
+         *  \pre idx+len-1 in [0..size()-1]
+         *  \pre len in [1..64]
+         */
+        uint64_t get_int(size_type idx, uint8_t len=64)const
+        {
+            assert(idx+len-1 < m_size);
+            if (m_ones == 0) {
+                return 0;
+            }
+            const size_type end = idx+len;
+            uint64_t res = 0;
+            size_type p = parts_before_pos(idx);
+            for (p = p ? p-1 : 0; p < parts() and m_pos[p] < end; ++p) {
+                res |= local_get_int(get_part(p), m_pos[p], idx, end);
+            }
+            return res;
+        }
+
+        //! Returns the size of the original bit vector.
+        size_type size()const
+        {
+            return m_size;
+        }
+
+        //! Serializes the data structure into the given ostream
+        size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const
+        {
+            structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
+            size_type written_bytes = 0;
+            written_bytes += write_member(m_size, out, child, "size");
+            written_bytes += write_member(m_ones, out, child, "ones");
+            written_bytes += m_pos.serialize(out, child, "pos");
+            written_bytes += m_rank.serialize(out, child, "rank");
+            written_bytes += m_ptr.serialize(out, child, "ptr");
+            written_bytes += m_info.serialize(out, child, "info");
+            written_bytes += m_data.serialize(out, child, "data");
+            written_bytes += m_pos_dir.serialize(out, child, "pos_dir");
+            written_bytes += m_rank_dir.serialize(out, child, "rank_dir");
+            written_bytes += write_member(m_pos_shift, out, child, "pos_shift");
+            written_bytes += write_member(m_rank_shift, out, child, "rank_shift");
+            structure_tree::add_size(child, written_bytes);
+            return written_bytes;
+        }
+
+        //! Loads the data structure from the given istream.
+        void load(std::istream& in)
+        {
+            read_member(m_size, in);
+            read_member(m_ones, in);
+            m_pos.load(in);
+            m_rank.load(in);
+            m_ptr.load(in);
+            m_info.load(in);
+            m_data.load(in);
+            m_pos_dir.load(in);
+            m_rank_dir.load(in);
+            read_member(m_pos_shift, in);
+            read_member(m_rank_shift, in);
+        }
+
+        void swap(pef_vector& bv)
+        {
+            if (this != &bv) {
+                std::swap(m_size, bv.m_size);
+                std::swap(m_ones, bv.m_ones);
+                m_pos.swap(bv.m_pos);
+                m_rank.swap(bv.m_rank);
+                m_ptr.swap(bv.m_ptr);
+                m_info.swap(bv.m_info);
+                m_data.swap(bv.m_data);
+                m_pos_dir.swap(bv.m_pos_dir);
+                m_rank_dir.swap(bv.m_rank_dir);
+                std::swap(m_pos_shift, bv.m_pos_shift);
+                std::swap(m_rank_shift, bv.m_rank_shift);
+            }
+        }
+
+        iterator begin() const
+        {
+            return iterator(this, 0);
+        }
+
+        iterator end() const
+        {
+            return iterator(this, size());
+        }
+};
+
+template<uint8_t t_b, uint32_t t_part>
+class rank_support_pef
+{
+        static_assert(t_b == 1 or t_b == 0 , "rank_support_pef only supports bitpatterns 0 or 1.");
+    public:
+        typedef bit_vector::size_type size_type;
+        typedef pef_vector<t_part>    bit_vector_type;
+        enum { bit_pat = t_b };
+        enum { bit_pat_len = (uint8_t)1 };
+    private:
+        const bit_vector_type* m_v;
+
+    public:
+
+        rank_support_pef(const bit_vector_type* v=nullptr)
+        {
+            set_vector(v);
+        }
+
+        //! Returns the number of occurrences of the bit pattern in [0..i-1].
+        size_type rank(size_type i) const
+        {
+            if (t_b) return m_v->rank_1(i);
+            return i - m_v->rank_1(i);
+        }
+
+        size_type operator()(size_type i)const
+        {
+            return rank(i);
+        }
+
+        //! Answers n independent rank queries: out[j] = rank(idx[j]) for \f$j\in[0..n-1]\f$.
+        void rank_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            for (size_type j=0; j < n; ++j) {
+                out[j] = rank(idx[j]);
+            }
+        }
+
+        size_type size()const
+        {
+            return m_v->size();
+        }
+
+        void set_vector(const bit_vector_type* v=nullptr)
+        {
+            m_v = v;
+        }
+
+        rank_support_pef& operator=(const rank_support_pef& rs)
+        {
+            if (this != &rs) {
+                set_vector(rs.m_v);
+            }
+            return *this;
+        }
+
+        void swap(rank_support_pef&) { }
+
+        void load(std::istream&, const bit_vector_type* v=nullptr)
+        {
+            set_vector(v);
+        }
+
+        size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const
+        {
+            return serialize_empty_object(out, v, name, this);
+        }
+};
+
+template<uint8_t t_b, uint32_t t_part>
+class select_support_pef
+{
+        static_assert(t_b == 1 or t_b == 0 , "select_support_pef only supports bitpatterns 0 or 1.");
+    public:
+        typedef bit_vector::size_type size_type;
+        typedef pef_vector<t_part>    bit_vector_type;
+        enum { bit_pat = t_b };
+        enum { bit_pat_len = (uint8_t)1 };
+    private:
+        const bit_vector_type* m_v;
+
+    public:
+
+        select_support_pef(const bit_vector_type* v=nullptr)
+        {
+            set_vector(v);
+        }
+
+        //! Returns the position of the i-th occurrence in the bit vector.
+        size_type select(size_type i) const
+        {
+            if (t_b) return m_v->select_1(i);
+            return m_v->select_0(i);
+        }
+
+        size_type operator()(size_type i)const
+        {
+            return select(i);
+        }
+
+        //! Answers n independent select queries: out[j] = select(idx[j]) for \f$j\in[0..n-1]\f$.
+        void select_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            for (size_type j=0; j < n; ++j) {
+                out[j] = select(idx[j]);
+            }
+        }
+
+        size_type size()const
+        {
+            return m_v->size();
+        }
+
+        void set_vector(const bit_vector_type* v=nullptr)
+        {
+            m_v = v;
+        }
+
+        select_support_pef& operator=(const select_support_pef& rs)
+        {
+            if (this != &rs) {
+                set_vector(rs.m_v);
+            }
+            return *this;
+        }
+
+        void swap(select_support_pef&) { }
+
+        void load(std::istream&, const bit_vector_type* v=nullptr)
+        {
+            set_vector(v);
+        }
+
+        size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const
+        {
+            return serialize_empty_object(out, v, name, this);
+        }
+};
+
+} // end namespace sdsl
+#endif
@@ -0,0 +1,146 @@
+/*!\file query_context.hpp
+   \brief query_context.hpp contains an arena for the scratch memory of queries.
+
+   The query methods which take a query_context place their temporary
+   containers (stacks, queues, level arrays) in the arena of the context and
+   reset it at the start of each query. After the first queries the arena
+   is large enough and the queries do not allocate. Results are written to
+   containers supplied by the caller, which keep their capacity between
+   queries. A context must not be used by two threads at the same time.
+*/
+#ifndef INCLUDED_SDSL_QUERY_CONTEXT
+#define INCLUDED_SDSL_QUERY_CONTEXT
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace sdsl
+{
+
+//! Arena for the scratch memory of queries.
+/*! Memory is handed out by bumping a pointer in the current block. If the
+ *  block is full a new, larger block is added. reset() frees all memory at
+ *  once and merges the blocks into one, so that the next query of the same
+ *  size is served from a single block without allocating.
+ */
+class query_context
+{
+    private:
+        std::vector<std::unique_ptr<uint8_t[]>> m_blocks;
+        std::vector<size_t>                     m_block_sizes;
+        size_t                                  m_pos = 0; // position in the last block
+        size_t                                  m_allocations = 0;
+
+        void add_block(size_t bytes)
+        {
+            m_blocks.emplace_back(new uint8_t[bytes]);
+            m_block_sizes.push_back(bytes);
+            m_pos = 0;
+            ++m_allocations;
+        }
+
+    public:
+        //! Initial block size in bytes.
+        static const size_t min_block_size = 1ULL<<16;
+
+        query_context() = default;
+        query_context(const query_context&) = delete;
+        query_context& operator=(const query_context&) = delete;
+        query_context(query_context&&) = default;
+        query_context& operator=(query_context&&) = default;
+
+        //! Returns bytes bytes aligned to align from the arena.
+        void* allocate(size_t bytes, size_t align)
+        {
+            if (!m_blocks.empty()) {
+                size_t pos = (m_pos + align - 1) & ~(align - 1);
+                if (pos + bytes <= m_block_sizes.back()) {
+                    m_pos = pos + bytes;
+                    return m_blocks.back().get() + pos;
+                }
+            }
+            size_t size = std::max(min_block_size, bytes + align);
+            if (!m_block_sizes.empty()) {
+                size = std::max(size, 2*m_block_sizes.back());
+            }
+            add_block(size);
+            return allocate(bytes, align);
+        }
+
+        //! Releases all memory handed out since the last reset.
+        void reset()
+        {
+            if (m_blocks.size() > 1) {
+                size_t total = 0;
+                for (size_t s : m_block_sizes) {
+                    total += s;
+                }
+                m_blocks.clear();
+                m_block_sizes.clear();
+                add_block(total);
+            }
+            m_pos = 0;
+        }
+
+        //! Size of the arena in bytes.
+        size_t capacity()const
+        {
+            size_t total = 0;
+            for (size_t s : m_block_sizes) {
+                total += s;
+            }
+            return total;
+        }
+
+        //! Number of blocks allocated from the heap so far.
+        size_t allocations()const
+        {
+            return m_allocations;
+        }
+};
+
+//! Allocator which takes its memory from a query_context.
+/*! deallocate is a no-op; the memory is released by query_context::reset.
+ */
+template<class T>
+class arena_allocator
+{
+    public:
+        typedef T value_type;
+
+        query_context* m_ctx;
+
+        explicit arena_allocator(query_context& ctx) : m_ctx(&ctx) {}
+        template<class U>
+        arena_allocator(const arena_allocator<U>& a) : m_ctx(a.m_ctx) {}
+
+        T* allocate(size_t n)
+        {
+            return static_cast<T*>(m_ctx->allocate(n*sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*, size_t) {}
+
+        template<class U>
+        bool operator==(const arena_allocator<U>& a)const
+        {
+            return m_ctx == a.m_ctx;
+        }
+        template<class U>
+        bool operator!=(const arena_allocator<U>& a)const
+        {
+            return m_ctx != a.m_ctx;
+        }
+};
+
+//! A std::vector which lives in the arena of a query_context.
+template<class T>
+using arena_vector = std::vector<T, arena_allocator<T>>;
+
+} // end namespace sdsl
+
+#endif
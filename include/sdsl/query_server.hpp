@@ -0,0 +1,517 @@
+/*!\file query_server.hpp
+   \brief query_server.hpp contains a server which answers queries on an index over a Unix domain socket.
+
+   One process loads an index (a CSA or a CST) and serves count, locate,
+   extract and k-mismatch queries to local clients. Requests are framed
+   binary messages (see query_protocol). The reader of a connection collects
+   all requests which have already arrived into a batch, which is answered by
+   a worker of the thread pool; the responses of a batch are collected and
+   written back in chunks of about write_chunk bytes. Responses carry the id of their request and may
+   arrive out of order, so clients can pipeline requests. A reader stops
+   reading while its connection has too many unanswered batches, and a
+   connection whose client does not read its responses is closed after a
+   send timeout, so it cannot block the workers.
+*/
+#ifndef INCLUDED_SDSL_QUERY_SERVER
+#define INCLUDED_SDSL_QUERY_SERVER
+
+#include "sdsl_concepts.hpp"
+#include "suffix_arrays.hpp"
+#include "numa_support.hpp"
+#include "util.hpp"
+
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sdsl
+{
+
+//! Binary protocol of the query_server.
+/*! All integers are little endian. A message is a frame
+ *  `uint32 length | payload[length]`.
+ *
+ *  Request payload:  `uint32 id | uint8 op | arguments`
+ *    - COUNT, LOCATE:  `uint32 m | pattern[m]`
+ *    - EXTRACT:        `uint64 begin | uint64 end` (inclusive)
+ *    - K_MISMATCH:     `uint8 k | uint32 m | pattern[m]`
+ *
+ *  Response payload: `uint32 id | uint8 status | result`
+ *    - COUNT:                 `uint64 count`
+ *    - LOCATE, K_MISMATCH:    `uint64 n | uint64 positions[n]`
+ *    - EXTRACT:               `uint32 m | text[m]`
+ *    - status ERROR:          `uint32 m | message[m]`
+ */
+namespace query_protocol
+{
+
+enum op_type : uint8_t {COUNT = 1, LOCATE = 2, EXTRACT = 3, K_MISMATCH = 4};
+enum status_type : uint8_t {OK = 0, ERROR = 1};
+
+//! Maximal payload size of a frame
+const uint32_t max_frame_size = 1U<<30;
+
+struct request {
+    uint32_t    id    = 0;
+    uint8_t     op    = COUNT;
+    uint8_t     k     = 0;     // K_MISMATCH: maximal number of mismatches
+    uint64_t    begin = 0;     // EXTRACT
+    uint64_t    end   = 0;     // EXTRACT
+    std::string pattern;       // COUNT, LOCATE, K_MISMATCH
+};
+
+struct response {
+    uint32_t              id     = 0;
+    uint8_t               op     = COUNT; // not transmitted; set by the client
+    uint8_t               status = OK;
+    uint64_t              count  = 0;     // COUNT
+    std::vector<uint64_t> positions;      // LOCATE, K_MISMATCH
+    std::string           text;           // EXTRACT, or the message of an ERROR
+};
+
+//! Appends the frame of a request to buf.
+void encode(const request& req, std::string& buf);
+//! Appends the frame of a response to the request of type op to buf.
+void encode(const response& res, std::string& buf);
+//! Decodes a request payload. Returns false if the payload is malformed.
+bool decode(const char* payload, uint32_t size, request& req);
+//! Decodes a response payload to a request of type op.
+bool decode(const char* payload, uint32_t size, uint8_t op, response& res);
+
+} // end namespace query_protocol
+
+//! Reads and writes frames on a connected socket.
+class frame_stream
+{
+    private:
+        int         m_fd = -1;
+        std::string m_in;      // received bytes
+        size_t      m_pos = 0; // begin of the first unprocessed frame in m_in
+        std::mutex  m_write_mtx;
+    public:
+        explicit frame_stream(int fd) : m_fd(fd) {}
+        ~frame_stream();
+        frame_stream(const frame_stream&) = delete;
+        frame_stream& operator=(const frame_stream&) = delete;
+
+        int fd() const
+        {
+            return m_fd;
+        }
+        //! Returns the next frame if it was already received completely.
+        bool buffered_frame(const char*& payload, uint32_t& size);
+        //! Blocks until more data arrived. Returns false at the end of the stream.
+        bool receive();
+        //! Writes buf completely; thread-safe.
+        void write(const std::string& buf);
+        //! Stops reading, e.g. to wake up a blocked receive().
+        void shutdown_read();
+        //! Stops reading and writing; blocked receive() and write() calls return or fail.
+        void shutdown();
+        //! A write() which cannot send any data for ms milliseconds fails; 0 waits forever.
+        void set_send_timeout(uint32_t ms);
+};
+
+//! Creates a listening Unix domain socket; an existing socket file is replaced.
+int listen_unix_socket(const std::string& path);
+//! Connects to a Unix domain socket.
+int connect_unix_socket(const std::string& path);
+//! Accepts the next connection on a listening socket; returns -1 after shutdown_listen_socket.
+int accept_connection(int listen_fd);
+//! Wakes up a blocked accept_connection; no further connections are accepted.
+void shutdown_listen_socket(int fd);
+//! Closes a listening socket and removes the socket file.
+void close_listen_socket(int fd, const std::string& path);
+
+//! Client of a query_server.
+/*! The blocking methods send a single request and wait for its response.
+ *  send() and receive() allow to pipeline many requests on the connection.
+ */
+class query_client
+{
+    private:
+        std::unique_ptr<frame_stream> m_stream;
+        uint32_t                      m_next_id = 0;
+        std::vector<std::pair<uint32_t, uint8_t>> m_pending; // (id, op) of sent requests
+        std::string                   m_out;
+
+        query_protocol::response call(query_protocol::request& req);
+    public:
+        explicit query_client(const std::string& socket_path);
+
+        //! Sends a request and returns its id.
+        uint32_t send(query_protocol::request req);
+        //! Receives the next response of a sent request.
+        query_protocol::response receive();
+
+        uint64_t count(const std::string& pattern);
+        std::vector<uint64_t> locate(const std::string& pattern);
+        std::string extract(uint64_t begin, uint64_t end);
+        std::vector<uint64_t> k_mismatch(const std::string& pattern, uint8_t k);
+};
+
+//! Calculates the SA intervals of all strings with at most k mismatches to a pattern.
+/*! Backtracking on backward search; each position of the pattern branches on all
+ *  symbols of the alphabet.
+ *  \param csa       The CSA object.
+ *  \param begin     Iterator to the begin of the pattern (inclusive).
+ *  \param end       Iterator to the end of the pattern (exclusive).
+ *  \param k         Maximal number of mismatches.
+ *  \param intervals Holds the disjoint SA intervals [l..r] after the call.
+ */
+template<class t_csa, class t_pat_iter>
+void k_mismatch_search(const t_csa& csa, t_pat_iter begin, t_pat_iter end, uint8_t k,
+                       std::vector<std::array<typename t_csa::size_type, 2>>& intervals)
+{
+    typedef typename t_csa::size_type size_type;
+    intervals.clear();
+    if (begin == end or (size_type)(end-begin) > csa.size()) {
+        return;
+    }
+    struct entry {
+        size_type l, r;
+        t_pat_iter it;  // the pattern [it..end) is matched
+        uint8_t errors;
+    };
+    std::vector<entry> stack;
+    stack.push_back({0, csa.size()-1, end, 0});
+    while (!stack.empty()) {
+        entry e = stack.back();
+        stack.pop_back();
+        if (e.it == begin) {
+            intervals.push_back({{e.l, e.r}});
+            continue;
+        }
+        uint8_t c = *(e.it-1);
+        for (size_type cc=1; cc < csa.sigma; ++cc) { // skip the sentinel
+            typename t_csa::char_type sym = csa.comp2char[cc];
+            uint8_t errors = e.errors + (sym != c);
+            if (errors > k) {
+                continue;
+            }
+            size_type l, r;
+            if (backward_search(csa, e.l, e.r, sym, l, r) > 0) {
+                stack.push_back({l, r, e.it-1, errors});
+            }
+        }
+    }
+}
+
+//! Serves queries on an index over a Unix domain socket.
+/*! \tparam t_index A CSA or CST type.
+ */
+template<class t_index>
+class query_server
+{
+    private:
+        typedef typename t_index::size_type size_type;
+
+        //! Responses of a batch are written as soon as this many bytes are encoded
+        static const size_t write_chunk = 1<<16;
+
+        struct reader_thread {
+            std::thread                        thread;
+            std::shared_ptr<std::atomic<bool>> done;
+        };
+        // Batches of a connection which are queued or being answered
+        struct pending_batches {
+            std::mutex              mtx;
+            std::condition_variable cv;
+            size_t                  n = 0;
+        };
+
+        const t_index&    m_index;
+        std::string       m_path;
+        size_t            m_max_batch;
+        size_t            m_max_pending;
+        uint32_t          m_send_timeout;
+        numa_thread_pool  m_pool;
+        int               m_listen_fd = -1;
+        std::atomic<bool> m_stop;
+        std::mutex        m_conn_mtx;
+        std::vector<std::weak_ptr<frame_stream>> m_connections;
+        std::vector<reader_thread> m_readers;
+        std::atomic<uint64_t> m_batches;
+        std::atomic<uint64_t> m_requests;
+
+        template<class t_x>
+        static const t_x& csa_of(const t_x& csa, csa_tag)
+        {
+            return csa;
+        }
+        template<class t_x>
+        static const typename t_x::csa_type& csa_of(const t_x& cst, cst_tag)
+        {
+            return cst.csa;
+        }
+
+        void answer(const query_protocol::request& req, query_protocol::response& res) const
+        {
+            using namespace query_protocol;
+            const auto& csa = csa_of(m_index, typename t_index::index_category());
+            // Results which do not fit into a frame are answered with an error
+            const uint64_t max_positions = (max_frame_size-13)/8;
+            const uint64_t max_text = max_frame_size-9;
+            res = response();
+            res.id = req.id;
+            res.op = req.op;
+            switch (req.op) {
+                case COUNT:
+                    res.count = count(csa, req.pattern.begin(), req.pattern.end());
+                    break;
+                case LOCATE: {
+                    size_type l = 0, r = 0;
+                    uint64_t occ = backward_search(csa, 0, csa.size()-1,
+                                                   req.pattern.begin(), req.pattern.end(), l, r);
+                    if (occ > max_positions) {
+                        res.status = ERROR;
+                        res.text = "result too large";
+                        break;
+                    }
+                    res.positions.resize(occ);
+                    for (uint64_t i=0; i < occ; ++i) {
+                        res.positions[i] = csa[l+i];
+                    }
+                    break;
+                }
+                case EXTRACT:
+                    // the last position of the CSA holds the sentinel, which is not part of the text
+                    if (req.begin > req.end or req.end >= csa.size()-1) {
+                        res.status = ERROR;
+                        res.text = "invalid range";
+                    } else if (req.end-req.begin >= max_text) {
+                        res.status = ERROR;
+                        res.text = "result too large";
+                    } else {
+                        res.text.resize(req.end-req.begin+1);
+                        extract(csa, req.begin, req.end, res.text.begin());
+                    }
+                    break;
+                case K_MISMATCH: {
+                    // with k >= m every substring of length m would match
+                    if (req.k >= req.pattern.size()) {
+                        res.status = ERROR;
+                        res.text = "k has to be smaller than the pattern length";
+                        break;
+                    }
+                    std::vector<std::array<size_type, 2>> intervals;
+                    k_mismatch_search(csa, req.pattern.begin(), req.pattern.end(), req.k, intervals);
+                    uint64_t occ = 0;
+                    for (auto& iv : intervals) {
+                        occ += iv[1]-iv[0]+1;
+                    }
+                    if (occ > max_positions) {
+                        res.status = ERROR;
+                        res.text = "result too large";
+                        break;
+                    }
+                    for (auto& iv : intervals) {
+                        for (size_type i=iv[0]; i <= iv[1]; ++i) {
+                            res.positions.push_back(csa[i]);
+                        }
+                    }
+                    break;
+                }
+                default:
+                    res.status = ERROR;
+                    res.text = "unknown operation";
+            }
+        }
+
+        void answer_batch(const std::shared_ptr<frame_stream>& stream,
+                          const std::vector<query_protocol::request>& batch) const
+        {
+            std::string out;
+            query_protocol::response res;
+            try {
+                for (const auto& req : batch) {
+                    try {
+                        answer(req, res);
+                    } catch (const std::exception& e) {
+                        res = query_protocol::response();
+                        res.id = req.id;
+                        res.status = query_protocol::ERROR;
+                        res.text = e.what();
+                    }
+                    query_protocol::encode(res, out);
+                    // small responses share a write; large ones are not accumulated
+                    if (out.size() >= write_chunk) {
+                        stream->write(out);
+                        out.clear();
+                    }
+                }
+                if (!out.empty()) {
+                    stream->write(out);
+                }
+            } catch (const std::exception&) {
+                // the client closed the connection or does not read its responses;
+                // a partly written frame leaves the stream unusable
+                stream->shutdown();
+            }
+        }
+
+        // Reads the requests of a connection and hands them in batches to the pool
+        void read_requests(std::shared_ptr<frame_stream> stream, std::shared_ptr<std::atomic<bool>> done)
+        {
+            auto pending = std::make_shared<pending_batches>();
+            std::vector<query_protocol::request> batch;
+            bool open = true;
+            try {
+                while (open) {
+                    const char* payload;
+                    uint32_t size;
+                    while (batch.size() < m_max_batch and stream->buffered_frame(payload, size)) {
+                        query_protocol::request req;
+                        if (!query_protocol::decode(payload, size, req)) {
+                            open = false;
+                            break;
+                        }
+                        batch.push_back(std::move(req));
+                    }
+                    if (!batch.empty()) {
+                        {
+                            std::unique_lock<std::mutex> lock(pending->mtx);
+                            pending->cv.wait(lock, [&]() { return pending->n < m_max_pending; });
+                            ++pending->n;
+                        }
+                        ++m_batches;
+                        m_requests += batch.size();
+                        auto task_batch = std::make_shared<std::vector<query_protocol::request>>(std::move(batch));
+                        batch.clear();
+                        m_pool.submit([this, stream, pending, task_batch](uint32_t) {
+                            answer_batch(stream, *task_batch);
+                            std::lock_guard<std::mutex> lock(pending->mtx);
+                            --pending->n;
+                            pending->cv.notify_one();
+                        });
+                        continue; // there may be more buffered frames
+                    }
+                    if (open) {
+                        open = stream->receive();
+                    }
+                }
+            } catch (const std::exception&) {
+                // e.g. a frame exceeding max_frame_size; only this connection is closed
+                stream->shutdown_read();
+            }
+            *done = true;
+        }
+
+        // Joins the readers of closed connections; m_conn_mtx has to be locked
+        void reap_readers()
+        {
+            for (size_t i=0; i < m_readers.size();) {
+                if (*m_readers[i].done) {
+                    m_readers[i].thread.join();
+                    std::swap(m_readers[i], m_readers.back());
+                    m_readers.pop_back();
+                } else {
+                    ++i;
+                }
+            }
+            m_connections.erase(std::remove_if(m_connections.begin(), m_connections.end(),
+                                               [](const std::weak_ptr<frame_stream>& c) {
+                                                   return c.expired();
+                                               }), m_connections.end());
+        }
+
+    public:
+        //! Constructor
+        /*! \param index       The index; has to outlive the server.
+         *  \param socket_path Path of the Unix domain socket.
+         *  \param threads     Number of workers per NUMA node; 0 means one per CPU.
+         *  \param max_batch   Maximal number of requests in a batch.
+         *  \param max_pending Maximal number of unanswered batches of a connection.
+         *  \param send_timeout Milliseconds after which a connection whose client does
+         *                      not read its responses is closed; 0 waits forever.
+         */
+        query_server(const t_index& index, const std::string& socket_path,
+                     uint32_t threads=0, size_t max_batch=64, size_t max_pending=4,
+                     uint32_t send_timeout=10000) :
+            m_index(index), m_path(socket_path), m_max_batch(max_batch),
+            m_max_pending(std::max(max_pending, (size_t)1)), m_send_timeout(send_timeout), m_pool(threads),
+            m_stop(false), m_batches(0), m_requests(0)
+        {
+            m_listen_fd = listen_unix_socket(m_path);
+        }
+
+        //! Stops the server and waits for the readers of the connections.
+        ~query_server()
+        {
+            stop();
+            for (auto& r : m_readers) {
+                r.thread.join();
+            }
+            close_listen_socket(m_listen_fd, m_path);
+        }
+
+        query_server(const query_server&) = delete;
+        query_server& operator=(const query_server&) = delete;
+
+        //! Accepts connections until stop() is called.
+        void run();
+
+        //! Stops accepting connections and closes the open connections.
+        /*! Requests which were already read are still answered, but their
+         *  responses are not delivered.
+         */
+        void stop();
+
+        //! Number of batches handed to the workers.
+        uint64_t batches() const
+        {
+            return m_batches;
+        }
+        //! Number of received requests.
+        uint64_t requests() const
+        {
+            return m_requests;
+        }
+};
+
+template<class t_index>
+void query_server<t_index>::run()
+{
+    while (!m_stop) {
+        int fd = accept_connection(m_listen_fd);
+        if (fd < 0) {
+            break;
+        }
+        auto stream = std::make_shared<frame_stream>(fd);
+        stream->set_send_timeout(m_send_timeout);
+        std::lock_guard<std::mutex> lock(m_conn_mtx);
+        if (m_stop) {
+            break;
+        }
+        reap_readers();
+        m_connections.push_back(stream);
+        auto done = std::make_shared<std::atomic<bool>>(false);
+        m_readers.push_back({std::thread(&query_server::read_requests, this, stream, done), done});
+    }
+}
+
+template<class t_index>
+void query_server<t_index>::stop()
+{
+    std::lock_guard<std::mutex> lock(m_conn_mtx);
+    if (m_stop.exchange(true)) {
+        return;
+    }
+    shutdown_listen_socket(m_listen_fd);
+    for (auto& c : m_connections) {
+        // also wakes up workers which are blocked writing to a client
+        if (auto stream = c.lock()) {
+            stream->shutdown();
+        }
+    }
+}
+
+} // end namespace sdsl
+
+#endif
@@ -0,0 +1,141 @@
+/*!\file query_stats.hpp
+   \brief query_stats.hpp contains counters for the operations of queries.
+
+   The counters are only compiled in, if SDSL_QUERY_STATS is defined (e.g.
+   -DSDSL_QUERY_STATS). Otherwise the SDSL_QUERY_COUNT macros expand to
+   nothing and the structures contain no counter members.
+*/
+#ifndef INCLUDED_SDSL_QUERY_STATS
+#define INCLUDED_SDSL_QUERY_STATS
+
+#include "structure_tree.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <string>
+
+namespace sdsl
+{
+
+//! Counters of wavelet trees.
+/*! LEVEL_RANK+l (LEVEL_SELECT+l) counts the rank (select) operations on the
+ *  bitvector of the nodes of depth l. Depths greater than 63 are counted at 63.
+ */
+struct wt_query_stats {
+    enum {ACCESS, RANK, SELECT, INVERSE_SELECT,
+          LEVEL_RANK, LEVEL_SELECT = LEVEL_RANK+64, COUNTERS = LEVEL_SELECT+64
+         };
+    static std::string name(size_t i)
+    {
+        static const char* names[] = {"access", "rank", "select", "inverse_select"};
+        if (i < LEVEL_RANK) {
+            return names[i];
+        } else if (i < LEVEL_SELECT) {
+            return "rank_level_"+util::to_string(i-LEVEL_RANK);
+        }
+        return "select_level_"+util::to_string(i-LEVEL_SELECT);
+    }
+};
+
+//! Counters of CSAs.
+/*! SA_SAMPLE_HITS counts the SA accesses, which hit a sample without any
+ *  LF or Psi step, STEPS the LF or Psi steps of the SA accesses.
+ */
+struct csa_query_stats {
+    enum {SA_ACCESS, SA_SAMPLE_HITS, STEPS, COUNTERS};
+    static std::string name(size_t i)
+    {
+        static const char* names[] = {"sa_access", "sa_sample_hits", "sa_steps"};
+        return names[i];
+    }
+};
+
+//! Counters of balanced parentheses supports.
+/*! CACHE_HIT and CACHE_MISS count the lookups in the fast_caches, which are
+ *  used if USE_CACHE is defined.
+ */
+struct bp_query_stats {
+    enum {FIND_CLOSE, FIND_OPEN, ENCLOSE, SELECT, CACHE_HIT, CACHE_MISS, COUNTERS};
+    static std::string name(size_t i)
+    {
+        static const char* names[] = {"find_close", "find_open", "enclose", "select",
+                                      "cache_hit", "cache_miss"
+                                     };
+        return names[i];
+    }
+};
+
+#ifdef SDSL_QUERY_STATS
+
+//! Array of t_n operation counters.
+/*! The counters are incremented with relaxed atomics, so concurrent queries
+ *  are counted correctly. Copies of a structure start with zero counters.
+ */
+template<size_t t_n>
+class query_counters
+{
+    private:
+        mutable std::array<std::atomic<uint64_t>, t_n> m_cnt;
+    public:
+        query_counters()
+        {
+            reset();
+        }
+        query_counters(const query_counters&) : query_counters() {}
+        query_counters& operator=(const query_counters&)
+        {
+            reset();
+            return *this;
+        }
+
+        void inc(size_t i, uint64_t delta=1) const
+        {
+            m_cnt[i].fetch_add(delta, std::memory_order_relaxed);
+        }
+
+        uint64_t operator[](size_t i) const
+        {
+            return m_cnt[i].load(std::memory_order_relaxed);
+        }
+
+        void reset()
+        {
+            for (auto& c : m_cnt) {
+                c.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        //! Adds the non-zero counters to a node of the structure tree.
+        /*! \param v    Node of the structure.
+         *  \param name Function which maps a counter index to its name.
+         */
+        template<class t_name>
+        void add_to(structure_tree_node* v, t_name name) const
+        {
+            for (size_t i=0; i < t_n; ++i) {
+                if ((*this)[i]) {
+                    structure_tree::add_counter(v, name(i), (*this)[i]);
+                }
+            }
+        }
+};
+
+#define SDSL_QUERY_COUNT(counters, i) (counters).inc(i)
+#define SDSL_QUERY_COUNT_N(counters, i, n) (counters).inc((i), (n))
+#define SDSL_QUERY_COUNT_LEVEL(counters, first, level) (counters).inc((first)+std::min<size_t>((level), 63))
+#define SDSL_QUERY_STATS_ONLY(...) __VA_ARGS__
+
+#else
+
+#define SDSL_QUERY_COUNT(counters, i)
+#define SDSL_QUERY_COUNT_N(counters, i, n)
+#define SDSL_QUERY_COUNT_LEVEL(counters, first, level)
+#define SDSL_QUERY_STATS_ONLY(...)
+
+#endif
+
+} // end namespace sdsl
+
+#endif
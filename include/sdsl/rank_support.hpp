@@ -77,6 +77,15 @@ class rank_support
          *  \sa init, rank
          */
         virtual void set_vector(const bit_vector* v=nullptr) = 0;
+        //! Answers n independent rank queries: out[j] = rank(idx[j]) for \f$j\in[0..n-1]\f$.
+        /*! Supports which can prefetch their memory provide their own version.
+         */
+        void rank_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            for (size_type j=0; j < n; ++j) {
+                out[j] = rank(idx[j]);
+            }
+        }
 };
 
 inline rank_support::rank_support(const bit_vector* v)
@@ -105,6 +114,12 @@ struct rank_support_trait {
         return 0;
     }
 
+    //! Number of occurrences in the n full words starting at bit idx (a multiple of 64)
+    static uint64_t full_words_rank(const uint64_t*, size_type, size_type)
+    {
+        return 0;
+    }
+
     static uint64_t init_carry()
     {
         return 0;
@@ -130,6 +145,11 @@ struct rank_support_trait<0,1> {
         return	bits::cnt((~*(data+(idx>>6))));
     }
 
+    static uint64_t full_words_rank(const uint64_t* data, size_type idx, size_type n)
+    {
+        return 64*n - bits::cnt(data+(idx>>6), n);
+    }
+
     static uint64_t init_carry()
     {
         return 0;
@@ -155,6 +175,11 @@ struct rank_support_trait<1,1> {
         return	bits::cnt(*(data+(idx>>6)));
     }
 
+    static uint64_t full_words_rank(const uint64_t* data, size_type idx, size_type n)
+    {
+        return bits::cnt(data+(idx>>6), n);
+    }
+
     static uint64_t init_carry()
     {
         return 0;
@@ -184,6 +209,15 @@ struct rank_support_trait<10,2> {
         return	bits::cnt(bits::map10(*data, carry));
     }
 
+    static uint64_t full_words_rank(const uint64_t* data, size_type idx, size_type n)
+    {
+        uint64_t res = 0;
+        for (; n > 0; --n, idx += 64) {
+            res += full_word_rank(data, idx);
+        }
+        return res;
+    }
+
     static uint64_t init_carry()
     {
         return 0;
@@ -213,6 +247,15 @@ struct rank_support_trait<01,2> {
         return	bits::cnt(bits::map01(*data, carry));
     }
 
+    static uint64_t full_words_rank(const uint64_t* data, size_type idx, size_type n)
+    {
+        uint64_t res = 0;
+        for (; n > 0; --n, idx += 64) {
+            res += full_word_rank(data, idx);
+        }
+        return res;
+    }
+
     static uint64_t init_carry()
     {
         return 1;
@@ -244,6 +287,15 @@ struct rank_support_trait<00,2> {
         return bits::cnt(~(*data | ((*data)<<1 | carry)));
     }
 
+    static uint64_t full_words_rank(const uint64_t* data, size_type idx, size_type n)
+    {
+        uint64_t res = 0;
+        for (; n > 0; --n, idx += 64) {
+            res += full_word_rank(data, idx);
+        }
+        return res;
+    }
+
     static uint64_t init_carry()
     {
         return 1;
@@ -275,6 +327,15 @@ struct rank_support_trait<11,2> {
         return bits::cnt(*data & ((*data)<<1 | carry));
     }
 
+    static uint64_t full_words_rank(const uint64_t* data, size_type idx, size_type n)
+    {
+        uint64_t res = 0;
+        for (; n > 0; --n, idx += 64) {
+            res += full_word_rank(data, idx);
+        }
+        return res;
+    }
+
     static uint64_t init_carry()
     {
         return 0;
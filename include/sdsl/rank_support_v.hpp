@@ -127,6 +127,19 @@ class rank_support_v : public rank_support
             return rank(idx);
         }
 
+        //! Answers n independent rank queries: out[j] = rank(idx[j]) for \f$j\in[0..n-1]\f$.
+        /*! The counts and the bit_vector words of a chunk of queries are
+         *  prefetched before the ranks are computed.
+         */
+        void rank_batch(const size_type* idx, size_type n, size_type* out)const {
+            util::batch(n, [&](size_type j) {
+                util::prefetch(m_basic_block.data() + ((idx[j]>>8)&0xFFFFFFFFFFFFFFFEULL));
+                util::prefetch(m_v->data() + (idx[j]>>6));
+            }, [&](size_type j) {
+                out[j] = rank(idx[j]);
+            });
+        }
+
         size_type size()const {
             return m_v->size();
         }
@@ -113,7 +113,9 @@ class rank_support_v5 : public rank_support
         rank_support_v5& operator=(const rank_support_v5&) = default;
         rank_support_v5& operator=(rank_support_v5&&) = default;
 
-        size_type rank(size_type idx) const {
+    private:
+        // body of the virtual rank, compiled per instruction set
+        SDSL_TARGET_CLONES size_type _rank(size_type idx) const {
             assert(m_v != nullptr);
             assert(idx <= m_v->size());
             const uint64_t* p = m_basic_block.data()
@@ -123,19 +125,34 @@ class rank_support_v5 : public rank_support
                                + ((*(p+1)>>(60-12*((idx&0x7FF)/(64*6))))&0x7FFULL)
                                + trait_type::word_rank(m_v->data(), idx);
             idx -= (idx&0x3F);
+            // full words between the 6x64bit block and idx
             uint8_t to_do = ((idx>>6)&0x1FULL)%6;
-            --idx;
-            while (to_do) {
-                result += trait_type::full_word_rank(m_v->data(), idx);
-                --to_do;
-                idx-=64;
-            }
-            return result;
+            return result + trait_type::full_words_rank(m_v->data(), idx-64*to_do, to_do);
+        }
+
+    public:
+        size_type rank(size_type idx) const {
+            return _rank(idx);
         }
 
         inline size_type operator()(size_type idx)const {
             return rank(idx);
         }
+
+        //! Answers n independent rank queries: out[j] = rank(idx[j]) for \f$j\in[0..n-1]\f$.
+        /*! The counts and the bit_vector words of a chunk of queries are
+         *  prefetched before the ranks are computed.
+         */
+        SDSL_TARGET_CLONES void rank_batch(const size_type* idx, size_type n, size_type* out)const {
+            util::batch(n, [&](size_type j) {
+                size_type word = idx[j]>>6;
+                util::prefetch(m_basic_block.data() + ((idx[j]>>10)&0xFFFFFFFFFFFFFFFEULL));
+                util::prefetch(m_v->data() + word - (word&0x1F)%6); // first word of the 6x64bit block
+                util::prefetch(m_v->data() + word);
+            }, [&](size_type j) {
+                out[j] = _rank(idx[j]);
+            });
+        }
         size_type size()const {
             return m_v->size();
         }
@@ -0,0 +1,517 @@
+/*!\file rle_vector.hpp
+   \brief rle_vector.hpp contains the sdsl::rle_vector class, a run-length
+          encoded bitvector, and classes which support rank and select for it.
+*/
+#ifndef INCLUDED_SDSL_RLE_VECTOR
+#define INCLUDED_SDSL_RLE_VECTOR
+
+#include "int_vector.hpp"
+#include "util.hpp"
+#include "iterators.hpp"
+
+//! Namespace for the succinct data structure library
+namespace sdsl
+{
+
+template<uint8_t t_b=1, uint32_t t_block=64>// forward declaration needed for friend declaration
+class rank_support_rle;  // in rle_vector
+
+template<uint8_t t_b=1, uint32_t t_block=64>// forward declaration needed for friend declaration
+class select_support_rle;  // in rle_vector
+
+//! A bit vector which stores the runs of ones of the original bit vector.
+/*!
+ * Run \f$r\f$ of ones is represented by its start position \f$S[r]\f$ and
+ * the number \f$C[r]\f$ of ones before it. The runs are grouped in blocks
+ * of t_block runs; a block header stores \f$S\f$ and \f$C\f$ of the first
+ * run of the block, the runs store them relative to the header in two
+ * int_vectors of minimal width.
+ *
+ * The block headers form the leaves of a two level search structure: a
+ * directory samples the position space (respectively the ones) with about
+ * one entry per block and narrows a query to the headers between two
+ * directory entries. A binary search over the (contiguous) headers and
+ * one inside the block then finds the run. rank and select_1 therefore
+ * take \f$\Order{\log t_{block}}\f$ time for evenly spread runs and
+ * \f$\Order{\log r}\f$ in the worst case, where \f$r\f$ is the number of runs.
+ *
+ * The space is about \f$r(\log\frac{n}{r}+\log\frac{m}{r}+4)\f$ bits for
+ * \f$r\f$ runs with \f$m\f$ ones in total, i.e. independent of the length
+ * of the runs. It pays off if the ones form long runs; for isolated ones
+ * (e.g. the run heads marked in the bitvectors of sdsl::wt_rlmn on text
+ * with short runs) sdsl::sd_vector is smaller and faster.
+ *
+ * \tparam t_block Number of runs per block.
+ */
+template<uint32_t t_block=64>
+class rle_vector
+{
+    public:
+        static_assert(t_block >= 2, "rle_vector: t_block must be at least 2.");
+
+        typedef bit_vector::size_type                    size_type;
+        typedef size_type                                value_type;
+        typedef bit_vector::difference_type              difference_type;
+        typedef random_access_const_iterator<rle_vector> iterator;
+        typedef iterator                                 const_iterator;
+        typedef bv_tag                                   index_category;
+
+        friend class rank_support_rle<1,t_block>;
+        friend class rank_support_rle<0,t_block>;
+        friend class select_support_rle<1,t_block>;
+        friend class select_support_rle<0,t_block>;
+
+        typedef rank_support_rle<1,t_block>     rank_1_type;
+        typedef rank_support_rle<0,t_block>     rank_0_type;
+        typedef select_support_rle<1,t_block> select_1_type;
+        typedef select_support_rle<0,t_block> select_0_type;
+    private:
+        size_type      m_size = 0;  //!< Size of the original bitvector
+        size_type      m_ones = 0;  //!< Number of ones
+        size_type      m_runs = 0;  //!< Number of runs of ones
+        int_vector<64> m_blk_pos;   //!< S of the first run of each block
+        int_vector<64> m_blk_rank;  //!< C of the first run of each block
+        int_vector<>   m_run_pos;   //!< S relative to the block header; run m_runs is a sentinel
+        int_vector<>   m_run_rank;  //!< C relative to the block header; run m_runs is a sentinel
+        int_vector<>   m_pos_dir;   //!< m_pos_dir[j]: number of blocks starting at or before j<<m_pos_shift
+        int_vector<>   m_rank_dir;  //!< m_rank_dir[j]: number of blocks with at most j<<m_rank_shift ones before them
+        uint8_t        m_pos_shift  = 0;
+        uint8_t        m_rank_shift = 0;
+
+        //! Number of blocks which contain a run
+        size_type blocks()const
+        {
+            return (m_runs+t_block-1)/t_block;
+        }
+
+        //! Start of run r, r in [0..m_runs]
+        size_type start(size_type r)const
+        {
+            return m_blk_pos[r/t_block] + m_run_pos[r];
+        }
+
+        //! Number of ones before run r, r in [0..m_runs]
+        size_type cum(size_type r)const
+        {
+            return m_blk_rank[r/t_block] + m_run_rank[r];
+        }
+
+        //! Number of entries e in [lb..rb) with key(e) <= x, assuming the entries before lb satisfy it.
+        template<class t_key>
+        static size_type upper_bound(size_type lb, size_type rb, size_type x, t_key key)
+        {
+            while (lb < rb) {
+                size_type mid = lb + (rb-lb)/2;
+                if (key(mid) <= x) {
+                    lb = mid+1;
+                } else {
+                    rb = mid;
+                }
+            }
+            return lb;
+        }
+
+        //! Number of runs r with blk[r/t_block]+rel[r] <= x; the blocks before blb satisfy the condition, the blocks from brb on do not.
+        size_type runs_leq(size_type blb, size_type brb, size_type x,
+                           const int_vector<64>& blk, const int_vector<>& rel)const
+        {
+            size_type b = upper_bound(blb, brb, x, [&blk](size_type b) { return blk[b]; });
+            if (b == 0) {
+                return 0;
+            }
+            --b;
+            size_type x_rel = x - blk[b];
+            return upper_bound(b*t_block+1, std::min((b+1)*t_block, m_runs), x_rel,
+                               [&rel](size_type r) { return rel[r]; });
+        }
+
+        //! Number of runs which start at or before position i
+        size_type runs_before_pos(size_type i)const
+        {
+            size_type j = std::min(i, m_size-1) >> m_pos_shift;
+            return runs_leq(m_pos_dir[j], m_pos_dir[j+1], i, m_blk_pos, m_run_pos);
+        }
+
+        //! Number of runs with at most k ones before them
+        size_type runs_before_rank(size_type k)const
+        {
+            size_type j = k >> m_rank_shift;
+            return runs_leq(m_rank_dir[j], m_rank_dir[j+1], k, m_blk_rank, m_run_rank);
+        }
+
+        //! Number of ones in [0..i-1], i <= m_size
+        size_type rank_1(size_type i)const
+        {
+            if (i == 0 or m_runs == 0) {
+                return 0;
+            }
+            size_type r = runs_before_pos(i-1);
+            if (r == 0) {
+                return 0;
+            }
+            --r;
+            return cum(r) + std::min(i - start(r), cum(r+1) - cum(r));
+        }
+
+        //! Position of the i-th one, i in [1..m_ones]
+        size_type select_1(size_type i)const
+        {
+            size_type r = runs_before_rank(i-1) - 1;
+            return start(r) + (i-1-cum(r));
+        }
+
+        //! Position of the i-th zero, i in [1..m_size-m_ones]
+        size_type select_0(size_type i)const
+        {
+            // zeros before run r: start(r)-cum(r); find the last run with at most i-1 of them
+            size_type b = upper_bound(0, blocks(), i-1, [this](size_type b) {
+                return m_blk_pos[b] - m_blk_rank[b];
+            });
+            size_type r = 0;
+            if (b > 0) {
+                --b;
+                r = upper_bound(b*t_block+1, std::min((b+1)*t_block, m_runs), i-1, [this](size_type r) {
+                    return start(r) - cum(r);
+                });
+            }
+            if (r == 0) {
+                return i-1;
+            }
+            --r;
+            return i-1 + cum(r+1);
+        }
+
+        //! Directory entries dir[j] = number of keys <= j<<shift, for j in [0..(n>>shift)+1]
+        static void build_dir(const int_vector<64>& key, size_type k, size_type n, uint8_t& shift, int_vector<>& dir)
+        {
+            size_type per_entry = n/std::max(k, (size_type)1);
+            shift = per_entry ? bits::hi(per_entry) : 0;
+            size_type entries = (n >> shift) + 2;
+            dir = int_vector<>(entries, 0, bits::hi(k)+1);
+            size_type e = 0;
+            for (size_type j=0; j < entries; ++j) {
+                while (e < k and key[e] <= (j << shift)) {
+                    ++e;
+                }
+                dir[j] = e;
+            }
+        }
+
+    public:
+        rle_vector() {}
+
+        rle_vector(const bit_vector& bv)
+        {
+            m_size = bv.size();
+            // (1) starts and ends of the runs
+            std::vector<size_type> s, e;
+            const uint64_t* data = bv.data();
+            const size_type words = (m_size+63)/64;
+            uint64_t prev = 0; // last bit of the previous word
+            for (size_type w=0; w < words; ++w) {
+                uint64_t x = data[w];
+                if (w+1 == words and (m_size&63)) {
+                    x &= bits::lo_set[m_size&63];
+                }
+                uint64_t begins = x & ~((x << 1) | prev);
+                uint64_t ends   = ~x & ((x << 1) | prev);
+                prev = x >> 63;
+                while (begins) {
+                    s.push_back(64*w + bits::lo(begins));
+                    begins &= begins-1;
+                }
+                while (ends) {
+                    e.push_back(64*w + bits::lo(ends));
+                    ends &= ends-1;
+                }
+            }
+            if (prev) {
+                e.push_back(words*64);
+            }
+            m_runs = s.size();
+            // (2) headers and relative values
+            const size_type B = m_runs/t_block + 1; // includes the block of the sentinel
+            m_blk_pos  = int_vector<64>(B, 0);
+            m_blk_rank = int_vector<64>(B, 0);
+            std::vector<size_type> rank(m_runs+1, 0);
+            for (size_type r=0; r < m_runs; ++r) {
+                rank[r+1] = rank[r] + e[r] - s[r];
+            }
+            m_ones = rank[m_runs];
+            s.push_back(m_size);
+            size_type max_pos = 0, max_rank = 0;
+            for (size_type r=0; r <= m_runs; ++r) {
+                if (r % t_block == 0) {
+                    m_blk_pos[r/t_block]  = s[r];
+                    m_blk_rank[r/t_block] = rank[r];
+                }
+                max_pos  = std::max(max_pos, s[r] - m_blk_pos[r/t_block]);
+                max_rank = std::max(max_rank, rank[r] - m_blk_rank[r/t_block]);
+            }
+            m_run_pos  = int_vector<>(m_runs+1, 0, bits::hi(max_pos)+1);
+            m_run_rank = int_vector<>(m_runs+1, 0, bits::hi(max_rank)+1);
+            for (size_type r=0; r <= m_runs; ++r) {
+                m_run_pos[r]  = s[r] - m_blk_pos[r/t_block];
+                m_run_rank[r] = rank[r] - m_blk_rank[r/t_block];
+            }
+            build_dir(m_blk_pos, blocks(), m_size, m_pos_shift, m_pos_dir);
+            build_dir(m_blk_rank, blocks(), m_ones, m_rank_shift, m_rank_dir);
+        }
+
+        //! Accessing the i-th element of the original bit_vector
+        /*! \param i An index i with \f$ 0 \leq i < size()  \f$.
+         *  \return The i-th bit of the original bit_vector
+         */
+        value_type operator[](size_type i)const
+        {
+            assert(i < m_size);
+            size_type r = m_runs ? runs_before_pos(i) : 0;
+            if (r == 0) {
+                return 0;
+            }
+            --r;
+            return i - start(r) < cum(r+1) - cum(r);
+        }
+
+        //! Get the integer value of the binary string of length len starting at position idx.
+        /*! \param idx Starting index of the binary representation of the integer.
+         *  \param len Length of the binary representation of the integer. Default value is 64.
+         *   \returns The integer value of the binary string of length len starting at position idx.
+         *
+         *  \pre idx+len-1 in [0..size()-1]
+         *  \pre len in [1..64]
+         */
+        uint64_t get_int(size_type idx, uint8_t len=64)const
+        {
+            assert(idx+len-1 < m_size);
+            size_type r = m_runs ? runs_before_pos(idx) : 0;
+            r -= (r > 0);
+            uint64_t res = 0;
+            for (; r < m_runs and start(r) < idx+len; ++r) {
+                size_type b = std::max(start(r), idx);
+                size_type e = std::min(start(r) + cum(r+1) - cum(r), idx+len);
+                if (b < e) {
+                    res |= bits::lo_set[e-b] << (b-idx);
+                }
+            }
+            return res;
+        }
+
+        //! Returns the size of the original bit vector.
+        size_type size()const
+        {
+            return m_size;
+        }
+
+        //! Returns the number of runs of ones.
+        size_type runs()const
+        {
+            return m_runs;
+        }
+
+        //! Serializes the data structure into the given ostream
+        size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const
+        {
+            structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
+            size_type written_bytes = 0;
+            written_bytes += write_member(m_size, out, child, "size");
+            written_bytes += write_member(m_ones, out, child, "ones");
+            written_bytes += write_member(m_runs, out, child, "runs");
+            written_bytes += m_blk_pos.serialize(out, child, "blk_pos");
+            written_bytes += m_blk_rank.serialize(out, child, "blk_rank");
+            written_bytes += m_run_pos.serialize(out, child, "run_pos");
+            written_bytes += m_run_rank.serialize(out, child, "run_rank");
+            written_bytes += m_pos_dir.serialize(out, child, "pos_dir");
+            written_bytes += m_rank_dir.serialize(out, child, "rank_dir");
+            written_bytes += write_member(m_pos_shift, out, child, "pos_shift");
+            written_bytes += write_member(m_rank_shift, out, child, "rank_shift");
+            structure_tree::add_size(child, written_bytes);
+            return written_bytes;
+        }
+
+        //! Loads the data structure from the given istream.
+        void load(std::istream& in)
+        {
+            read_member(m_size, in);
+            read_member(m_ones, in);
+            read_member(m_runs, in);
+            m_blk_pos.load(in);
+            m_blk_rank.load(in);
+            m_run_pos.load(in);
+            m_run_rank.load(in);
+            m_pos_dir.load(in);
+            m_rank_dir.load(in);
+            read_member(m_pos_shift, in);
+            read_member(m_rank_shift, in);
+        }
+
+        void swap(rle_vector& bv)
+        {
+            if (this != &bv) {
+                std::swap(m_size, bv.m_size);
+                std::swap(m_ones, bv.m_ones);
+                std::swap(m_runs, bv.m_runs);
+                m_blk_pos.swap(bv.m_blk_pos);
+                m_blk_rank.swap(bv.m_blk_rank);
+                m_run_pos.swap(bv.m_run_pos);
+                m_run_rank.swap(bv.m_run_rank);
+                m_pos_dir.swap(bv.m_pos_dir);
+                m_rank_dir.swap(bv.m_rank_dir);
+                std::swap(m_pos_shift, bv.m_pos_shift);
+                std::swap(m_rank_shift, bv.m_rank_shift);
+            }
+        }
+
+        iterator begin() const
+        {
+            return iterator(this, 0);
+        }
+
+        iterator end() const
+        {
+            return iterator(this, size());
+        }
+};
+
+template<uint8_t t_b, uint32_t t_block>
+class rank_support_rle
+{
+        static_assert(t_b == 1 or t_b == 0 , "rank_support_rle only supports bitpatterns 0 or 1.");
+    public:
+        typedef bit_vector::size_type size_type;
+        typedef rle_vector<t_block>   bit_vector_type;
+        enum { bit_pat = t_b };
+        enum { bit_pat_len = (uint8_t)1 };
+    private:
+        const bit_vector_type* m_v;
+
+    public:
+
+        rank_support_rle(const bit_vector_type* v=nullptr)
+        {
+            set_vector(v);
+        }
+
+        //! Returns the number of occurrences of the bit pattern in [0..i-1].
+        size_type rank(size_type i) const
+        {
+            if (t_b) return m_v->rank_1(i);
+            return i - m_v->rank_1(i);
+        }
+
+        size_type operator()(size_type i)const
+        {
+            return rank(i);
+        }
+
+        //! Answers n independent rank queries: out[j] = rank(idx[j]) for \f$j\in[0..n-1]\f$.
+        void rank_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            for (size_type j=0; j < n; ++j) {
+                out[j] = rank(idx[j]);
+            }
+        }
+
+        size_type size()const
+        {
+            return m_v->size();
+        }
+
+        void set_vector(const bit_vector_type* v=nullptr)
+        {
+            m_v = v;
+        }
+
+        rank_support_rle& operator=(const rank_support_rle& rs)
+        {
+            if (this != &rs) {
+                set_vector(rs.m_v);
+            }
+            return *this;
+        }
+
+        void swap(rank_support_rle&) { }
+
+        void load(std::istream&, const bit_vector_type* v=nullptr)
+        {
+            set_vector(v);
+        }
+
+        size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const
+        {
+            return serialize_empty_object(out, v, name, this);
+        }
+};
+
+template<uint8_t t_b, uint32_t t_block>
+class select_support_rle
+{
+        static_assert(t_b == 1 or t_b == 0 , "select_support_rle only supports bitpatterns 0 or 1.");
+    public:
+        typedef bit_vector::size_type size_type;
+        typedef rle_vector<t_block>   bit_vector_type;
+        enum { bit_pat = t_b };
+        enum { bit_pat_len = (uint8_t)1 };
+    private:
+        const bit_vector_type* m_v;
+
+    public:
+
+        select_support_rle(const bit_vector_type* v=nullptr)
+        {
+            set_vector(v);
+        }
+
+        //! Returns the position of the i-th occurrence in the bit vector.
+        size_type select(size_type i) const
+        {
+            if (t_b) return m_v->select_1(i);
+            return m_v->select_0(i);
+        }
+
+        size_type operator()(size_type i)const
+        {
+            return select(i);
+        }
+
+        //! Answers n independent select queries: out[j] = select(idx[j]) for \f$j\in[0..n-1]\f$.
+        void select_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            for (size_type j=0; j < n; ++j) {
+                out[j] = select(idx[j]);
+            }
+        }
+
+        size_type size()const
+        {
+            return m_v->size();
+        }
+
+        void set_vector(const bit_vector_type* v=nullptr)
+        {
+            m_v = v;
+        }
+
+        select_support_rle& operator=(const select_support_rle& rs)
+        {
+            if (this != &rs) {
+                set_vector(rs.m_v);
+            }
+            return *this;
+        }
+
+        void swap(select_support_rle&) { }
+
+        void load(std::istream&, const bit_vector_type* v=nullptr)
+        {
+            set_vector(v);
+        }
+
+        size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const
+        {
+            return serialize_empty_object(out, v, name, this);
+        }
+};
+
+} // end namespace sdsl
+#endif
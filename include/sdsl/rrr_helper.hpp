@@ -81,6 +81,11 @@ struct binomial_coefficients_trait {
     static inline uint16_t popcount(number_type x) {
         return bits::cnt(x);
     }
+
+    //! Returns x if b is true and 0 otherwise, without a branch.
+    static inline number_type if_set(bool b, number_type x) {
+        return x & (0ULL - b);
+    }
 };
 
 //! Specialization of binomial_coefficients_trait for 128-bit integers.
@@ -120,6 +125,11 @@ struct binomial_coefficients_trait<7> {
     static inline uint16_t popcount(number_type x) {
         return bits::cnt(x >> 64) + bits::cnt(x);
     }
+
+    static inline number_type if_set(bool b, number_type x) {
+        uint64_t mask = 0ULL - b;
+        return x & ((((number_type)mask)<<64) | mask);
+    }
 };
 
 //! Specialization of binomial_coefficients_trait for 256-bit integers.
@@ -168,6 +178,10 @@ struct binomial_coefficients_trait<8> {
     static inline uint16_t popcount(number_type x) {
         return x.popcount();
     }
+
+    static inline number_type if_set(bool b, number_type x) {
+        return b ? x : number_type(0);
+    }
 };
 
 template<uint16_t n, class number_type>
@@ -245,6 +259,7 @@ struct binomial_coefficients {
 #else
         static const uint16_t BINARY_SEARCH_THRESHOLD = 0;
 #endif
+        static const uint16_t BRANCHLESS_THRESHOLD = n/4;
         number_type(&L1Mask)[MAX_SIZE+1] = tBinom::data.L1Mask;
         number_type(&O1Mask)[MAX_SIZE] = tBinom::data.O1Mask;
 
@@ -271,6 +286,9 @@ typename binomial_coefficients<n>::impl binomial_coefficients<n>::data;
  *   - Decode blocks with at most \f$ k<n\log(n) \f$ by a binary search for the ones.
  *   - For operations decode_popcount, decode_select, and decode_bit a block
  *     is only decoded as long as the query is not answered yet.
+ *   - Blocks whose number of ones and zeros are both at least \f$ n/4 \f$ are
+ *     decoded without branches (see decode_step), as the decision for each bit is
+ *     not predictable for them.
  */
 template<uint16_t n>
 struct rrr_helper {
@@ -319,6 +337,99 @@ struct rrr_helper {
         return nr;
     }
 
+    //! Decode the next bit of a block in the linear decoding.
+    /*! \param k   Number of ones in the remaining nn bits; k > 1.
+     *  \param nr  Block type number of the remaining bits.
+     *  \param nn  Number of remaining bits.
+     *  \param cur Binomial coefficient \f${nn-1 \choose k}\f$. Replaced by the
+     *             coefficient of the next position.
+     *  \tparam t_branchless If true, the coefficients for both outcomes of the next
+     *          position are loaded before the current bit is known and selected without
+     *          a branch. This pays off for blocks with many ones and zeros, where the
+     *          branch is not predictable; sparse and dense blocks are faster with the branch.
+     */
+    template<bool t_branchless>
+    static inline bool decode_step(uint16_t& k, number_type& nr, uint16_t nn, number_type& cur) {
+        if (t_branchless) {
+            const number_type next0 = binomial::data.table[nn-2][k];   // if the bit is zero
+            const number_type next1 = binomial::data.table[nn-2][k-1]; // if the bit is one
+            const bool b = nr >= cur;
+            nr -= trait::if_set(b, cur);
+            k  -= b;
+            cur = trait::if_set(b, next1) | trait::if_set(!b, next0);
+            return b;
+        }
+        if (nr >= cur) {
+            nr -= cur;
+            --k;
+            cur = binomial::data.table[nn-2][k];
+            return true;
+        }
+        cur = binomial::data.table[nn-2][k];
+        return false;
+    }
+
+    //! Returns if the linear decoding of a block with k ones uses the branchless decode_step.
+    static inline bool decode_branchless(uint16_t k) {
+        return k >= binomial::data.BRANCHLESS_THRESHOLD and n-k >= binomial::data.BRANCHLESS_THRESHOLD;
+    }
+
+    //! Linear decoding of decode_bit.
+    template<bool t_branchless>
+    static inline bool decode_bit_linear(uint16_t k, number_type nr, uint16_t off) {
+        number_type cur = binomial::data.table[n-1][k];
+        for (uint16_t i = 0, nn = n; k > 1; ++i, --nn) {
+            bool b = decode_step<t_branchless>(k, nr, nn, cur);
+            if (i == off)
+                return b;
+        }
+        return (n-nr-1) == off;
+    }
+
+    //! Linear decoding of decode_int.
+    template<bool t_branchless>
+    static inline uint64_t decode_int_linear(uint16_t k, number_type nr, uint16_t off, uint16_t len) {
+        uint64_t res = 0;
+        uint16_t i = 0, nn = n;
+        number_type cur = binomial::data.table[nn-1][k];
+        for (; k > 1 and i < off; ++i, --nn) {
+            decode_step<t_branchless>(k, nr, nn, cur);
+        }
+        for (; k > 1 and i < off+len; ++i, --nn) {
+            res |= (uint64_t)decode_step<t_branchless>(k, nr, nn, cur) << (i-off);
+        }
+        if (k == 1 and n-nr-1 >= (number_type)off and n-nr-1 <= (number_type)(off+len-1)) {
+            res |= 1ULL << ((n-nr-1)-off);
+        }
+        return res;
+    }
+
+    //! Linear decoding of decode_popcount.
+    template<bool t_branchless>
+    static inline uint16_t decode_popcount_linear(uint16_t k, number_type nr, uint16_t off) {
+        uint16_t result = 0;
+        number_type cur = binomial::data.table[n-1][k];
+        for (uint16_t i = 0, nn = n; k > 1; ++i, --nn) {
+            if (i >= off) {
+                return result;
+            }
+            result += decode_step<t_branchless>(k, nr, nn, cur);
+        }
+        return result + ((n-nr-1) < off);
+    }
+
+    //! Linear decoding of decode_select.
+    template<bool t_branchless>
+    static inline uint16_t decode_select_linear(uint16_t k, number_type nr, uint16_t sel) {
+        number_type cur = binomial::data.table[n-1][k];
+        for (uint16_t i = 0, nn = n; k > 1; ++i, --nn) {
+            sel -= decode_step<t_branchless>(k, nr, nn, cur);
+            if (sel == 0)
+                return i;
+        }
+        return n-nr-1; // the sel-th one is the last one of the block
+    }
+
     //! Decode the bit at position \f$ off \f$ of the block encoded by the pair (k, nr).
     static inline bool decode_bit(uint16_t k, number_type nr, uint16_t off) {
 #ifndef RRR_NO_OPT
@@ -351,21 +462,10 @@ struct rrr_helper {
                 --k;
                 --nn;
             }
-        } else { // else do a linear decoding
-            int i = 0;
-            while (k > 1) {
-                if (i > off) {
-                    return 0;
-                }
-                if (nr >= binomial::data.table[nn-1][k]) {
-                    nr -= binomial::data.table[nn-1][k];
-                    --k;
-                    if (i == off)
-                        return 1;
-                }
-                --nn;
-                ++i;
-            }
+        } else if (decode_branchless(k)) { // else do a linear decoding
+            return decode_bit_linear<true>(k, nr, off);
+        } else {
+            return decode_bit_linear<false>(k, nr, off);
         }
         return (n-nr-1) == off;
     }
@@ -384,26 +484,10 @@ struct rrr_helper {
                 return 0;
         }
 #endif
-        uint64_t res = 0;
-        uint16_t nn = n;
-        int i = 0;
-        while (k > 1) {
-            if (i > off+len-1) {
-                return res;
-            }
-            if (nr >= binomial::data.table[nn-1][k]) {
-                nr -= binomial::data.table[nn-1][k];
-                --k;
-                if (i >= off)
-                    res |= 1ULL << (i-off);
-            }
-            --nn;
-            ++i;
-        }
-        if (n-nr-1 >= (number_type)off and n-nr-1 <= (number_type)(off+len-1)) {
-            res |= 1ULL << ((n-nr-1)-off);
+        if (decode_branchless(k)) {
+            return decode_int_linear<true>(k, nr, off, len);
         }
-        return res;
+        return decode_int_linear<false>(k, nr, off, len);
     }
 
 
@@ -441,20 +525,10 @@ struct rrr_helper {
                 --k;
                 --nn;
             }
+        } else if (decode_branchless(k)) {
+            return decode_popcount_linear<true>(k, nr, off);
         } else {
-            int i = 0;
-            while (k > 1) {
-                if (i >= off) {
-                    return result;
-                }
-                if (nr >= binomial::data.table[nn-1][k]) {
-                    nr -= binomial::data.table[nn-1][k];
-                    --k;
-                    ++result;
-                }
-                --nn;
-                ++i;
-            }
+            return decode_popcount_linear<false>(k, nr, off);
         }
         return result + ((n-nr-1) < off);
     }
@@ -489,18 +563,10 @@ struct rrr_helper {
                 --k;
             }
             return n-nn-1;
+        } else if (decode_branchless(k)) {
+            return decode_select_linear<true>(k, nr, sel);
         } else {
-            int i = 0;
-            while (sel > 0) {   // TODO: this condition only work if the precondition holds
-                if (nr >= binomial::data.table[nn-1][k]) {
-                    nr -= binomial::data.table[nn-1][k];
-                    --sel;
-                    --k;
-                }
-                --nn;
-                ++i;
-            }
-            return i-1;
+            return decode_select_linear<false>(k, nr, sel);
         }
     }
 
@@ -289,36 +289,34 @@ class rrr_vector
             uint64_t res = 0;
             size_type bb_idx = idx/t_bs; // begin block index
             size_type bb_off = idx%t_bs; // begin block offset
-            uint16_t bt = m_bt[bb_idx];
-            size_type sample_pos = bb_idx/t_k;
             size_type eb_idx = (idx+len-1)/t_bs; // end block index
-            if (bb_idx == eb_idx) {  // extract only in one block
-                if (m_invert[sample_pos])
+            size_type sample_pos = bb_idx/t_k;
+            size_type btnrp = m_btnrp[ sample_pos ];
+            for (size_type j = sample_pos*t_k; j < bb_idx; ++j) {
+                btnrp += rrr_helper_type::space_for_bt(m_bt[j]);
+            }
+            // decode the blocks one after the other; the position of the
+            // block type number of the next block is the end of the current one
+            uint16_t res_off = 0;
+            for (size_type b_idx = bb_idx; b_idx <= eb_idx; ++b_idx) {
+                uint16_t b_off = (b_idx == bb_idx) ? bb_off : 0;
+                uint16_t b_len = std::min((uint16_t)(len-res_off), (uint16_t)(t_bs-b_off));
+                uint16_t bt = m_bt[b_idx];
+                uint16_t btnrlen = rrr_helper_type::space_for_bt(bt);
+                if (m_invert[b_idx/t_k])
                     bt = t_bs - bt;
+                uint64_t part = 0;
                 if (bt == 0) {   // all bits are zero
-                    res = 0;
-                } else if (bt == t_bs and t_bs <= 64) { // all bits are zero
-                    res = bits::lo_set[len];
+                    part = 0;
+                } else if (bt == t_bs and t_bs <= 64) { // all bits are one
+                    part = bits::lo_set[b_len];
                 } else {
-                    size_type btnrp = m_btnrp[ sample_pos ];
-                    for (size_type j = sample_pos*t_k; j < bb_idx; ++j) {
-                        btnrp += rrr_helper_type::space_for_bt(m_bt[j]);
-                    }
-                    uint16_t btnrlen = rrr_helper_type::space_for_bt(bt);
                     number_type btnr = rrr_helper_type::decode_btnr(m_btnr, btnrp, btnrlen);
-                    res =  rrr_helper_type::decode_int(bt, btnr, bb_off, len);
+                    part = rrr_helper_type::decode_int(bt, btnr, b_off, b_len);
                 }
-            } else { // solve multiple block case by recursion
-                uint16_t b_len = t_bs-bb_off; // remaining bits in first block
-                uint16_t b_len_sum = 0;
-                do {
-                    res |= get_int(idx, b_len) << b_len_sum;
-                    idx += b_len;
-                    b_len_sum += b_len;
-                    len -= b_len;
-                    b_len = t_bs;
-                    b_len = std::min((uint16_t)len, b_len);
-                } while (len > 0);
+                res |= part << res_off;
+                res_off += b_len;
+                btnrp += btnrlen;
             }
             return res;
         }
@@ -486,6 +484,25 @@ class rank_support_rrr
             return rank(i);
         }
 
+        //! Answers n independent rank queries: out[j] = rank(idx[j]) for \f$j\in[0..n-1]\f$.
+        /*! The samples and then the block type numbers of a chunk of queries
+         *  are prefetched before the ranks are computed.
+         */
+        void rank_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            util::batch(n, [&](size_type j) {
+                size_type sample_pos = idx[j]/t_bs/t_k;
+                util::prefetch(m_v->m_rank, sample_pos);
+                util::prefetch(m_v->m_btnrp, sample_pos);
+                util::prefetch(m_v->m_invert, sample_pos);
+            }, [&](size_type j) {
+                size_type sample_pos = idx[j]/t_bs/t_k;
+                util::prefetch(m_v->m_btnr.data() + (m_v->m_btnrp[sample_pos]>>6));
+            }, [&](size_type j) {
+                out[j] = rank(idx[j]);
+            });
+        }
+
         //! Returns the size of the original vector
         const size_type size()const
         {
@@ -641,6 +658,14 @@ class select_support_rrr
             return  t_b ? select1(i) : select0(i);
         }
 
+        //! Answers n independent select queries: out[j] = select(idx[j]) for \f$j\in[0..n-1]\f$.
+        void select_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            for (size_type j=0; j < n; ++j) {
+                out[j] = select(idx[j]);
+            }
+        }
+
         const size_type operator()(size_type i)const
         {
             return select(i);
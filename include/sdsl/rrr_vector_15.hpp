@@ -538,6 +538,25 @@ class rank_support_rrr<t_b, 15, t_rac, t_k>
             return rank(i);
         }
 
+        //! Answers n independent rank queries: out[j] = rank(idx[j]) for \f$j\in[0..n-1]\f$.
+        /*! The samples and then the block type numbers of a chunk of queries
+         *  are prefetched before the ranks are computed.
+         */
+        void rank_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            util::batch(n, [&](size_type j) {
+                size_type sample_pos = idx[j]/bit_vector_type::block_size/t_k;
+                util::prefetch(m_v->m_rank, sample_pos);
+                util::prefetch(m_v->m_btnrp, sample_pos);
+                util::prefetch(m_v->m_bt, sample_pos*t_k);
+            }, [&](size_type j) {
+                size_type sample_pos = idx[j]/bit_vector_type::block_size/t_k;
+                util::prefetch(m_v->m_btnr.data() + (m_v->m_btnrp[sample_pos]>>6));
+            }, [&](size_type j) {
+                out[j] = rank(idx[j]);
+            });
+        }
+
         //! Returns the size of the original vector
         const size_type size()const
         {
@@ -591,12 +610,12 @@ class select_support_rrr<t_b, 15, t_rac, t_k>
         const bit_vector_type* m_v; //!< Pointer to the rank supported rrr_vector
 
         // TODO: hinted binary search
-        size_type  select1(size_type i)const
+        size_type  select1(size_type i, size_type begin, size_type end)const
         {
             if (m_v->m_rank[m_v->m_rank.size()-1] < i)
                 return size();
             //  (1) binary search for the answer in the rank_samples
-            size_type begin=0, end=m_v->m_rank.size()-1; // min included, max excluded
+            // begin and end delimit the searched sample blocks; min included, max excluded
             size_type idx, rank;
             // invariant:  m_rank[end]   >= i
             //             m_rank[begin]  < i
@@ -629,12 +648,12 @@ class select_support_rrr<t_b, 15, t_rac, t_k>
         }
 
         // TODO: hinted binary search
-        size_type  select0(size_type i)const
+        size_type  select0(size_type i, size_type begin, size_type end)const
         {
             if ((size()-m_v->m_rank[m_v->m_rank.size()-1]) < i)
                 return size();
             //  (1) binary search for the answer in the rank_samples
-            size_type begin=0, end=m_v->m_rank.size()-1; // min included, max excluded
+            // begin and end delimit the searched sample blocks; min included, max excluded
             size_type idx, rank;
             // invariant:  m_rank[end] >= i
             //             m_rank[begin] < i
@@ -665,7 +684,11 @@ class select_support_rrr<t_b, 15, t_rac, t_k>
             return (idx-1) * bit_vector_type::block_size + bits::sel(~((uint64_t)bi_type::nr_to_bin(bt, btnr)), i-rank);
         }
 
-
+        // number of arguments in the sample blocks before sample block idx
+        size_type args_before(size_type idx)const
+        {
+            return t_b ? m_v->m_rank[idx] : idx*bit_vector_type::block_size*t_k - m_v->m_rank[idx];
+        }
 
     public:
         select_support_rrr(const bit_vector_type* v=nullptr)
@@ -676,7 +699,49 @@ class select_support_rrr<t_b, 15, t_rac, t_k>
         //! Answers select queries
         size_type select(size_type i)const
         {
-            return  t_b ? select1(i) : select0(i);
+            return  t_b ? select1(i, 0, m_v->m_rank.size()-1) : select0(i, 0, m_v->m_rank.size()-1);
+        }
+
+        //! Answers n independent select queries: out[j] = select(idx[j]) for \f$j\in[0..n-1]\f$.
+        /*! The binary searches over the rank samples of a chunk of queries are
+         *  interleaved: the probes of all queries are prefetched before the
+         *  queries take their next step.
+         */
+        void select_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            size_type begin[util::batch_size], end[util::batch_size];
+            for (size_type b=0; b < n; b += util::batch_size) {
+                size_type cnt = std::min(n-b, (size_type)util::batch_size);
+                for (size_type j=0; j < cnt; ++j) {
+                    begin[j] = 0;
+                    end[j] = m_v->m_rank.size()-1;
+                }
+                bool searching = true;
+                while (searching) {
+                    for (size_type j=0; j < cnt; ++j) {
+                        util::prefetch(m_v->m_rank, (begin[j]+end[j])>>1);
+                    }
+                    searching = false;
+                    for (size_type j=0; j < cnt; ++j) {
+                        if (end[j]-begin[j] > 1) {
+                            size_type mid = (begin[j]+end[j]) >> 1;
+                            if (args_before(mid) >= idx[b+j]) {
+                                end[j] = mid;
+                            } else {
+                                begin[j] = mid;
+                            }
+                            searching |= (end[j]-begin[j] > 1);
+                        }
+                    }
+                }
+                for (size_type j=0; j < cnt; ++j) {
+                    util::prefetch(m_v->m_btnrp, begin[j]);
+                    util::prefetch(m_v->m_bt, begin[j]*t_k);
+                }
+                for (size_type j=0; j < cnt; ++j) {
+                    out[b+j] = t_b ? select1(idx[b+j], begin[j], end[j]) : select0(idx[b+j], begin[j], end[j]);
+                }
+            }
         }
 
 
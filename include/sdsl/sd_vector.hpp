@@ -25,6 +25,7 @@
 
 #include "int_vector.hpp"
 #include "select_support_mcl.hpp"
+#include "select_support_darray.hpp"
 #include "util.hpp"
 #include "iterators.hpp"
 
@@ -32,18 +33,34 @@
 namespace sdsl
 {
 
+//! Default select structure for the ones (t_b=1) or zeros (t_b=0) of the high part of sd_vector
+/*! A plain bit_vector is selected by select_support_darray, other
+ *  bitvectors by their own select structures.
+ */
+template<class t_hi_bit_vector, uint8_t t_b>
+struct sd_hi_select {
+    typedef typename std::conditional<t_b == 1,
+            typename t_hi_bit_vector::select_1_type,
+            typename t_hi_bit_vector::select_0_type>::type type;
+};
+
+template<uint8_t t_b>
+struct sd_hi_select<bit_vector, t_b> {
+    typedef select_support_darray<t_b> type;
+};
+
 // forward declaration needed for friend declaration
 template<uint8_t t_b          = 1,
          class t_hi_bit_vector= bit_vector,
-         class t_select_1     = typename t_hi_bit_vector::select_1_type,
-         class t_select_0     = typename t_hi_bit_vector::select_0_type>
+         class t_select_1     = typename sd_hi_select<t_hi_bit_vector, 1>::type,
+         class t_select_0     = typename sd_hi_select<t_hi_bit_vector, 0>::type>
 class rank_support_sd;  // in sd_vector
 
 // forward declaration needed for friend declaration
 template<uint8_t t_b          = 1,
          class t_hi_bit_vector= bit_vector,
-         class t_select_1     = typename t_hi_bit_vector::select_1_type,
-         class t_select_0     = typename t_hi_bit_vector::select_0_type>
+         class t_select_1     = typename sd_hi_select<t_hi_bit_vector, 1>::type,
+         class t_select_0     = typename sd_hi_select<t_hi_bit_vector, 0>::type>
 class select_support_sd;  // in sd_vector
 
 // forward declaration needed for friend declaration
@@ -124,10 +141,16 @@ class sd_vector_builder
  *                          the high part of the positions of the 1s.
  *  \tparam t_select_1      Type of the select structure which is used to select ones in HI.
  *  \tparam t_select_0      Type of the select structure which is used to select zeros in HI.
+ *
+ *  \par Select on HI
+ *       With the default bit_vector HI is selected by select_support_darray,
+ *       a sampled select with bounded scans (see sd_hi_select). Files written
+ *       with select_support_mcl on HI are read by
+ *       sd_vector<bit_vector, select_support_mcl<1>, select_support_mcl<0>>.
  */
 template<class t_hi_bit_vector = bit_vector,
-         class t_select_1     = typename t_hi_bit_vector::select_1_type,
-         class t_select_0     = typename t_hi_bit_vector::select_0_type>
+         class t_select_1     = typename sd_hi_select<t_hi_bit_vector, 1>::type,
+         class t_select_0     = typename sd_hi_select<t_hi_bit_vector, 0>::type>
 class sd_vector
 {
     public:
@@ -358,6 +381,67 @@ class sd_vector
             }
         }
 
+        //! Returns the position of the first one at or after position i.
+        /*! \param i A position with \f$ 0 \leq i \leq size() \f$.
+         *  \return The position of the first one in \f$[i..size()-1]\f$, or size() if there is none.
+         *  \par Time complexity
+         *       One select on the zeros of HI, a scan of the bucket of i and
+         *       a scan of the next word of HI; a select on the ones of HI only
+         *       if the next one lies further away.
+         */
+        size_type successor(size_type i)const
+        {
+            if (i >= m_size) {
+                return m_size;
+            }
+            size_type high_val = i >> m_wl;
+            size_type val_low  = i & bits::lo_set[m_wl];
+            size_type j = high_val ? m_high_0_select(high_val) + 1 : 0; // start of the bucket of i in HI
+            size_type r = j - high_val;                                  // ones before the bucket
+            while (r < m_low.size() and m_high[j] and m_low[r] < val_low) {
+                ++j; ++r;
+            }
+            if (r == m_low.size()) {
+                return m_size;
+            }
+            if (!m_high[j]) { // the (r+1)-th one lies in a later bucket
+                uint8_t len = std::min((size_type)64, m_high.size()-j);
+                uint64_t w = m_high.get_int(j, len);
+                j = w ? j + bits::lo(w) : m_high_1_select(r+1);
+            }
+            return ((j-r) << m_wl) + m_low[r];
+        }
+
+        //! Returns the position of the last one at or before position i.
+        /*! \param i A position with \f$ 0 \leq i < size() \f$.
+         *  \return The position of the last one in \f$[0..i]\f$, or size() if there is none.
+         *  \par Time complexity
+         *       Symmetric to successor.
+         */
+        size_type predecessor(size_type i)const
+        {
+            if (i >= m_size) {
+                return m_size;
+            }
+            size_type high_val = i >> m_wl;
+            size_type val_low  = i & bits::lo_set[m_wl];
+            size_type j = m_high_0_select(high_val + 1); // end of the bucket of i in HI
+            size_type r = j - high_val;                  // ones up to the end of the bucket
+            while (r > 0 and m_high[j-1] and m_low[r-1] > val_low) {
+                --j; --r;
+            }
+            if (r == 0) {
+                return m_size;
+            }
+            --j;
+            if (!m_high[j]) { // the r-th one lies in an earlier bucket
+                size_type start = j > 64 ? j-64 : 0;
+                uint64_t w = m_high.get_int(start, j-start);
+                j = w ? start + bits::hi(w) : m_high_1_select(r);
+            }
+            return ((j+1-r) << m_wl) + m_low[r-1];
+        }
+
         //! Swap method
         void swap(sd_vector& v)
         {
@@ -484,14 +568,11 @@ class rank_support_sd
             set_vector(v);
         }
 
-        size_type rank(size_type i)const
+    private:
+        // rank(i) given the position sel_high of the zero which ends the bucket of i in high
+        size_type rank(size_type i, size_type sel_high)const
         {
-            assert(m_v != nullptr);
-            assert(i <= m_v->size());
-            // split problem in two parts:
-            // (1) find  >=
             size_type high_val = (i >> (m_v->wl));
-            size_type sel_high = m_v->high_0_select(high_val + 1);
             size_type rank_low = sel_high - high_val; //
             if (0 == rank_low)
                 return rank_support_sd_trait<t_b>::adjust_rank(0, i);
@@ -505,6 +586,34 @@ class rank_support_sd
             return rank_support_sd_trait<t_b>::adjust_rank(rank_low+1, i);
         }
 
+    public:
+        size_type rank(size_type i)const
+        {
+            assert(m_v != nullptr);
+            assert(i <= m_v->size());
+            // split problem in two parts:
+            // (1) find  >=
+            size_type high_val = (i >> (m_v->wl));
+            return rank(i, m_v->high_0_select(high_val + 1));
+        }
+
+        //! Answers n independent rank queries: out[j] = rank(idx[j]) for \f$j\in[0..n-1]\f$.
+        /*! The select queries on the high part of a chunk of queries are answered
+         *  first; then the low entries before them are prefetched.
+         */
+        void rank_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            util::batch(n, [&](size_type j) {
+                out[j] = m_v->high_0_select((idx[j] >> (m_v->wl)) + 1);
+            }, [&](size_type j) {
+                // the high bits before out[j] are mostly in the cache line of the select answer
+                size_type rank_low = out[j] - (idx[j] >> (m_v->wl));
+                util::prefetch(m_v->low, rank_low-(rank_low>0));
+            }, [&](size_type j) {
+                out[j] = rank(idx[j], out[j]);
+            });
+        }
+
         size_type operator()(size_type i)const
         {
             return rank(i);
@@ -610,6 +719,21 @@ class select_support_sd
             return select_support_sd_trait<t_b, bit_vector_type>::select(i, m_v);
         }
 
+        //! Answers n independent select queries: out[j] = select(idx[j]) for \f$j\in[0..n-1]\f$.
+        /*! For select on ones the low entries of a chunk of queries are
+         *  prefetched before the answers are computed.
+         */
+        void select_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            util::batch(n, [&](size_type j) {
+                if (t_b) {
+                    util::prefetch(m_v->low, idx[j]-1);
+                }
+            }, [&](size_type j) {
+                out[j] = select(idx[j]);
+            });
+        }
+
         size_type operator()(size_type i)const
         {
             return select(i);
@@ -788,6 +912,14 @@ class select_0_support_sd
             return select(i);
         }
 
+        //! Answers n independent select queries: out[j] = select(idx[j]) for \f$j\in[0..n-1]\f$.
+        void select_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            for (size_type j=0; j < n; ++j) {
+                out[j] = select(idx[j]);
+            }
+        }
+
         size_type size()const
         {
             return m_v->size();
@@ -97,6 +97,12 @@ struct is_alphabet<t_alphabet, typename enable_if_type<typename t_alphabet::alph
     static const bool value = true;
 };
 
+//! Indicates if a CSA can be constructed from the BWT without a cached SA.
+template<class t_csa>
+struct csa_without_sa {
+    static const bool value = false;
+};
+
 } // end namespace sdsl
 
 #endif
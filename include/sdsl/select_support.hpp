@@ -79,9 +79,19 @@ class select_support
 
         //! This method sets the supported bit_vector
         virtual void set_vector(const int_vector<1>* v=nullptr) = 0;
+        //! Answers n independent select queries: out[j] = select(idx[j]) for \f$j\in[0..n-1]\f$.
+        /*! Supports which can prefetch their memory provide their own version.
+         */
+        void select_batch(const size_type* idx, size_type n, size_type* out)const
+        {
+            for (size_type j=0; j < n; ++j) {
+                out[j] = select(idx[j]);
+            }
+        }
 };
 
 
+// t_pdep of the ith_arg_pos functions is passed on to bits::sel_isa (see SDSL_SEL_VERSIONS)
 template<uint8_t bit_pattern, uint8_t pattern_len>
 struct select_support_trait {
     typedef select_support::size_type	size_type;
@@ -97,6 +107,7 @@ struct select_support_trait {
         return 0;
     }
 
+    template<bool t_pdep=false>
     static size_type ith_arg_pos_in_the_first_word(uint64_t, size_type, uint8_t, uint64_t)
     {
         return 0;
@@ -107,6 +118,7 @@ struct select_support_trait {
         return 0;
     }
 
+    template<bool t_pdep=false>
     static size_type ith_arg_pos_in_the_word(uint64_t, size_type, uint64_t)
     {
         return 0;
@@ -140,17 +152,19 @@ struct select_support_trait<0,1> {
     {
         return bits::cnt((~w)& bits::lo_unset[offset]);
     }
+    template<bool t_pdep=false>
     static size_type ith_arg_pos_in_the_first_word(uint64_t w, size_type i, uint8_t offset, uint64_t)
     {
-        return bits::sel(~w & bits::lo_unset[offset], (uint32_t) i);
+        return bits::sel_isa<t_pdep>(~w & bits::lo_unset[offset], (uint32_t) i);
     }
     static size_type args_in_the_word(uint64_t w, uint64_t&)
     {
         return bits::cnt(~w);
     }
+    template<bool t_pdep=false>
     static size_type ith_arg_pos_in_the_word(uint64_t w, size_type i, uint64_t)
     {
-        return bits::sel(~w, (uint32_t) i);
+        return bits::sel_isa<t_pdep>(~w, (uint32_t) i);
     }
     static bool found_arg(size_type i, const bit_vector& v)
     {
@@ -178,17 +192,19 @@ struct select_support_trait<1,1> {
     {
         return bits::cnt(w & bits::lo_unset[offset]);
     }
+    template<bool t_pdep=false>
     static size_type ith_arg_pos_in_the_first_word(uint64_t w, size_type i, uint8_t offset, uint64_t)
     {
-        return bits::sel(w & bits::lo_unset[offset], (uint32_t) i);
+        return bits::sel_isa<t_pdep>(w & bits::lo_unset[offset], (uint32_t) i);
     }
     static size_type args_in_the_word(uint64_t w, uint64_t&)
     {
         return bits::cnt(w);
     }
+    template<bool t_pdep=false>
     static size_type ith_arg_pos_in_the_word(uint64_t w, size_type i, uint64_t)
     {
-        return bits::sel(w, (uint32_t) i);
+        return bits::sel_isa<t_pdep>(w, (uint32_t) i);
     }
     static bool found_arg(size_type i, const bit_vector& v)
     {
@@ -216,17 +232,19 @@ struct select_support_trait<10,2> {
     {
         return bits::cnt(bits::map10(w, carry) & bits::lo_unset[offset]);
     }
+    template<bool t_pdep=false>
     static size_type ith_arg_pos_in_the_first_word(uint64_t w, size_type i, uint8_t offset, uint64_t carry)
     {
-        return bits::sel(bits::map10(w, carry) & bits::lo_unset[offset], (uint32_t) i);
+        return bits::sel_isa<t_pdep>(bits::map10(w, carry) & bits::lo_unset[offset], (uint32_t) i);
     }
     static size_type args_in_the_word(uint64_t w, uint64_t& carry)
     {
         return bits::cnt10(w, carry);
     }
+    template<bool t_pdep=false>
     static size_type ith_arg_pos_in_the_word(uint64_t w, size_type i, uint64_t carry)
     {
-        return bits::sel(bits::map10(w, carry), (uint32_t) i);
+        return bits::sel_isa<t_pdep>(bits::map10(w, carry), (uint32_t) i);
     }
     static bool found_arg(size_type i, const bit_vector& v)
     {
@@ -256,17 +274,19 @@ struct select_support_trait<01,2> {
     {
         return bits::cnt(bits::map01(w, carry) & bits::lo_unset[offset]);
     }
+    template<bool t_pdep=false>
     static size_type ith_arg_pos_in_the_first_word(uint64_t w, size_type i, uint8_t offset, uint64_t carry)
     {
-        return bits::sel(bits::map01(w, carry) & bits::lo_unset[offset], (uint32_t) i);
+        return bits::sel_isa<t_pdep>(bits::map01(w, carry) & bits::lo_unset[offset], (uint32_t) i);
     }
     static size_type args_in_the_word(uint64_t w, uint64_t& carry)
     {
         return bits::cnt01(w, carry);
     }
+    template<bool t_pdep=false>
     static size_type ith_arg_pos_in_the_word(uint64_t w, size_type i, uint64_t carry)
     {
-        return bits::sel(bits::map01(w, carry), (uint32_t) i);
+        return bits::sel_isa<t_pdep>(bits::map01(w, carry), (uint32_t) i);
     }
     static bool found_arg(size_type i, const bit_vector& v)
     {
@@ -315,17 +335,19 @@ struct select_support_trait<00,2> {
         return res;
     }
 
+    template<bool t_pdep=false>
     static size_type ith_arg_pos_in_the_first_word(uint64_t w, size_type i, uint8_t offset, uint64_t carry)
     {
-        return bits::sel((~(((w << 1) | carry) | w)) & bits::lo_unset[offset], i);
+        return bits::sel_isa<t_pdep>((~(((w << 1) | carry) | w)) & bits::lo_unset[offset], i);
     }
     static size_type args_in_the_word(uint64_t w, uint64_t& carry)
     {
         return rank_support_trait<00,2>::args_in_the_word(w, carry);
     }
+    template<bool t_pdep=false>
     static size_type ith_arg_pos_in_the_word(uint64_t w, size_type i, uint64_t carry)
     {
-        return bits::sel(~(((w << 1) | carry) | w), i);
+        return bits::sel_isa<t_pdep>(~(((w << 1) | carry) | w), i);
     }
     static bool found_arg(size_type i, const bit_vector& v)
     {
@@ -372,17 +394,19 @@ struct select_support_trait<11,2> {
         return res;
     }
 
+    template<bool t_pdep=false>
     static size_type ith_arg_pos_in_the_first_word(uint64_t w, size_type i, uint8_t offset, uint64_t carry)
     {
-        return bits::sel((((w << 1) | carry) & w) & bits::lo_unset[offset], i);
+        return bits::sel_isa<t_pdep>((((w << 1) | carry) & w) & bits::lo_unset[offset], i);
     }
     static size_type args_in_the_word(uint64_t w, uint64_t& carry)
     {
         return rank_support_trait<11,2>::args_in_the_word(w, carry);
     }
+    template<bool t_pdep=false>
     static size_type ith_arg_pos_in_the_word(uint64_t w, size_type i, uint64_t carry)
     {
-        return bits::sel(((w << 1) | carry) & w, i);
+        return bits::sel_isa<t_pdep>(((w << 1) | carry) & w, i);
     }
     static bool found_arg(size_type i, const bit_vector& v)
     {
@@ -406,5 +430,6 @@ struct select_support_trait<11,2> {
 
 #include "select_support_mcl.hpp"
 #include "select_support_scan.hpp"
+#include "select_support_darray.hpp"
 
 #endif
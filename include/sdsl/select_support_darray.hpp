@@ -0,0 +1,344 @@
+/*! \file select_support_darray.hpp
+    \brief select_support_darray.hpp contains a select support for a sdsl::bit_vector
+           which samples the positions of the arguments in a density dependent rate.
+*/
+#ifndef INCLUDED_SDSL_SELECT_SUPPORT_DARRAY
+#define INCLUDED_SDSL_SELECT_SUPPORT_DARRAY
+
+#include "int_vector.hpp"
+#include "util.hpp"
+#include "select_support.hpp"
+
+//! Namespace for the succinct data structure library.
+namespace sdsl
+{
+
+//! A select support which answers queries with one sample lookup and a bounded scan.
+/*!
+ * The position of every \f$s\f$-th argument (set bit for `t_b=1`, unset bit for
+ * `t_b=0`) is sampled, where \f$s\f$ is the power of two which makes the expected
+ * distance of two samples about 256 bits, i.e. half a cache line of the bit_vector.
+ * Samples are stored relative to an inventory entry which holds the absolute
+ * position of every 64th sample; the relative positions take
+ * \f$\log(64\cdot 256)\approx 14\f$ bits for uniformly distributed arguments.
+ *
+ * A group of \f$s\f$ arguments which spans more than \f$\max(s^2, 2^{12})\f$
+ * bits is long: the positions of all its arguments are stored explicitly.
+ * For the largest rate \f$s=256\f$ this is the \f$2^{16}\f$ bit threshold of
+ * the darray of Okanohara and Sadakane.
+ *
+ * \par Space usage
+ *      About \f$0.06n\f$ bits for uniformly distributed arguments.
+ *      The explicit positions of long groups add less than \f$n\log n/\min(s, 2^{12}/s)\f$
+ *      bits, i.e. at most \f$n\log n/64\f$ bits, and skewed distributions widen
+ *      the relative positions up to \f$\log n\f$ bits.
+ * \par Time complexity
+ *      A query reads the (cache resident) inventory, one relative sample and
+ *      either one explicit position or scans from the sample to the answer with
+ *      bits::cnt and bits::sel. The scan covers at most \f$\max(s^2, 2^{12})\f$
+ *      bits; for uniformly distributed arguments it rarely leaves the cache line of the sample.
+ *
+ * \tparam t_b Bit pattern `0` or `1` which should be selected.
+ *
+ * \par Reference
+ *      D. Okanohara, K. Sadakane: Practical Entropy-Compressed Rank/Select Dictionary.
+ *      ALENEX 2007.
+ *
+ *      S. Vigna: Broadword Implementation of Rank/Select Queries. WEA 2008.
+ *
+ * @ingroup select_support_group
+ */
+template<uint8_t t_b=1, uint8_t t_pat_len=1>
+class select_support_darray : public select_support
+{
+    private:
+        static_assert(t_b == 1u or t_b == 0u, "select_support_darray: bit pattern must be `0` or `1`");
+        static_assert(t_pat_len == 1u, "select_support_darray: bit pattern length must be 1");
+    public:
+        typedef bit_vector bit_vector_type;
+        enum { bit_pat = t_b };
+        enum { bit_pat_len = t_pat_len };
+    private:
+        size_type     m_arg_cnt = 0;
+        uint8_t       m_log_s   = 0; // log of the sample rate
+        int_vector<64> m_inventory;  // absolute position of every 64th sample
+        int_vector<>  m_samples;     // position of every sample relative to its inventory entry
+        int_vector<64> m_long_mask;  // bit k&63 of entry k>>6 is set if group k is long
+        int_vector<64> m_long_cnt;   // number of long groups before the 64 groups of an inventory entry
+        int_vector<>  m_long_pos;    // positions of the arguments of the long groups except the sampled one
+
+        static uint64_t arg_word(uint64_t x)
+        {
+            return t_b ? x : ~x;
+        }
+
+        // a group of s arguments is long if it spans more than max(s*s, min_long_span) bits
+        static const size_type min_long_span = 1ULL << 12;
+
+        void build(const bit_vector* v)
+        {
+            m_arg_cnt = 0;
+            m_log_s = 0;
+            m_inventory = int_vector<64>();
+            m_samples = int_vector<>();
+            m_long_mask = int_vector<64>();
+            m_long_cnt = int_vector<64>();
+            m_long_pos = int_vector<>();
+            if (v == nullptr) {
+                return;
+            }
+            m_arg_cnt = select_support_trait<t_b,t_pat_len>::arg_cnt(*v);
+            if (m_arg_cnt == 0) {
+                return;
+            }
+            // about one sample per half cache line (256 bits), rounded to the nearest power of two
+            size_type args_per_half_line = (m_arg_cnt*384)/v->size();
+            m_log_s = args_per_half_line ? bits::hi(args_per_half_line) : 0;
+            size_type s = 1ULL << m_log_s;
+            size_type sample_cnt = ((m_arg_cnt-1)>>m_log_s)+1;
+            int_vector<64> pos(sample_cnt+1);
+
+            const uint64_t* data = v->data();
+            size_type words = (v->size()+63)>>6;
+            size_type args = 0, next = 0; // next sample is argument next<<m_log_s (0-based)
+            for (size_type w=0; w < words; ++w) {
+                uint64_t x = word(data, w, v->size());
+                size_type c = bits::cnt(x);
+                while (next < sample_cnt and (next<<m_log_s) < args+c) {
+                    pos[next] = (w<<6) + bits::sel(x, (next<<m_log_s)-args+1);
+                    ++next;
+                }
+                if (args+c == m_arg_cnt) { // end of the last group
+                    pos[sample_cnt] = (w<<6) + bits::hi(x) + 1;
+                    break;
+                }
+                args += c;
+            }
+
+            size_type inv_cnt = (sample_cnt+63)>>6;
+            m_inventory = int_vector<64>(inv_cnt);
+            m_long_mask = int_vector<64>(inv_cnt, 0);
+            m_long_cnt  = int_vector<64>(inv_cnt, 0);
+            size_type max_rel = 0, long_cnt = 0;
+            size_type long_span = std::max(s*s, min_long_span);
+            for (size_type k=0; k < sample_cnt; ++k) {
+                if ((k&0x3F) == 0) {
+                    m_inventory[k>>6] = pos[k];
+                    m_long_cnt[k>>6] = long_cnt;
+                }
+                max_rel = std::max(max_rel, (size_type)(pos[k]-m_inventory[k>>6]));
+                if (s > 1 and pos[k+1]-pos[k] > long_span) {
+                    m_long_mask[k>>6] |= 1ULL << (k&0x3F);
+                    ++long_cnt;
+                }
+            }
+            m_samples = int_vector<>(sample_cnt, 0, bits::hi(max_rel)+1);
+            for (size_type k=0; k < sample_cnt; ++k) {
+                m_samples[k] = pos[k]-m_inventory[k>>6];
+            }
+
+            m_long_pos = int_vector<>(long_cnt*(s-1), 0, bits::hi(v->size())+1);
+            for (size_type k=0, l=0; l < long_cnt; ++k) {
+                if (!is_long(k)) {
+                    continue;
+                }
+                // collect the arguments of group k after its sample
+                size_type p = l*(s-1), end = p+std::min(s, m_arg_cnt-(k<<m_log_s))-1;
+                size_type w = pos[k]>>6;
+                uint64_t x = word(data, w, v->size()) & bits::lo_unset[(pos[k]&0x3F)+1];
+                while (p < end) {
+                    while (x == 0) {
+                        x = word(data, ++w, v->size());
+                    }
+                    m_long_pos[p++] = (w<<6) + bits::lo(x);
+                    x &= x-1;
+                }
+                ++l;
+            }
+        }
+
+        // the w-th word of the arguments of v, without the bits after the end of v
+        static uint64_t word(const uint64_t* data, size_type w, size_type n)
+        {
+            uint64_t x = arg_word(data[w]);
+            if (w == ((n-1)>>6)) {
+                x &= bits::lo_set[((n-1)&0x3F)+1];
+            }
+            return x;
+        }
+
+        bool is_long(size_type k)const
+        {
+            return (m_long_mask[k>>6] >> (k&0x3F)) & 1ULL;
+        }
+
+        // index of the first explicit position of the long group k
+        size_type long_idx(size_type k)const
+        {
+            return (m_long_cnt[k>>6] + bits::cnt(m_long_mask[k>>6] & bits::lo_set[k&0x3F])) * bits::lo_set[m_log_s];
+        }
+
+    public:
+        explicit select_support_darray(const bit_vector* v=nullptr) : select_support(v)
+        {
+            build(v);
+        }
+
+        select_support_darray(const select_support_darray& ss) : select_support(ss.m_v)
+        {
+            *this = ss;
+        }
+
+        select_support_darray(select_support_darray&& ss) : select_support(ss.m_v)
+        {
+            *this = std::move(ss);
+        }
+
+        select_support_darray& operator=(const select_support_darray& ss)
+        {
+            if (this != &ss) {
+                m_v         = ss.m_v;
+                m_arg_cnt   = ss.m_arg_cnt;
+                m_log_s     = ss.m_log_s;
+                m_inventory = ss.m_inventory;
+                m_samples   = ss.m_samples;
+                m_long_mask = ss.m_long_mask;
+                m_long_cnt  = ss.m_long_cnt;
+                m_long_pos  = ss.m_long_pos;
+            }
+            return *this;
+        }
+
+        select_support_darray& operator=(select_support_darray&& ss)
+        {
+            if (this != &ss) {
+                m_v         = ss.m_v;
+                m_arg_cnt   = ss.m_arg_cnt;
+                m_log_s     = ss.m_log_s;
+                m_inventory = std::move(ss.m_inventory);
+                m_samples   = std::move(ss.m_samples);
+                m_long_mask = std::move(ss.m_long_mask);
+                m_long_cnt  = std::move(ss.m_long_cnt);
+                m_long_pos  = std::move(ss.m_long_pos);
+            }
+            return *this;
+        }
+
+    private:
+        // used by select and select_batch; the virtual select cannot be versioned
+        template<bool t_pdep>
+        SDSL_SEL_IMPL size_type _select_isa(size_type i)const
+        {
+            --i;
+            size_type k   = i >> m_log_s;
+            size_type pos = m_inventory[k>>6] + m_samples[k];
+            size_type r   = i & bits::lo_set[m_log_s];
+            if (r == 0) {
+                return pos;
+            }
+            if (is_long(k)) {
+                return m_long_pos[long_idx(k) + r-1];
+            }
+            // the answer is the (r+1)-th argument starting at pos
+            const uint64_t* data = m_v->data() + (pos>>6);
+            uint64_t x = arg_word(*data) & bits::lo_unset[pos&0x3F];
+            size_type c = bits::cnt(x);
+            ++r;
+            while (c < r) {
+                r -= c;
+                x = arg_word(*(++data));
+                c = bits::cnt(x);
+            }
+            return ((data - m_v->data())<<6) + bits::sel_isa<t_pdep>(x, r);
+        }
+
+        SDSL_SEL_VERSIONS(_select_isa, (i), size_type _select(size_type i)const)
+
+        template<bool t_pdep>
+        SDSL_SEL_IMPL void select_batch_isa(const size_type* idx, size_type n, size_type* out)const
+        {
+            util::batch(n, [&](size_type j) {
+                size_type k = (idx[j]-1) >> m_log_s;
+                util::prefetch(m_inventory, k>>6);
+                util::prefetch(m_samples, k);
+                util::prefetch(m_long_mask, k>>6);
+            }, [&](size_type j) {
+                size_type k = (idx[j]-1) >> m_log_s;
+                size_type r = (idx[j]-1) & bits::lo_set[m_log_s];
+                if (r > 0 and is_long(k)) {
+                    util::prefetch(m_long_pos, long_idx(k) + r-1);
+                } else {
+                    util::prefetch(m_v->data() + ((m_inventory[k>>6] + m_samples[k])>>6));
+                }
+            }, [&](size_type j) {
+                out[j] = _select_isa<t_pdep>(idx[j]);
+            });
+        }
+
+    public:
+        //! Returns the position of the i-th argument, \f$ i\in [1..m] \f$.
+        inline size_type select(size_type i)const
+        {
+            return _select(i);
+        }
+
+        inline size_type operator()(size_type i)const
+        {
+            return select(i);
+        }
+
+        //! Answers n independent select queries: out[j] = select(idx[j]) for \f$j\in[0..n-1]\f$.
+        /*! The samples and then the bit_vector words of a chunk of queries
+         *  are prefetched before the answers are computed.
+         */
+        SDSL_SEL_VERSIONS(select_batch_isa, (idx, n, out),
+                          void select_batch(const size_type* idx, size_type n, size_type* out)const)
+
+        size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const
+        {
+            structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
+            size_type written_bytes = 0;
+            written_bytes += write_member(m_arg_cnt, out, child, "arg_cnt");
+            written_bytes += write_member(m_log_s, out, child, "log_s");
+            written_bytes += m_inventory.serialize(out, child, "inventory");
+            written_bytes += m_samples.serialize(out, child, "samples");
+            written_bytes += m_long_mask.serialize(out, child, "long_mask");
+            written_bytes += m_long_cnt.serialize(out, child, "long_cnt");
+            written_bytes += m_long_pos.serialize(out, child, "long_pos");
+            structure_tree::add_size(child, written_bytes);
+            return written_bytes;
+        }
+
+        void load(std::istream& in, const bit_vector* v=nullptr)
+        {
+            set_vector(v);
+            read_member(m_arg_cnt, in);
+            read_member(m_log_s, in);
+            m_inventory.load(in);
+            m_samples.load(in);
+            m_long_mask.load(in);
+            m_long_cnt.load(in);
+            m_long_pos.load(in);
+        }
+
+        void set_vector(const bit_vector* v=nullptr)
+        {
+            m_v = v;
+        }
+
+        void swap(select_support_darray& ss)
+        {
+            if (this != &ss) {
+                std::swap(m_arg_cnt, ss.m_arg_cnt);
+                std::swap(m_log_s, ss.m_log_s);
+                m_inventory.swap(ss.m_inventory);
+                m_samples.swap(ss.m_samples);
+                m_long_mask.swap(ss.m_long_mask);
+                m_long_cnt.swap(ss.m_long_cnt);
+                m_long_pos.swap(ss.m_long_pos);
+            }
+        }
+};
+
+} // end namespace
+#endif
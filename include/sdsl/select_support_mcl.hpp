@@ -86,6 +86,10 @@ class select_support_mcl : public select_support
         void copy(const select_support_mcl<t_b, t_pat_len>& ss);
         void initData();
         void init_fast(const bit_vector* v=nullptr);
+        template<bool t_pdep>
+        SDSL_SEL_IMPL size_type _select_isa(size_type i) const;
+        // the virtual select forwards to this one, which is compiled per instruction set
+        SDSL_SEL_VERSIONS(_select_isa, (i), size_type _select(size_type i) const)
     public:
         explicit select_support_mcl(const bit_vector* v=nullptr);
         select_support_mcl(const select_support_mcl<t_b,t_pat_len>& ss);
@@ -345,6 +349,13 @@ void select_support_mcl<t_b,t_pat_len>::init_fast(const bit_vector* v)
 
 template<uint8_t t_b, uint8_t t_pat_len>
 inline auto select_support_mcl<t_b,t_pat_len>::select(size_type i)const -> size_type
+{
+    return _select(i);
+}
+
+template<uint8_t t_b, uint8_t t_pat_len>
+template<bool t_pdep>
+SDSL_SEL_IMPL auto select_support_mcl<t_b,t_pat_len>::_select_isa(size_type i)const -> size_type
 {
     assert(i > 0 and i <= m_arg_cnt);
 
@@ -372,7 +383,7 @@ inline auto select_support_mcl<t_b,t_pat_len>::select(size_type i)const -> size_
             size_type args = select_support_trait<t_b,t_pat_len>::args_in_the_first_word(*data, word_off, carry);
 
             if (args >= i) {
-                return (word_pos<<6)+select_support_trait<t_b,t_pat_len>::ith_arg_pos_in_the_first_word(*data, i, word_off, carry);
+                return (word_pos<<6)+select_support_trait<t_b,t_pat_len>::template ith_arg_pos_in_the_first_word<t_pdep>(*data, i, word_off, carry);
             }
             word_pos+=1;
             size_type sum_args = args;
@@ -387,7 +398,7 @@ inline auto select_support_mcl<t_b,t_pat_len>::select(size_type i)const -> size_
                 word_pos+=1;
             }
             return (word_pos<<6) +
-                   select_support_trait<t_b,t_pat_len>::ith_arg_pos_in_the_word(*data, i-sum_args, old_carry);
+                   select_support_trait<t_b,t_pat_len>::template ith_arg_pos_in_the_word<t_pdep>(*data, i-sum_args, old_carry);
         }
     }
 }
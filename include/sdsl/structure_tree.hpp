@@ -7,6 +7,7 @@
 
 #include "uintx_t.hpp"
 #include <unordered_map>
+#include <map>
 #include <string>
 #include <iostream>
 #include <sstream>
@@ -27,6 +28,7 @@ class structure_tree_node
         size_t              size = 0;
         std::string         name;
         std::string         type;
+        std::map<std::string,uint64_t> counters; // query counters, see query_stats.hpp
     public:
         structure_tree_node(const std::string& n, const std::string& t) : name(n) , type(t) {}
         structure_tree_node* add_child(const std::string& n, const std::string& t) {
@@ -43,6 +45,7 @@ class structure_tree_node
             }
         }
         void add_size(size_t s) { size += s; }
+        void add_counter(const std::string& n, uint64_t value) { counters[n] += value; }
 };
 
 class structure_tree
@@ -55,6 +58,9 @@ class structure_tree
         static void add_size(structure_tree_node* v, uint64_t value) {
             if (v) v->add_size(value);
         };
+        static void add_counter(structure_tree_node* v, const std::string& name, uint64_t value) {
+            if (v) v->add_counter(name,value);
+        };
 };
 
 
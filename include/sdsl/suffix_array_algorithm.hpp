@@ -531,6 +531,40 @@ t_rac locate(
     return occ;
 }
 
+//! Calculates all occurrences of a pattern pat in a CSA and writes them to occ.
+/*!
+ * \tparam t_csa      CSA type.
+ * \tparam t_pat_iter Pattern iterator type.
+ * \tparam t_rac      Resizeable random access container.
+ *
+ * \param csa   The CSA object.
+ * \param begin Iterator to the begin of the pattern (inclusive).
+ * \param end   Iterator to the end of the pattern (exclusive).
+ * \param occ   Container which holds the occurrences after the call.
+ * \return The number of occurrences.
+ *
+ * \par Allocation
+ *      occ is resized to the number of occurrences. A std::vector keeps its
+ *      capacity, so repeated queries with the same vector do not allocate.
+ */
+template<class t_csa, class t_pat_iter, class t_rac>
+typename t_csa::size_type locate(
+    const t_csa&  csa,
+    t_pat_iter begin,
+    t_pat_iter end,
+    t_rac& occ,
+    SDSL_UNUSED typename std::enable_if<std::is_same<csa_tag, typename t_csa::index_category>::value, csa_tag>::type x = csa_tag()
+)
+{
+    typename t_csa::size_type occ_begin, occ_end, occs;
+    occs = backward_search(csa, 0, csa.size()-1, begin, end, occ_begin, occ_end);
+    occ.resize(occs);
+    for (typename t_csa::size_type i=0; i < occs; ++i) {
+        occ[i] = csa[occ_begin+i];
+    }
+    return occs;
+}
+
 //! Calculates all occurrences of a pattern pat in a CSA/CST.
 /*!
  * \tparam t_csa      CSA/CST type.
@@ -155,6 +155,26 @@ t_rac locate(
     return locate(cst.csa, begin, end);
 }
 
+//! Calculates all occurrences of a pattern pat in a CST and writes them to occ.
+/*!
+ * \param cst   The CST object.
+ * \param begin Iterator to the begin of the pattern (inclusive).
+ * \param end   Iterator to the end of the pattern (exclusive).
+ * \param occ   Container which holds the occurrences after the call.
+ * \return The number of occurrences.
+ */
+template<class t_cst, class t_pat_iter, class t_rac>
+typename t_cst::size_type locate(
+    const t_cst& cst,
+    t_pat_iter begin,
+    t_pat_iter end,
+    t_rac& occ,
+    SDSL_UNUSED typename std::enable_if<std::is_same<cst_tag, typename t_cst::index_category>::value, cst_tag>::type x = cst_tag()
+)
+{
+    return locate(cst.csa, begin, end, occ);
+}
+
 //! Calculate the concatenation of edge labels from the root to the node v of a CST.
 /*!
  * \tparam t_cst       CST type.
@@ -320,6 +320,53 @@ void init_support(S& s, const X* x)
     s.set_vector(x); // set the support object's  pointer to x
 }
 
+//! Hint to load the cache line which contains address p.
+inline void prefetch(const void* p)
+{
+#ifndef MSVC_COMPILER
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+}
+
+//! Hint to load the cache line which contains element i of the int_vector v.
+template<class t_int_vec>
+inline void prefetch(const t_int_vec& v, uint64_t i)
+{
+    prefetch(v.data() + ((i*v.width())>>6));
+}
+
+//! Number of queries which are processed together by util::batch.
+const uint64_t batch_size = 16;
+
+inline void batch_stages(uint64_t, uint64_t) {}
+
+template<class t_stage, class... t_stages>
+inline void batch_stages(uint64_t begin, uint64_t end, t_stage& stage, t_stages& ... stages)
+{
+    for (uint64_t j=begin; j < end; ++j) {
+        stage(j);
+    }
+    batch_stages(begin, end, stages...);
+}
+
+//! Answers n independent queries stage by stage.
+/*! \param n      Number of queries.
+ *  \param stages Functions which are called with the query number j in [0..n-1].
+ *  The queries are processed in chunks of util::batch_size. Each stage is
+ *  applied to all queries of a chunk before the next stage starts. Stages
+ *  which prefetch the memory of the next stage therefore overlap the cache
+ *  misses of the queries of a chunk.
+ */
+template<class... t_stages>
+inline void batch(uint64_t n, t_stages... stages)
+{
+    for (uint64_t begin=0; begin < n; begin += batch_size) {
+        batch_stages(begin, std::min(n, begin+batch_size), stages...);
+    }
+}
+
 class spin_lock
 {
     private:
@@ -522,10 +569,9 @@ typename t_int_vec::size_type util::cnt_one_bits(const t_int_vec& v)
     const uint64_t* data = v.data();
     if (v.empty())
         return 0;
-    typename t_int_vec::size_type result = bits::cnt(*data);
-    for (typename t_int_vec::size_type i=1; i < (v.capacity()>>6); ++i) {
-        result += bits::cnt(*(++data));
-    }
+    typename t_int_vec::size_type words = v.capacity()>>6;
+    typename t_int_vec::size_type result = bits::cnt(data, words);
+    data += words-1;
     if (v.bit_size()&0x3F) {
         result -= bits::cnt((*data) & (~bits::lo_set[v.bit_size()&0x3F]));
     }
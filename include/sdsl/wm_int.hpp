@@ -27,6 +27,7 @@
 #include "rank_support_v.hpp"
 #include "select_support_mcl.hpp"
 #include "wt_helper.hpp"
+#include "query_context.hpp"
 #include "util.hpp"
 #include <set> // for calculating the alphabet size
 #include <map> // for mapping a symbol to its lexicographical index
@@ -454,10 +455,44 @@ class wm_int
             return make_pair(cnt_answers, point_vec);
         }
 
+        //! range_search_2d searches points in the index interval [lb..rb] and value interval [vlb..vrb].
+        /*! Version which writes the points to point_vec and takes its scratch
+         *  memory from ctx. Repeated calls with the same point_vec and ctx do
+         *  not allocate.
+         *  \param lb        Left bound of index interval (inclusive)
+         *  \param rb        Right bound of index interval (inclusive)
+         *  \param vlb       Left bound of value interval (inclusive)
+         *  \param vrb       Right bound of value interval (inclusive)
+         *  \param point_vec Holds the points after the call (empty if report = false).
+         *  \param ctx       Query context which is reset by the call.
+         *  \param report    Should the matching points be returned?
+         *  \return The number of found points.
+         */
+        size_type
+        range_search_2d(size_type lb, size_type rb, value_type vlb, value_type vrb,
+                        point_vec_type& point_vec, query_context& ctx, bool report=true) const
+        {
+            point_vec.clear();
+            if (vrb > (1ULL << m_max_level))
+                vrb = (1ULL << m_max_level);
+            if (vlb > vrb)
+                return 0;
+            size_type cnt_answers = 0;
+            if (lb <= rb) {
+                ctx.reset();
+                arena_vector<size_type> is(m_max_level+1, 0, arena_allocator<size_type>(ctx));
+                arena_vector<size_type> rank_off(m_max_level+1, 0, arena_allocator<size_type>(ctx));
+                _range_search_2d(root(), {lb, rb}, vlb, vrb, 0, is,
+                                 rank_off, point_vec, report, cnt_answers);
+            }
+            return cnt_answers;
+        }
+
+        template<class t_vec>
         void
         _range_search_2d(node_type v, range_type r, value_type vlb,
-                         value_type vrb, size_type ilb, std::vector<size_type>& is,
-                         std::vector<size_type>& rank_off, point_vec_type& point_vec,
+                         value_type vrb, size_type ilb, t_vec& is,
+                         t_vec& rank_off, point_vec_type& point_vec,
                          bool report, size_type& cnt_answers)
         const
         {
@@ -2,8 +2,10 @@
 #define INCLUDED_SDSL_WT_ALGORITHM
 
 #include <algorithm>
+#include <tuple>
 #include <utility>
 #include "wt_helper.hpp"
+#include "query_context.hpp"
 
 namespace sdsl
 {
@@ -17,6 +19,21 @@ struct _interval_symbols_wt;
 template<typename, typename T>
 struct has_expand;
 
+template<class t_wt, class t_res, class t_stack, class t_ranges>
+void
+_intersect(const t_wt& wt, const std::vector<range_type>& ranges, typename t_wt::size_type t,
+           t_res& res, t_stack& stack, t_ranges& rs, t_ranges& left);
+
+template <class t_wt, class t_res, class t_stack>
+void
+_restricted_unique_range_values(const t_wt& wt,
+                                typename t_wt::size_type x_i,
+                                typename t_wt::size_type x_j,
+                                typename t_wt::value_type y_i,
+                                typename t_wt::value_type y_j,
+                                t_res& unique_values,
+                                t_stack& stack);
+
 //! Intersection of elements in WT[s_0,e_0], WT[s_1,e_1],...,WT[s_k,e_k]
 /*! \param wt     The wavelet tree object.
  *  \param ranges The ranges.
@@ -31,58 +48,106 @@ template<class t_wt>
 std::vector< std::pair<typename t_wt::value_type, typename t_wt::size_type> >
 intersect(const t_wt& wt, const std::vector<range_type>& ranges, typename t_wt::size_type t=0)
 {
-    using std::get;
     using size_type      = typename t_wt::size_type;
     using value_type     = typename t_wt::value_type;
     using node_type      = typename t_wt::node_type;
-    using pnvr_type      = std::pair<node_type, range_vec_type>;
-    typedef std::stack<pnvr_type> stack_type;
+    using entry_type     = std::tuple<node_type, size_type, size_type>;
 
-    static_assert(has_expand<t_wt, std::array<node_type,2>(const node_type&)>::value,
-                  "intersect requires t_wt to have expand(const node_type&)");
+    std::vector<std::pair<value_type,size_type>> res;
+    std::vector<entry_type> stack;
+    range_vec_type rs, left;
+    _intersect(wt, ranges, t, res, stack, rs, left);
+    return res;
+}
 
-    using p_t = std::pair<value_type,size_type>;
-    std::vector<p_t> res;
+//! Intersection of elements in WT[s_0,e_0], WT[s_1,e_1],...,WT[s_k,e_k]
+/*! Version of intersect which writes the result to res and takes its scratch
+ *  memory from ctx. Repeated calls with the same res and ctx do not allocate.
+ *  \param wt     The wavelet tree object.
+ *  \param ranges The ranges.
+ *  \param t      Threshold in how many distinct ranges the value has to be
+ *                present. t=0 equals t=ranges.size().
+ *  \param res    Holds the (value, frequency) pairs after the call.
+ *  \param ctx    Query context which is reset by the call.
+ */
+template<class t_wt>
+void
+intersect(const t_wt& wt, const std::vector<range_type>& ranges, typename t_wt::size_type t,
+          std::vector< std::pair<typename t_wt::value_type, typename t_wt::size_type> >& res,
+          query_context& ctx)
+{
+    using size_type      = typename t_wt::size_type;
+    using node_type      = typename t_wt::node_type;
+    using entry_type     = std::tuple<node_type, size_type, size_type>;
 
-    auto push_node = [&wt,&t](stack_type& s, node_type& child,
-    range_vec_type& child_range) {
-        auto end = std::remove_if(child_range.begin(), child_range.end(),
-        [&](const range_type& x) { return empty(x);});
-        if (end > child_range.begin() + t - 1) {
-            s.emplace(pnvr_type(child, range_vec_type(child_range.begin(),
-                                end)));
-        }
-    };
+    ctx.reset();
+    arena_vector<entry_type> stack((arena_allocator<entry_type>(ctx)));
+    arena_vector<range_type> rs((arena_allocator<range_type>(ctx)));
+    arena_vector<range_type> left((arena_allocator<range_type>(ctx)));
+    _intersect(wt, ranges, t, res, stack, rs, left);
+}
 
+// Depth-first traversal of intersect. The ranges of the node of stack entry
+// (v, b, e) are rs[b..e-1]; left is a buffer for the ranges of left children.
+// The ranges of the children of a node are appended after the ranges of its
+// right sibling, so rs is truncated to e when (v, b, e) is popped and its
+// size is bounded by the depth of the tree times the number of ranges.
+template<class t_wt, class t_res, class t_stack, class t_ranges>
+void
+_intersect(const t_wt& wt, const std::vector<range_type>& ranges, typename t_wt::size_type t,
+           t_res& res, t_stack& stack, t_ranges& rs, t_ranges& left)
+{
+    using std::get;
+    using size_type      = typename t_wt::size_type;
+    using node_type      = typename t_wt::node_type;
+
+    static_assert(has_expand<t_wt, std::array<node_type,2>(const node_type&)>::value,
+                  "intersect requires t_wt to have expand(const node_type&)");
+
+    res.clear();
     if (ranges.empty())
-        return res;
+        return;
 
     t = (t==0) ? ranges.size() : t;
 
-    std::stack<pnvr_type> stack;
-    stack.emplace(pnvr_type(wt.root(), ranges));
+    rs.assign(ranges.begin(), ranges.end());
+    stack.emplace_back(wt.root(), 0, rs.size());
 
     while (!stack.empty()) {
-        pnvr_type x = stack.top(); stack.pop();
-
-        if (wt.is_leaf(x.first)) {
-            const auto& iv = x.second;
-            if (t <= iv.size()) {
-                auto freq = std::accumulate(iv.begin(), iv.end(), 0ULL,
-                [](size_type acc, const range_type& r) {
-                    return acc+(r[1]-r[0]+1);
-                });
-                res.emplace_back(wt.sym(x.first),freq);
+        node_type v = get<0>(stack.back());
+        size_type b = get<1>(stack.back());
+        size_type e = get<2>(stack.back());
+        stack.pop_back();
+        rs.resize(e);
+
+        if (wt.is_leaf(v)) {
+            if (t <= e-b) {
+                size_type freq = 0;
+                for (size_type i=b; i < e; ++i) {
+                    freq += rs[i][1]-rs[i][0]+1;
+                }
+                res.emplace_back(wt.sym(v), freq);
             }
         } else {
-            auto child        = wt.expand(x.first);
-            auto child_ranges = wt.expand(x.first, x.second);
-
-            push_node(stack, get<1>(child), get<1>(child_ranges));
-            push_node(stack, get<0>(child), get<0>(child_ranges));
+            auto child = wt.expand(v);
+            left.clear();
+            for (size_type i=b; i < e; ++i) {
+                range_type r = rs[i];
+                auto child_ranges = wt.expand(v, r);
+                if (!empty(get<0>(child_ranges)))
+                    left.push_back(get<0>(child_ranges));
+                if (!empty(get<1>(child_ranges)))
+                    rs.push_back(get<1>(child_ranges));
+            }
+            size_type left_b = rs.size();
+            rs.insert(rs.end(), left.begin(), left.end());
+            // the left child is processed first
+            if (left_b-e >= t)
+                stack.emplace_back(get<1>(child), e, left_b);
+            if (rs.size()-left_b >= t)
+                stack.emplace_back(get<0>(child), left_b, rs.size());
         }
     }
-    return res;
 }
 
 
@@ -513,21 +578,65 @@ restricted_unique_range_values(const t_wt& wt,
                                typename t_wt::value_type y_i,
                                typename t_wt::value_type y_j)
 {
-    static_assert(t_wt::lex_ordered, "restricted_unique_range_values requires a lex_ordered WT");
-
+    typedef std::tuple<typename t_wt::node_type,sdsl::range_type,uint64_t,uint64_t> entry_type;
     std::vector<typename t_wt::value_type> unique_values;
+    std::vector<entry_type> stack;
+    _restricted_unique_range_values(wt, x_i, x_j, y_i, y_j, unique_values, stack);
+    return unique_values;
+}
 
+//! Returns for a x range [x_i,x_j] and a value range [y_i,y_j] all unique y
+//! values occuring in [x_i,x_j] in ascending order.
+/*! Version which writes the values to unique_values and takes its scratch
+ *  memory from ctx. Repeated calls with the same unique_values and ctx do
+ *  not allocate.
+ *  \param x_i lower bound of the x range
+ *  \param x_j upper bound of the x range
+ *  \param y_i lower bound of the y range
+ *  \param y_j upper bound of the y range
+ *  \param unique_values Holds the increasing y values after the call.
+ *  \param ctx Query context which is reset by the call.
+ */
+template <class t_wt>
+void
+restricted_unique_range_values(const t_wt& wt,
+                               typename t_wt::size_type x_i,
+                               typename t_wt::size_type x_j,
+                               typename t_wt::value_type y_i,
+                               typename t_wt::value_type y_j,
+                               std::vector<typename t_wt::value_type>& unique_values,
+                               query_context& ctx)
+{
+    typedef std::tuple<typename t_wt::node_type,sdsl::range_type,uint64_t,uint64_t> entry_type;
+    ctx.reset();
+    arena_vector<entry_type> stack((arena_allocator<entry_type>(ctx)));
+    _restricted_unique_range_values(wt, x_i, x_j, y_i, y_j, unique_values, stack);
+}
+
+template <class t_wt, class t_res, class t_stack>
+void
+_restricted_unique_range_values(const t_wt& wt,
+                                typename t_wt::size_type x_i,
+                                typename t_wt::size_type x_j,
+                                typename t_wt::value_type y_i,
+                                typename t_wt::value_type y_j,
+                                t_res& unique_values,
+                                t_stack& stack)
+{
+    static_assert(t_wt::lex_ordered, "restricted_unique_range_values requires a lex_ordered WT");
+
+    unique_values.clear();
     // make sure things are within bounds
     if (x_j > wt.size()-1) x_j = wt.size()-1;
     if ((x_i > x_j) || (y_i > y_j)) {
-        return unique_values;
+        return;
     }
     auto lower_y_bound = symbol_gte(wt,y_i);
     auto upper_y_bound = symbol_lte(wt,y_j);
     // is the y range valid?
     if (!lower_y_bound.first || !upper_y_bound.first
         || (lower_y_bound.second > upper_y_bound.second))  {
-        return unique_values;
+        return;
     }
 
     auto lower_y_bound_path = wt.path(lower_y_bound.second);
@@ -548,11 +657,10 @@ restricted_unique_range_values(const t_wt& wt,
         return 0;
     };
 
-    std::stack<std::tuple<typename t_wt::node_type,sdsl::range_type,uint64_t,uint64_t>> stack;
     sdsl::range_type initial_range = {x_i,x_j};
-    stack.emplace(wt.root(),initial_range,0,0);
+    stack.emplace_back(wt.root(),initial_range,0,0);
     while (!stack.empty()) {
-        auto node_data = stack.top(); stack.pop();
+        auto node_data = stack.back(); stack.pop_back();
         auto node = std::get<0>(node_data);
         auto range = std::get<1>(node_data);
         auto node_path = std::get<2>(node_data);
@@ -568,18 +676,16 @@ restricted_unique_range_values(const t_wt& wt,
                 auto right_child = std::get<1>(children);
                 auto right_range = std::get<1>(child_ranges);
                 if (!sdsl::empty(right_range))
-                    stack.emplace(right_child,right_range,right_path,node_level+1);
+                    stack.emplace_back(right_child,right_range,right_path,node_level+1);
             }
             if (compare_path(left_path,node_level+1,lower_y_bound_path) > -1) {
                 auto left_child = std::get<0>(children);
                 auto left_range = std::get<0>(child_ranges);
                 if (!sdsl::empty(left_range))
-                    stack.emplace(left_child,left_range,left_path,node_level+1);
+                    stack.emplace_back(left_child,left_range,left_path,node_level+1);
             }
         }
     }
-
-    return unique_values;
 }
 
 
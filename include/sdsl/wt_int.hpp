@@ -28,6 +28,8 @@
 #include "rank_support_v.hpp"
 #include "select_support_mcl.hpp"
 #include "wt_helper.hpp"
+#include "query_stats.hpp"
+#include "query_context.hpp"
 #include "util.hpp"
 #include <set> // for calculating the alphabet size
 #include <map> // for mapping a symbol to its lexicographical index
@@ -88,6 +90,9 @@ class wt_int
         select_1_type          m_tree_select1; // select support for the wavelet tree bit vector
         select_0_type          m_tree_select0;
         uint32_t               m_max_level = 0;
+#ifdef SDSL_QUERY_STATS
+        query_counters<wt_query_stats::COUNTERS> m_query_stats;
+#endif
 
         void copy(const wt_int& wt) {
             m_size          = wt.m_size;
@@ -321,10 +326,12 @@ class wt_int
          */
         value_type operator[](size_type i)const {
             assert(i < size());
+            SDSL_QUERY_COUNT(m_query_stats, wt_query_stats::ACCESS);
             size_type offset = 0;
             value_type res = 0;
             size_type node_size = m_size;
             for (uint32_t k=0; k < m_max_level; ++k) {
+                SDSL_QUERY_COUNT_LEVEL(m_query_stats, wt_query_stats::LEVEL_RANK, k);
                 res <<= 1;
                 size_type ones_before_o   = m_tree_rank(offset);
                 size_type ones_before_i   = m_tree_rank(offset + i) - ones_before_o;
@@ -355,6 +362,7 @@ class wt_int
          */
         size_type rank(size_type i, value_type c)const {
             assert(i <= size());
+            SDSL_QUERY_COUNT(m_query_stats, wt_query_stats::RANK);
             if (((1ULL)<<(m_max_level))<=c) { // c is greater than any symbol in wt
                 return 0;
             }
@@ -362,6 +370,7 @@ class wt_int
             uint64_t mask = (1ULL) << (m_max_level-1);
             size_type node_size = m_size;
             for (uint32_t k=0; k < m_max_level and i; ++k) {
+                SDSL_QUERY_COUNT_LEVEL(m_query_stats, wt_query_stats::LEVEL_RANK, k);
                 size_type ones_before_o   = m_tree_rank(offset);
                 size_type ones_before_i   = m_tree_rank(offset + i) - ones_before_o;
                 size_type ones_before_end = m_tree_rank(offset + node_size) - ones_before_o;
@@ -391,10 +400,12 @@ class wt_int
         std::pair<size_type, value_type>
         inverse_select(size_type i)const {
             assert(i < size());
+            SDSL_QUERY_COUNT(m_query_stats, wt_query_stats::INVERSE_SELECT);
 
             value_type c = 0;
             size_type node_size = m_size, offset = 0;
             for (uint32_t k=0; k < m_max_level; ++k) {
+                SDSL_QUERY_COUNT_LEVEL(m_query_stats, wt_query_stats::LEVEL_RANK, k);
                 size_type ones_before_o   = m_tree_rank(offset);
                 size_type ones_before_i   = m_tree_rank(offset + i) - ones_before_o;
                 size_type ones_before_end = m_tree_rank(offset + node_size) - ones_before_o;
@@ -424,6 +435,7 @@ class wt_int
          */
         size_type select(size_type i, value_type c)const {
             assert(1 <= i and i <= rank(size(), c));
+            SDSL_QUERY_COUNT(m_query_stats, wt_query_stats::SELECT);
             // possible optimization: if the array is a permutation we can start at the bottom of the tree
             size_type offset = 0;
             uint64_t mask    = (1ULL) << (m_max_level-1);
@@ -433,6 +445,7 @@ class wt_int
             m_path_off[0] = m_path_rank_off[0] = 0;
 
             for (uint32_t k=0; k < m_max_level and node_size; ++k) {
+                SDSL_QUERY_COUNT_LEVEL(m_query_stats, wt_query_stats::LEVEL_RANK, k);
                 size_type ones_before_o   = m_tree_rank(offset);
                 m_path_rank_off[k] = ones_before_o;
                 size_type ones_before_end = m_tree_rank(offset + node_size) - ones_before_o;
@@ -452,6 +465,7 @@ class wt_int
             }
             mask = 1ULL;
             for (uint32_t k=m_max_level; k>0; --k) {
+                SDSL_QUERY_COUNT_LEVEL(m_query_stats, wt_query_stats::LEVEL_SELECT, k-1);
                 offset = m_path_off[k-1];
                 size_type ones_before_o = m_path_rank_off[k-1];
                 if (c & mask) { // right child => search i'th
@@ -619,10 +633,40 @@ class wt_int
             return make_pair(cnt_answers, point_vec);
         }
 
+        //! range_search_2d searches points in the index interval [lb..rb] and value interval [vlb..vrb].
+        /*! Version which writes the points to point_vec and takes its scratch
+         *  memory from ctx. Repeated calls with the same point_vec and ctx do
+         *  not allocate.
+         *  \param lb        Left bound of index interval (inclusive)
+         *  \param rb        Right bound of index interval (inclusive)
+         *  \param vlb       Left bound of value interval (inclusive)
+         *  \param vrb       Right bound of value interval (inclusive)
+         *  \param point_vec Holds the points after the call (empty if report = false).
+         *  \param ctx       Query context which is reset by the call.
+         *  \param report    Should the matching points be returned?
+         *  \return The number of found points.
+         */
+        size_type
+        range_search_2d(size_type lb, size_type rb, value_type vlb, value_type vrb,
+                        point_vec_type& point_vec, query_context& ctx, bool report=true) const {
+            point_vec.clear();
+            if (vrb > (1ULL << m_max_level))
+                vrb = (1ULL << m_max_level);
+            if (vlb > vrb)
+                return 0;
+            ctx.reset();
+            arena_vector<size_type> offsets(m_max_level+1, 0, arena_allocator<size_type>(ctx));
+            arena_vector<size_type> ones_before_os(m_max_level+1, 0, arena_allocator<size_type>(ctx));
+            size_type cnt_answers = 0;
+            _range_search_2d(lb, rb, vlb, vrb, 0, 0, m_size, offsets, ones_before_os, 0, point_vec, report, cnt_answers);
+            return cnt_answers;
+        }
+
+        template<class t_vec>
         void
         _range_search_2d(size_type lb, size_type rb, value_type vlb, value_type vrb, size_type level,
-                         size_type ilb, size_type node_size, std::vector<size_type>& offsets,
-                         std::vector<size_type>& ones_before_os, size_type path,
+                         size_type ilb, size_type node_size, t_vec& offsets,
+                         t_vec& ones_before_os, size_type path,
                          point_vec_type& point_vec, bool report, size_type& cnt_answers)
         const {
             if (lb > rb)
@@ -700,6 +744,7 @@ class wt_int
             written_bytes += m_tree_select1.serialize(out, child, "tree_select_1");
             written_bytes += m_tree_select0.serialize(out, child, "tree_select_0");
             written_bytes += write_member(m_max_level, out, child, "max_level");
+            SDSL_QUERY_STATS_ONLY(m_query_stats.add_to(child, wt_query_stats::name);)
             structure_tree::add_size(child, written_bytes);
             return written_bytes;
         }
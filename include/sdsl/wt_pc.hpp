@@ -26,6 +26,7 @@
 #include "rank_support.hpp"
 #include "select_support.hpp"
 #include "wt_helper.hpp"
+#include "query_stats.hpp"
 #include <vector>
 #include <utility>
 #include <tuple>
@@ -91,6 +92,9 @@ class wt_pc
         select_1_type    m_bv_select1;   // select support for the wavelet tree bit vector
         select_0_type    m_bv_select0;
         tree_strat_type  m_tree;
+#ifdef SDSL_QUERY_STATS
+        query_counters<wt_query_stats::COUNTERS> m_query_stats;
+#endif
 
         void copy(const wt_pc& wt)
         {
@@ -327,10 +331,13 @@ class wt_pc
         value_type operator[](size_type i)const
         {
             assert(i < size());
+            SDSL_QUERY_COUNT(m_query_stats, wt_query_stats::ACCESS);
+            SDSL_QUERY_STATS_ONLY(size_t level = 0;)
             // which stores how many of the next symbols are equal
             // with the current char
             node_type v = m_tree.root(); // start at root node
             while (!m_tree.is_leaf(v)) {   // while  not a leaf
+                SDSL_QUERY_COUNT_LEVEL(m_query_stats, wt_query_stats::LEVEL_RANK, level++);
                 if (m_bv[ m_tree.bv_pos(v) + i]) {  // goto right child
                     i = m_bv_rank(m_tree.bv_pos(v) + i)
                         - m_tree.bv_pos_rank(v);
@@ -360,6 +367,7 @@ class wt_pc
         size_type rank(size_type i, value_type c)const
         {
             assert(i <= size());
+            SDSL_QUERY_COUNT(m_query_stats, wt_query_stats::RANK);
             if (!m_tree.is_valid(m_tree.c_to_leaf(c))) {
                 return 0;  // if `c` was not in the text
             }
@@ -371,6 +379,7 @@ class wt_pc
             size_type result = i;
             node_type v = m_tree.root();
             for (uint32_t l=0; l<path_len and result; ++l, p >>= 1) {
+                SDSL_QUERY_COUNT_LEVEL(m_query_stats, wt_query_stats::LEVEL_RANK, l);
                 if (p&1) {
                     result  = (m_bv_rank(m_tree.bv_pos(v)+result)
                                -  m_tree.bv_pos_rank(v));
@@ -397,8 +406,11 @@ class wt_pc
         inverse_select(size_type i)const
         {
             assert(i < size());
+            SDSL_QUERY_COUNT(m_query_stats, wt_query_stats::INVERSE_SELECT);
+            SDSL_QUERY_STATS_ONLY(size_t level = 0;)
             node_type v = m_tree.root();
             while (!m_tree.is_leaf(v)) {   // while not a leaf
+                SDSL_QUERY_COUNT_LEVEL(m_query_stats, wt_query_stats::LEVEL_RANK, level++);
                 if (m_bv[m_tree.bv_pos(v) + i]) {   //  goto right child
                     i = (m_bv_rank(m_tree.bv_pos(v) + i)
                          - m_tree.bv_pos_rank(v));
@@ -427,6 +439,7 @@ class wt_pc
         size_type select(size_type i, value_type c)const
         {
             assert(1 <= i and i <= rank(size(), c));
+            SDSL_QUERY_COUNT(m_query_stats, wt_query_stats::SELECT);
             node_type v = m_tree.c_to_leaf(c);
             if (!m_tree.is_valid(v)) {   // if c was not in the text
                 return m_size;         // -> return a position right to the end
@@ -440,6 +453,7 @@ class wt_pc
             // path_len > 0, since we have handled m_sigma = 1.
             p <<= (64-path_len);
             for (uint32_t l=0; l<path_len; ++l, p <<= 1) {
+                SDSL_QUERY_COUNT_LEVEL(m_query_stats, wt_query_stats::LEVEL_SELECT, path_len-1-l);
                 if ((p & 0x8000000000000000ULL)==0) { // node was a left child
                     v  = m_tree.parent(v);
                     result = m_bv_select0(m_tree.bv_pos(v)
@@ -666,6 +680,7 @@ class wt_pc
             written_bytes += m_bv_select1.serialize(out,child,"bv_select_1");
             written_bytes += m_bv_select0.serialize(out,child,"bv_select_0");
             written_bytes += m_tree.serialize(out,child,"tree");
+            SDSL_QUERY_STATS_ONLY(m_query_stats.add_to(child, wt_query_stats::name);)
             structure_tree::add_size(child, written_bytes);
             return written_bytes;
         }
@@ -16,6 +16,15 @@
 */
 #include "sdsl/bits.hpp"
 
+// In portable builds cnt_words is compiled once per instruction set and gcc
+// emits a GNU ifunc that binds it to the version for the CPU when the library
+// is loaded
+#if not defined(__SSE4_2__) and defined(__x86_64__) and defined(__ELF__) and defined(__GLIBC__) \
+    and defined(__GNUC__) and not defined(__clang__) and not defined(__INTEL_COMPILER) and __GNUC__ >= 8
+#define SDSL_CNT_WORDS_VERSIONS
+#include <immintrin.h>
+#endif
+
 namespace sdsl
 {
 
@@ -558,5 +567,82 @@ const uint8_t bits::lt_lo[]= {
     0x03,0x00,0x01,0x00,0x02,0x00,0x01,0x00
 };
 
-} // end namespace sdsl
+#ifdef SDSL_CNT_WORDS_VERSIONS
+
+namespace
+{
+
+__attribute__((target("default")))
+uint64_t cnt_words_isa(const uint64_t* word, uint64_t n)
+{
+    uint64_t res = 0, i = 0;
+    for (; i+4 <= n; i += 4) {
+        res += (bits::cnt(word[i]) + bits::cnt(word[i+1])) + (bits::cnt(word[i+2]) + bits::cnt(word[i+3]));
+    }
+    for (; i < n; ++i) {
+        res += bits::cnt(word[i]);
+    }
+    return res;
+}
+
+__attribute__((target("popcnt")))
+uint64_t cnt_words_isa(const uint64_t* word, uint64_t n)
+{
+    uint64_t res = 0, i = 0;
+    for (; i+4 <= n; i += 4) {
+        res += (__builtin_popcountll(word[i]) + __builtin_popcountll(word[i+1]))
+               + (__builtin_popcountll(word[i+2]) + __builtin_popcountll(word[i+3]));
+    }
+    for (; i < n; ++i) {
+        res += __builtin_popcountll(word[i]);
+    }
+    return res;
+}
+
+// nibble lookup with pshufb, see bits::cnt(const uint64_t*, uint64_t)
+__attribute__((target("avx2")))
+uint64_t cnt_words_isa(const uint64_t* word, uint64_t n)
+{
+    const __m256i lut = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,
+                                         0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i acc = _mm256_setzero_si256();
+    uint64_t i = 0;
+    for (; i+4 <= n; i += 4) {
+        __m256i v  = _mm256_loadu_si256((const __m256i*)(word+i));
+        __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, low));
+        __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+    }
+    uint64_t res = _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1)
+                   + _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+    for (; i < n; ++i) {
+        res += __builtin_popcountll(word[i]);
+    }
+    return res;
+}
+
+} // end anonymous namespace
+
+uint64_t bits::cnt_words(const uint64_t* word, uint64_t n)
+{
+    return cnt_words_isa(word, n);
+}
+
+#else
 
+uint64_t bits::cnt_words(const uint64_t* word, uint64_t n)
+{
+    uint64_t res = 0, i = 0;
+    for (; i+4 <= n; i += 4) {
+        res += (cnt(word[i]) + cnt(word[i+1])) + (cnt(word[i+2]) + cnt(word[i+3]));
+    }
+    for (; i < n; ++i) {
+        res += cnt(word[i]);
+    }
+    return res;
+}
+
+#endif
+
+} // end namespace sdsl
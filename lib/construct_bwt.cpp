@@ -0,0 +1,39 @@
+#include "sdsl/construct_bwt.hpp"
+#include "divsufsort.h"
+#include "divsufsort64.h"
+
+#include <cstring>
+
+namespace sdsl
+{
+
+void construct_bwt_direct(cache_config& config)
+{
+    int_vector<8> text;
+    load_from_cache(text, conf::KEY_TEXT, config);
+    uint64_t n = text.size();
+    uint8_t* t = (uint8_t*)text.data();
+
+    if (n > 1) {
+        // divbwt appends a virtual sentinel and returns the BWT without it.
+        // The position of the sentinel is the returned primary index.
+        int64_t primary;
+        if (n < 0x7FFFFFFFULL) {
+            int_vector<> tmp(n, 0, 32);
+            primary = divbwt(t, t, (int32_t*)tmp.data(), n);
+        } else {
+            int_vector<> tmp(n, 0, 64);
+            primary = divbwt64(t, t, (int64_t*)tmp.data(), n);
+        }
+        if (primary < 1) {
+            throw std::runtime_error("construct_bwt_direct: divbwt failed");
+        }
+        // The first character precedes the empty suffix; the sentinel is the
+        // character which precedes the text (text[n-1]=0)
+        std::memmove(t, t+1, primary-1);
+        t[primary-1] = 0;
+    }
+    store_to_cache(text, conf::KEY_BWT, config);
+}
+
+}
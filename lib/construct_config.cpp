@@ -4,5 +4,6 @@ namespace sdsl
 {
 
 byte_sa_algo_type construct_config::byte_algo_sa = LIBDIVSUFSORT;
+byte_bwt_algo_type construct_config::byte_algo_bwt = BWT_FROM_SA;
 
 }
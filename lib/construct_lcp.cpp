@@ -15,6 +15,7 @@ void construct_lcp_semi_extern_PHI(cache_config& config)
 {
     typedef int_vector<>::size_type size_type;
     int_vector_buffer<> sa_buf(cache_file_name(conf::KEY_SA, config));
+    sa_buf.async_io(true);
     size_type n = sa_buf.size();
     if (1==n) {
         int_vector<> lcp(1, 0);
@@ -60,6 +61,7 @@ void construct_lcp_semi_extern_PHI(cache_config& config)
     size_type buffer_size = 4000000; // buffer_size is a multiple of 8!
     sa_buf.buffersize(buffer_size);
     int_vector_buffer<> lcp_out_buf(cache_file_name(conf::KEY_LCP, config), std::ios::out, buffer_size, sa_buf.width());	// open buffer for plcp
+    lcp_out_buf.async_io(true);
 
     for (size_type i=0, sai_1=0,l=0, sai=0,iq=0; i < n; ++i) {
         /*size_type*/ sai = sa_buf[i];
@@ -106,6 +108,7 @@ void construct_lcp_go(cache_config& config)
     int_vector<8> text;
     load_from_cache(text, conf::KEY_TEXT, config);
     int_vector_buffer<> sa_buf(cache_file_name(conf::KEY_SA, config));   // initialize buffer for suffix array
+    sa_buf.async_io(true);
     const size_type n = sa_buf.size();
     const size_type m = 254; // LCP[i] == m+1 corresp. to LCP[i]>= m+1; LCP[i] <= m corresp. to LCP[i] was calculated
 
@@ -147,6 +150,7 @@ void construct_lcp_go(cache_config& config)
         alphabet[sigma] = '\0';
         {
             int_vector_buffer<8> bwt_buf(cache_file_name(conf::KEY_BWT, config)); // initialize buffer of bwt
+            bwt_buf.async_io(true);
             size_type sai_1 = sa_buf[0];  // store value of sa[i-1]
             uint8_t bwti_1 = bwt_buf[0];       // store value of BWT[i-1]
             lcp_sml[ cnt_cc[bwti_1]++ ] = 0;   // lcp_sml[ LF[0] ] = 0
@@ -390,8 +394,11 @@ void construct_lcp_go(cache_config& config)
     {
         const size_type buffer_size = 1000000; // buffer_size has to be a multiple of 8!
         int_vector_buffer<> lcp_big_buf(cache_file_name("lcp_big", config)); 					// file buffer containing the big LCP values
+        lcp_big_buf.async_io(true);
         int_vector_buffer<8> lcp_sml_buf(cache_file_name("lcp_sml", config), std::ios::in, buffer_size);		// file buffer containing the small LCP values
+        lcp_sml_buf.async_io(true);
         int_vector_buffer<> lcp_buf(cache_file_name(conf::KEY_LCP, config), std::ios::out, buffer_size, lcp_big_buf.width()); // buffer for the resulting LCP array
+        lcp_buf.async_io(true);
         for (size_type i=0, i2=0; i < n; ++i) {
             size_type l = lcp_sml_buf[i];
             if (l >= m) { // if l >= m it is stored in lcp_big
@@ -418,6 +425,7 @@ void construct_lcp_goPHI(cache_config& config)
     int_vector<8> text;
     load_from_cache(text, conf::KEY_TEXT, config);  // load text from file system
     int_vector_buffer<> sa_buf(cache_file_name(conf::KEY_SA, config));   // initialize buffer for suffix array
+    sa_buf.async_io(true);
     const size_type n = sa_buf.size();
     const size_type m = 254; // LCP[i] == m+1 corresp. to LCP[i]>= m+1; LCP[i] <= m corresp. to LCP[i] was calculated
 
@@ -454,6 +462,7 @@ void construct_lcp_goPHI(cache_config& config)
         alphabet[sigma] = '\0';
         {
             int_vector_buffer<8> bwt_buf(cache_file_name(conf::KEY_BWT, config)); // initialize buffer of bwt
+            bwt_buf.async_io(true);
             size_type sai_1 = sa_buf[0];  // store value of sa[i-1]
             uint8_t bwti_1 = bwt_buf[0];       // store value of BWT[i-1]
             lcp_sml[ cnt_cc[bwti_1]++ ] = 0;   // lcp_sml[ LF[0] ] = 0
@@ -596,8 +605,11 @@ void construct_lcp_goPHI(cache_config& config)
     {
         const size_type buffer_size = 1000000; // buffer_size has to be a multiple of 8!
         int_vector_buffer<> lcp_big_buf(cache_file_name("lcp_big", config)); 					// file buffer containing the big LCP values
+        lcp_big_buf.async_io(true);
         int_vector_buffer<8> lcp_sml_buf(cache_file_name("lcp_sml", config), std::ios::in, buffer_size);		// file buffer containing the small LCP values
+        lcp_sml_buf.async_io(true);
         int_vector_buffer<> lcp_buf(cache_file_name(conf::KEY_LCP, config), std::ios::out, buffer_size, lcp_big_buf.width()); // file buffer for the resulting LCP array
+        lcp_buf.async_io(true);
 
         for (size_type i=0, i2=0; i < n; ++i) {
             size_type l = lcp_sml_buf[i];
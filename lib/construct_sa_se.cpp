@@ -3,10 +3,8 @@
 namespace sdsl
 {
 
-void _construct_sa_IS(int_vector<> &text, int_vector<> &sa, std::string& filename_sa, size_t n, size_t text_offset, size_t sigma, uint64_t recursion)
+void _construct_sa_IS(int_vector<> &text, int_vector<> &sa, std::string& filename_sa, size_t n, size_t text_offset, size_t sigma, uint64_t recursion, uint64_t buffersize)
 {
-    uint64_t buffersize = 1024*1024/8;
-
     size_t name = 0;
     size_t number_of_lms_strings = 0;
     std::string filename_c_array = tmp_file(filename_sa, "_c_array"+util::to_string(recursion));
@@ -122,7 +120,7 @@ void _construct_sa_IS(int_vector<> &text, int_vector<> &sa, std::string& filenam
 
         // Recursive call
         std::string filename_sa_rec = tmp_file(filename_sa, "_sa_rec"+util::to_string(recursion+1));
-        _construct_sa_IS(sa, sa, filename_sa_rec, number_of_lms_strings, n-number_of_lms_strings, name+1, recursion+1);
+        _construct_sa_IS(sa, sa, filename_sa_rec, number_of_lms_strings, n-number_of_lms_strings, name+1, recursion+1, buffersize);
 
         for (size_t i=n-2, endpointer = n-1, was_s_typ = 1; i<n; --i) {
             if (text[text_offset+i]>text[text_offset+i+1]) {
@@ -53,6 +53,43 @@ bool store_to_checked_file(const char* v, const std::string& file)
 }
 
 
+bool read_member_offsets(const std::string& file, std::vector<uint64_t>& offsets)
+{
+    offsets.clear();
+    isfstream in(file, std::ios::binary | std::ios::in);
+    if (!in) {
+        return false;
+    }
+    in.seekg(0, std::ios::end);
+    std::streamoff size = in.tellg();
+    uint64_t count = 0, magic = 0;
+    if (size < 16 or !in.seekg(size-16)) {
+        return false;
+    }
+    read_member(count, in);
+    read_member(magic, in);
+    // the table holds count+1 offsets
+    if (!in or magic != member_offsets_magic or count >= (uint64_t)size/8) {
+        return false;
+    }
+    uint64_t table = size-16-8*(count+1);
+    if (!in.seekg(table)) {
+        return false;
+    }
+    offsets.resize(count+1);
+    for (auto& offset : offsets) {
+        read_member(offset, in);
+    }
+    bool valid = in and offsets[0] == 0 and offsets.back() == table;
+    for (size_t i=1; valid and i < offsets.size(); ++i) {
+        valid = offsets[i-1] <= offsets[i];
+    }
+    if (!valid) {
+        offsets.clear();
+    }
+    return valid;
+}
+
 template<>
 size_t write_member<std::string>(const std::string& t, std::ostream& out, structure_tree_node* v, std::string name)
 {
@@ -1,6 +1,13 @@
 #include <chrono>
 #include <algorithm>
+#include <thread>
 #include "sdsl/memory_management.hpp"
+#include "sdsl/numa_topology.hpp"
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 using namespace std::chrono;
 
@@ -447,7 +454,7 @@ hugepage_allocator::find_free_block(size_t size_in_bytes)
 }
 
 void*
-hugepage_allocator::mm_alloc(size_t size_in_bytes)
+hugepage_allocator::heap_alloc(size_t size_in_bytes)
 {
     //std::cout << "ALLOC(" << size_in_bytes << ")" << std::endl;
     mm_block_t* bptr = nullptr;
@@ -482,7 +489,7 @@ hugepage_allocator::mm_alloc(size_t size_in_bytes)
 }
 
 void
-hugepage_allocator::mm_free(void* ptr)
+hugepage_allocator::heap_free(void* ptr)
 {
     //print_heap();
     //std::cout << "FREE(" << ptr << ")" << std::endl;
@@ -496,14 +503,14 @@ hugepage_allocator::mm_free(void* ptr)
 }
 
 void*
-hugepage_allocator::mm_realloc(void* ptr, size_t size)
+hugepage_allocator::heap_realloc(void* ptr, size_t size)
 {
     //print_heap();
     //std::cout << "REALLOC(" << ptr << "," << size << ")" << std::endl;
     /* handle special cases first */
-    if (nullptr==ptr) return mm_alloc(size);
+    if (nullptr==ptr) return heap_alloc(size);
     if (size==0) {
-        mm_free(ptr);
+        heap_free(ptr);
         return nullptr;
     }
     mm_block_t* bptr = block_cur(ptr);
@@ -573,9 +580,9 @@ hugepage_allocator::mm_realloc(void* ptr, size_t size)
     }
     if (need_malloc) {
         //std::cout << "need_alloc in REALLOC!" << std::endl;
-        void* newptr = mm_alloc(size);
-        memcpy(newptr,ptr,size);
-        mm_free(ptr);
+        void* newptr = heap_alloc(size);
+        memcpy(newptr,ptr,blockdatasize);
+        heap_free(ptr);
         ptr = newptr;
     }
     //print_heap();
@@ -583,6 +590,93 @@ hugepage_allocator::mm_realloc(void* ptr, size_t size)
     return ptr;
 }
 
+/* per-thread cache of small used blocks, which are kept in singly linked
+   lists (via mm_block_t::next) per size class. A block in class c has a data
+   size of at least 2^(c+MIN_CLASS_BITS). */
+struct hugepage_allocator::thread_cache {
+    static const size_t MIN_CLASS_BITS = 6;       // 64 bytes
+    static const size_t MAX_CLASS_BITS = 15;      // 32 KiB
+    static const size_t MAX_BYTES = (size_t)1<<22; // cached bytes per thread
+    mm_block_t* head[MAX_CLASS_BITS-MIN_CLASS_BITS+1] = {};
+    size_t bytes = 0;
+
+    /* return all cached blocks to the heap when the thread ends */
+    ~thread_cache()
+    {
+        auto& a = hugepage_allocator::the_allocator();
+        std::lock_guard<std::mutex> lock(a.m_heap_mutex);
+        for (auto& h : head) {
+            while (h) {
+                mm_block_t* next = h->next;
+                a.heap_free(block_data(h));
+                h = next;
+            }
+        }
+    }
+};
+
+hugepage_allocator::thread_cache&
+hugepage_allocator::local_cache()
+{
+    static thread_local thread_cache cache;
+    return cache;
+}
+
+void*
+hugepage_allocator::mm_alloc(size_t size_in_bytes)
+{
+    typedef thread_cache tc;
+    if (size_in_bytes <= ((size_t)1<<tc::MAX_CLASS_BITS)) {
+        size_t c = size_in_bytes <= ((size_t)1<<tc::MIN_CLASS_BITS) ? tc::MIN_CLASS_BITS
+                   : bits::hi(size_in_bytes-1)+1;
+        auto& cache = local_cache();
+        mm_block_t*& h = cache.head[c-tc::MIN_CLASS_BITS];
+        if (h) {
+            mm_block_t* bptr = h;
+            h = bptr->next;
+            cache.bytes -= block_getdatasize(bptr);
+            return block_data(bptr);
+        }
+        // round up, so that the block can be reused for all requests of the class
+        size_in_bytes = (size_t)1<<c;
+    }
+    std::lock_guard<std::mutex> lock(m_heap_mutex);
+    return heap_alloc(size_in_bytes);
+}
+
+void
+hugepage_allocator::mm_free(void* ptr)
+{
+    typedef thread_cache tc;
+    if (ptr == nullptr) {
+        return;
+    }
+    mm_block_t* bptr = block_cur(ptr);
+    auto& cache = local_cache();
+    size_t size;
+    {
+        // the block header belongs to the heap, so it is only read under the lock
+        std::lock_guard<std::mutex> lock(m_heap_mutex);
+        size = block_getdatasize(bptr);
+        if (size < ((size_t)1<<tc::MIN_CLASS_BITS) or size >= ((size_t)1<<(tc::MAX_CLASS_BITS+1))
+            or cache.bytes + size > tc::MAX_BYTES) {
+            heap_free(ptr);
+            return;
+        }
+    }
+    mm_block_t*& h = cache.head[bits::hi(size)-tc::MIN_CLASS_BITS];
+    bptr->next = h;
+    h = bptr;
+    cache.bytes += size;
+}
+
+void*
+hugepage_allocator::mm_realloc(void* ptr, size_t size)
+{
+    std::lock_guard<std::mutex> lock(m_heap_mutex);
+    return heap_realloc(ptr, size);
+}
+
 uint64_t extract_number(std::string& line)
 {
     std::string num_str;
@@ -645,4 +739,229 @@ hugepage_allocator::determine_available_hugepage_memory()
 }
 #endif
 
+std::map<const uint8_t*, memory_manager::mapped_region>::iterator
+memory_manager::find_region(const void* ptr)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    auto it = mapped.upper_bound(p);
+    if (it == mapped.begin()) {
+        return mapped.end();
+    }
+    --it;
+    if (p < it->first + it->second.size) {
+        return it;
+    }
+    return mapped.end();
+}
+
+uint8_t*
+memory_manager::map_file_private(const std::string& file, uint64_t& file_size)
+{
+#ifdef MSVC_COMPILER
+    file_size = 0;
+    return nullptr;
+#else
+    std::string name = file;
+    int fd = open_file_for_mmap(name, std::ios_base::in);
+    if (fd == -1) {
+        return nullptr;
+    }
+    file_size = util::file_size(file);
+    // reserve file_size plus one word of zeros, then map the file over the front
+    size_t len = file_size + sizeof(uint64_t);
+    void* base = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base != MAP_FAILED and file_size > 0) {
+        void* map = mmap(base, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (map == MAP_FAILED) {
+            munmap(base, len);
+            base = MAP_FAILED;
+        }
+    }
+    close_file_for_mmap(fd);
+    if (base == MAP_FAILED) {
+        return nullptr;
+    }
+    auto& m = the_manager();
+    std::lock_guard<util::spin_lock> lock(m.mapped_lock);
+    m.mapped[(const uint8_t*)base] = {len, 1, 0};
+    m.mapped_cnt.store(m.mapped.size(), std::memory_order_release);
+    return (uint8_t*)base;
+#endif
+}
+
+uint8_t*
+memory_manager::read_file_private(const std::string& file, uint64_t& file_size, uint64_t threads)
+{
+#ifdef MSVC_COMPILER
+    file_size = 0;
+    return nullptr;
+#else
+    std::string name = file;
+    int fd = open_file_for_mmap(name, std::ios_base::in);
+    if (fd == -1) {
+        return nullptr;
+    }
+    file_size = util::file_size(file);
+    size_t len = file_size + sizeof(uint64_t);
+    void* base = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close_file_for_mmap(fd);
+        return nullptr;
+    }
+    // split the file into chunks of whole MiBs, one per thread
+    const uint64_t mb = 1ULL<<20;
+    threads = std::max((uint64_t)1, std::min(threads, (file_size+mb-1)/mb));
+    uint64_t chunk = (((file_size+threads-1)/threads + mb-1)/mb)*mb;
+    std::atomic<bool> ok(true);
+    std::vector<std::thread> readers;
+    for (uint64_t t=0; t < threads; ++t) {
+        readers.emplace_back([&, t]() {
+            uint64_t pos = t*chunk;
+            uint64_t end = std::min(pos+chunk, file_size);
+            while (pos < end and ok) {
+                ssize_t r = pread(fd, (uint8_t*)base+pos, end-pos, pos);
+                if (r <= 0) {
+                    ok = false;
+                } else {
+                    pos += r;
+                }
+            }
+        });
+    }
+    for (auto& r : readers) {
+        r.join();
+    }
+    close_file_for_mmap(fd);
+    if (!ok) {
+        munmap(base, len);
+        return nullptr;
+    }
+    auto& m = the_manager();
+    {
+        std::lock_guard<util::spin_lock> lock(m.mapped_lock);
+        m.mapped[(const uint8_t*)base] = {len, 1, len};
+        m.mapped_cnt.store(m.mapped.size(), std::memory_order_release);
+    }
+    memory_monitor::record((int64_t)len);
+    return (uint8_t*)base;
+#endif
+}
+
+void
+memory_manager::acquire_mapped(const void* ptr)
+{
+    auto& m = the_manager();
+    std::lock_guard<util::spin_lock> lock(m.mapped_lock);
+    auto it = m.find_region(ptr);
+    if (it != m.mapped.end()) {
+        ++(it->second.refs);
+    }
+}
+
+void
+memory_manager::trim_mapped(SDSL_UNUSED const void* base,
+                            SDSL_UNUSED const std::vector<std::pair<uint64_t, uint64_t>>& shared)
+{
+#ifndef MSVC_COMPILER
+    static const uint64_t page_size = sysconf(_SC_PAGESIZE);
+    auto& m = the_manager();
+    uint64_t released = 0;
+    {
+        std::lock_guard<util::spin_lock> lock(m.mapped_lock);
+        auto it = m.find_region(base);
+        if (it == m.mapped.end() or it->second.refs < 2 or it->second.counted == 0) {
+            return;
+        }
+        uint8_t* begin = (uint8_t*)it->first;
+        uint64_t size = it->second.size;
+        uint64_t pos = 0; // end of the last range in use
+        for (size_t i=0; i <= shared.size(); ++i) {
+            uint64_t next = i < shared.size() ? shared[i].first : size;
+            // whole pages in [pos, next) are unused
+            uint64_t from = (pos + page_size-1) & ~(page_size-1);
+            uint64_t to   = (i < shared.size()) ? (next & ~(page_size-1)) : size;
+            if (from < to and madvise(begin+from, to-from, MADV_DONTNEED) == 0) {
+                released += to-from;
+            }
+            if (i < shared.size()) {
+                pos = std::max(pos, shared[i].second);
+            }
+        }
+        released = std::min(released, it->second.counted);
+        it->second.counted -= released;
+    }
+    if (released) {
+        memory_monitor::record(-(int64_t)released);
+    }
+#endif
+}
+
+bool
+memory_manager::release_mapped(const void* ptr)
+{
+    auto& m = the_manager();
+    if (m.mapped_cnt.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    int64_t counted_size = 0;
+    {
+        std::lock_guard<util::spin_lock> lock(m.mapped_lock);
+        auto it = m.find_region(ptr);
+        if (it == m.mapped.end()) {
+            return false;
+        }
+        if (--(it->second.refs) == 0) {
+            counted_size = (int64_t)it->second.counted;
+            mem_unmap((void*)it->first, it->second.size);
+            m.mapped.erase(it);
+            m.mapped_cnt.store(m.mapped.size(), std::memory_order_release);
+        }
+    }
+    if (counted_size) {
+        memory_monitor::record(-counted_size);
+    }
+    return true;
+}
+
+#ifdef __linux__
+// Constants of the mbind system call (see numaif.h). They are defined here,
+// so that libnuma is not required.
+#define SDSL_MPOL_PREFERRED   1
+#define SDSL_MPOL_INTERLEAVE  3
+#define SDSL_MPOL_MF_MOVE     (1<<1)
+#define SDSL_MAX_NUMA_NODES   1024
+#endif
+
+void memory_manager::numa_place(SDSL_UNUSED void* ptr, SDSL_UNUSED size_t size_in_bytes)
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    static const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+    uintptr_t begin = ((uintptr_t)ptr + page_size-1) & ~(page_size-1);
+    uintptr_t end = ((uintptr_t)ptr + size_in_bytes) & ~(page_size-1);
+    if (nullptr == ptr or begin >= end or numa_topology::nodes() < 2) {
+        return;
+    }
+    const size_t bits = 8*sizeof(unsigned long);
+    unsigned long mask[SDSL_MAX_NUMA_NODES/(8*sizeof(unsigned long))] = {};
+    auto& p = thread_numa_policy();
+    int mode;
+    if (p.placement == NUMA_INTERLEAVE) {
+        mode = SDSL_MPOL_INTERLEAVE;
+        for (uint32_t node=0; node < numa_topology::nodes() and node < SDSL_MAX_NUMA_NODES; ++node) {
+            if (!numa_topology::cpus(node).empty()) {
+                mask[node/bits] |= 1UL << (node%bits);
+            }
+        }
+    } else {
+        if (p.node >= SDSL_MAX_NUMA_NODES) {
+            return;
+        }
+        mode = SDSL_MPOL_PREFERRED;
+        mask[p.node/bits] |= 1UL << (p.node%bits);
+    }
+    // best effort: the data stays where it is, if the kernel refuses
+    syscall(SYS_mbind, (void*)begin, end-begin, mode, mask, SDSL_MAX_NUMA_NODES+1, SDSL_MPOL_MF_MOVE);
+#endif
+}
+
 }
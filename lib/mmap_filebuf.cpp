@@ -0,0 +1,107 @@
+#include "sdsl/mmap_filebuf.hpp"
+#include "sdsl/memory_management.hpp"
+
+#include <algorithm>
+
+namespace sdsl
+{
+
+mmap_filebuf::~mmap_filebuf()
+{
+    close();
+}
+
+mmap_filebuf::mmap_filebuf() {}
+
+mmap_filebuf*
+mmap_filebuf::set_region(uint8_t* base, uint64_t size)
+{
+    if (base == nullptr) {
+        return nullptr;
+    }
+    m_base = base;
+    m_size = size;
+    char* begin = (char*)m_base;
+    setg(begin, begin, begin + m_size);
+    return this;
+}
+
+mmap_filebuf*
+mmap_filebuf::open(const std::string& file)
+{
+    close();
+    uint64_t size = 0;
+    uint8_t* base = memory_manager::map_file_private(file, size);
+    return set_region(base, size);
+}
+
+mmap_filebuf*
+mmap_filebuf::read(const std::string& file, uint64_t threads)
+{
+    close();
+    uint64_t size = 0;
+    uint8_t* base = memory_manager::read_file_private(file, size, threads);
+    return set_region(base, size);
+}
+
+bool
+mmap_filebuf::is_open() const
+{
+    return m_base != nullptr;
+}
+
+mmap_filebuf*
+mmap_filebuf::close()
+{
+    if (!is_open())
+        return nullptr;
+    std::sort(m_shared.begin(), m_shared.end());
+    memory_manager::trim_mapped(m_base, m_shared);
+    memory_manager::release_mapped(m_base);
+    m_base = nullptr;
+    m_size = 0;
+    m_shared.clear();
+    setg(nullptr, nullptr, nullptr);
+    return this;
+}
+
+uint64_t*
+mmap_filebuf::share(uint64_t bytes)
+{
+    // the words are read as uint64_t, so the current position has to be
+    // aligned; int_vector headers written without a known stream position
+    // and files of older versions are not padded (see int_vector)
+    if (!is_open() or (uint64_t)(egptr()-gptr()) < bytes or ((uintptr_t)gptr() & 7)) {
+        return nullptr;
+    }
+    char* p = gptr();
+    setg(eback(), p + bytes, egptr());
+    memory_manager::acquire_mapped(p);
+    m_shared.emplace_back(p - eback(), p - eback() + bytes);
+    return (uint64_t*)p;
+}
+
+mmap_filebuf::pos_type
+mmap_filebuf::seekpos(pos_type sp, std::ios_base::openmode which)
+{
+    if (!is_open() or !(which & std::ios_base::in) or sp < (pos_type)0 or sp > (pos_type)m_size) {
+        return pos_type(off_type(-1));
+    }
+    setg(eback(), eback()+sp, egptr());
+    return sp;
+}
+
+mmap_filebuf::pos_type
+mmap_filebuf::seekoff(off_type off, std::ios_base::seekdir way,
+                      std::ios_base::openmode which)
+{
+    off_type pos = off;
+    if (std::ios_base::cur == way) {
+        pos += gptr()-eback();
+    } else if (std::ios_base::end == way) {
+        pos += egptr()-eback();
+    }
+    return seekpos(pos, which);
+}
+
+}
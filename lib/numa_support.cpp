@@ -0,0 +1,85 @@
+#include "sdsl/numa_support.hpp"
+
+namespace sdsl
+{
+
+numa_thread_pool::numa_thread_pool(uint32_t threads_per_node)
+{
+    uint32_t n = numa_topology::nodes();
+    for (uint32_t node=0; node < n; ++node) {
+        m_queues.emplace_back(new node_queue());
+    }
+    for (uint32_t node=0; node < n; ++node) {
+        uint32_t threads = threads_per_node;
+        if (0 == threads) {
+            threads = std::max((size_t)1, numa_topology::cpus(node).size());
+        }
+        for (uint32_t i=0; i < threads; ++i) {
+            m_workers.emplace_back(&numa_thread_pool::work, this, node);
+        }
+    }
+}
+
+numa_thread_pool::~numa_thread_pool()
+{
+    for (auto& q : m_queues) {
+        std::lock_guard<std::mutex> lock(q->mtx);
+        q->stop = true;
+        q->cv.notify_all();
+    }
+    for (auto& w : m_workers) {
+        w.join();
+    }
+}
+
+void numa_thread_pool::work(uint32_t node)
+{
+    numa_topology::pin_thread(node);
+    memory_manager::set_numa_placement(NUMA_NODE, node);
+    node_queue& q = *m_queues[node];
+    while (true) {
+        std::packaged_task<void(uint32_t)> task;
+        {
+            std::unique_lock<std::mutex> lock(q.mtx);
+            q.cv.wait(lock, [&q]() { return q.stop or !q.tasks.empty(); });
+            if (q.tasks.empty()) {
+                return;
+            }
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+        }
+        task(node);
+        std::lock_guard<std::mutex> lock(q.mtx);
+        --q.pending;
+    }
+}
+
+std::future<void> numa_thread_pool::submit(uint32_t node, task_type task)
+{
+    node_queue& q = *m_queues[node % m_queues.size()];
+    std::packaged_task<void(uint32_t)> t(std::move(task));
+    std::future<void> res = t.get_future();
+    {
+        std::lock_guard<std::mutex> lock(q.mtx);
+        q.tasks.push_back(std::move(t));
+        ++q.pending;
+    }
+    q.cv.notify_one();
+    return res;
+}
+
+std::future<void> numa_thread_pool::submit(task_type task)
+{
+    uint32_t best = 0;
+    size_t best_pending = (size_t)-1;
+    for (uint32_t node=0; node < m_queues.size(); ++node) {
+        std::lock_guard<std::mutex> lock(m_queues[node]->mtx);
+        if (m_queues[node]->pending < best_pending) {
+            best_pending = m_queues[node]->pending;
+            best = node;
+        }
+    }
+    return submit(best, std::move(task));
+}
+
+} // end namespace sdsl
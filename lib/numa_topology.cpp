@@ -0,0 +1,98 @@
+#include "sdsl/numa_topology.hpp"
+#include "sdsl/util.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace sdsl
+{
+
+#ifdef __linux__
+// parse a list like "0-3,8,10-11"
+static std::vector<uint32_t> parse_cpu_list(const std::string& list)
+{
+    std::vector<uint32_t> res;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty() or !isdigit(range[0])) {
+            continue;
+        }
+        size_t dash = range.find('-');
+        uint32_t first = std::stoul(range.substr(0, dash));
+        uint32_t last = dash == std::string::npos ? first : std::stoul(range.substr(dash+1));
+        for (uint32_t c=first; c <= last; ++c) {
+            res.push_back(c);
+        }
+    }
+    return res;
+}
+#endif
+
+numa_topology::numa_topology()
+{
+#ifdef __linux__
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string list;
+    if (online and std::getline(online, list)) {
+        for (uint32_t node : parse_cpu_list(list)) {
+            std::ifstream cpulist("/sys/devices/system/node/node"+util::to_string(node)+"/cpulist");
+            std::string cpus;
+            std::getline(cpulist, cpus);
+            if (node >= m_cpus.size()) {
+                m_cpus.resize(node+1);
+            }
+            m_cpus[node] = parse_cpu_list(cpus);
+        }
+    }
+#endif
+    if (m_cpus.empty()) {
+        uint32_t n = std::max(1U, std::thread::hardware_concurrency());
+        m_cpus.resize(1);
+        for (uint32_t c=0; c < n; ++c) {
+            m_cpus[0].push_back(c);
+        }
+    }
+}
+
+uint32_t numa_topology::current_node()
+{
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 and node < nodes()) {
+        return node;
+    }
+#endif
+    return 0;
+}
+
+bool numa_topology::pin_thread(uint32_t node)
+{
+#ifdef __linux__
+    if (node >= nodes() or cpus(node).empty()) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (uint32_t c : cpus(node)) {
+        if (c < CPU_SETSIZE) {
+            CPU_SET(c, &set);
+        }
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+}
@@ -0,0 +1,436 @@
+#include "sdsl/query_server.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#ifndef MSVC_COMPILER
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#ifndef MSG_NOSIGNAL // e.g. on Mac OS X
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+namespace sdsl
+{
+
+namespace query_protocol
+{
+
+namespace
+{
+
+template<class t_int>
+void put(std::string& buf, t_int x)
+{
+    for (size_t i=0; i < sizeof(t_int); ++i) {
+        buf.push_back((char)((x >> (8*i)) & 0xFF));
+    }
+}
+
+void put_string(std::string& buf, const std::string& s)
+{
+    put<uint32_t>(buf, s.size());
+    buf.append(s);
+}
+
+// Reads the payload of a frame; all methods return false at the end of the payload.
+struct reader {
+    const char* p;
+    const char* end;
+
+    template<class t_int>
+    bool get(t_int& x)
+    {
+        if ((size_t)(end-p) < sizeof(t_int)) {
+            return false;
+        }
+        x = 0;
+        for (size_t i=0; i < sizeof(t_int); ++i) {
+            x |= ((t_int)(uint8_t)p[i]) << (8*i);
+        }
+        p += sizeof(t_int);
+        return true;
+    }
+
+    bool get_string(std::string& s)
+    {
+        uint32_t m;
+        if (!get(m) or (size_t)(end-p) < m) {
+            return false;
+        }
+        s.assign(p, m);
+        p += m;
+        return true;
+    }
+};
+
+// Reserves the length field of a frame and returns its position
+size_t begin_frame(std::string& buf)
+{
+    size_t pos = buf.size();
+    put<uint32_t>(buf, 0);
+    return pos;
+}
+
+void end_frame(std::string& buf, size_t pos)
+{
+    uint32_t size = buf.size()-pos-4;
+    for (size_t i=0; i < 4; ++i) {
+        buf[pos+i] = (char)((size >> (8*i)) & 0xFF);
+    }
+}
+
+}
+
+void encode(const request& req, std::string& buf)
+{
+    size_t pos = begin_frame(buf);
+    put<uint32_t>(buf, req.id);
+    put<uint8_t>(buf, req.op);
+    switch (req.op) {
+        case EXTRACT:
+            put<uint64_t>(buf, req.begin);
+            put<uint64_t>(buf, req.end);
+            break;
+        case K_MISMATCH:
+            put<uint8_t>(buf, req.k);
+            put_string(buf, req.pattern);
+            break;
+        default:
+            put_string(buf, req.pattern);
+    }
+    end_frame(buf, pos);
+}
+
+void encode(const response& res, std::string& buf)
+{
+    size_t pos = begin_frame(buf);
+    put<uint32_t>(buf, res.id);
+    put<uint8_t>(buf, res.status);
+    if (res.status != OK) {
+        put_string(buf, res.text);
+    } else if (res.op == COUNT) {
+        put<uint64_t>(buf, res.count);
+    } else if (res.op == EXTRACT) {
+        put_string(buf, res.text);
+    } else {
+        put<uint64_t>(buf, res.positions.size());
+        for (uint64_t x : res.positions) {
+            put<uint64_t>(buf, x);
+        }
+    }
+    end_frame(buf, pos);
+}
+
+bool decode(const char* payload, uint32_t size, request& req)
+{
+    reader in {payload, payload+size};
+    if (!in.get(req.id) or !in.get(req.op)) {
+        return false;
+    }
+    switch (req.op) {
+        case COUNT:
+        case LOCATE:
+            return in.get_string(req.pattern);
+        case EXTRACT:
+            return in.get(req.begin) and in.get(req.end);
+        case K_MISMATCH:
+            return in.get(req.k) and in.get_string(req.pattern);
+        default: // answered with an error
+            return true;
+    }
+}
+
+bool decode(const char* payload, uint32_t size, uint8_t op, response& res)
+{
+    reader in {payload, payload+size};
+    res.op = op;
+    if (!in.get(res.id) or !in.get(res.status)) {
+        return false;
+    }
+    if (res.status != OK or op == EXTRACT) {
+        return in.get_string(res.text);
+    } else if (op == COUNT) {
+        return in.get(res.count);
+    }
+    uint64_t n;
+    if (!in.get(n) or (uint64_t)(in.end-in.p) < 8*n) {
+        return false;
+    }
+    res.positions.resize(n);
+    for (uint64_t i=0; i < n; ++i) {
+        in.get(res.positions[i]);
+    }
+    return true;
+}
+
+} // end namespace query_protocol
+
+#ifndef MSVC_COMPILER
+
+frame_stream::~frame_stream()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+bool frame_stream::buffered_frame(const char*& payload, uint32_t& size)
+{
+    if (m_in.size()-m_pos < 4) {
+        return false;
+    }
+    size = 0;
+    for (size_t i=0; i < 4; ++i) {
+        size |= ((uint32_t)(uint8_t)m_in[m_pos+i]) << (8*i);
+    }
+    if (size > query_protocol::max_frame_size) {
+        throw std::runtime_error("frame_stream: frame too large");
+    }
+    if (m_in.size()-m_pos-4 < size) {
+        return false;
+    }
+    payload = m_in.data()+m_pos+4;
+    m_pos += 4+size;
+    return true;
+}
+
+bool frame_stream::receive()
+{
+    // drop the processed frames
+    m_in.erase(0, m_pos);
+    m_pos = 0;
+    char buf[1<<16];
+    ssize_t n;
+    do {
+        n = ::read(m_fd, buf, sizeof(buf));
+    } while (n < 0 and errno == EINTR);
+    if (n <= 0) {
+        return false;
+    }
+    m_in.append(buf, n);
+    return true;
+}
+
+void frame_stream::write(const std::string& buf)
+{
+    std::lock_guard<std::mutex> lock(m_write_mtx);
+    size_t written = 0;
+    while (written < buf.size()) {
+        ssize_t n = ::send(m_fd, buf.data()+written, buf.size()-written, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::system_category(), "frame_stream::write");
+        }
+        written += n;
+    }
+}
+
+void frame_stream::shutdown_read()
+{
+    ::shutdown(m_fd, SHUT_RD);
+}
+
+void frame_stream::shutdown()
+{
+    ::shutdown(m_fd, SHUT_RDWR);
+}
+
+void frame_stream::set_send_timeout(uint32_t ms)
+{
+    timeval tv;
+    tv.tv_sec = ms/1000;
+    tv.tv_usec = (ms%1000)*1000;
+    if (::setsockopt(m_fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv)) < 0) {
+        throw std::system_error(errno, std::system_category(), "frame_stream::set_send_timeout");
+    }
+}
+
+static sockaddr_un unix_address(const std::string& path)
+{
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("socket path too long: "+path);
+    }
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path)-1);
+    return addr;
+}
+
+int listen_unix_socket(const std::string& path)
+{
+    sockaddr_un addr = unix_address(path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::system_error(errno, std::system_category(), "socket");
+    }
+    ::unlink(path.c_str());
+    if (::bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 or ::listen(fd, 128) < 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::system_category(), "listen on "+path);
+    }
+    return fd;
+}
+
+int connect_unix_socket(const std::string& path)
+{
+    sockaddr_un addr = unix_address(path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::system_error(errno, std::system_category(), "socket");
+    }
+    if (::connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::system_category(), "connect to "+path);
+    }
+    return fd;
+}
+
+int accept_connection(int listen_fd)
+{
+    while (true) {
+        int fd = ::accept(listen_fd, nullptr, nullptr);
+        if (fd >= 0 or errno != EINTR) {
+            return fd;
+        }
+    }
+}
+
+void shutdown_listen_socket(int fd)
+{
+    ::shutdown(fd, SHUT_RDWR);
+}
+
+void close_listen_socket(int fd, const std::string& path)
+{
+    if (fd >= 0) {
+        ::close(fd);
+        ::unlink(path.c_str());
+    }
+}
+
+#else
+
+frame_stream::~frame_stream() {}
+bool frame_stream::buffered_frame(const char*&, uint32_t&) { return false; }
+bool frame_stream::receive() { return false; }
+void frame_stream::write(const std::string&) {}
+void frame_stream::shutdown_read() {}
+void frame_stream::shutdown() {}
+void frame_stream::set_send_timeout(uint32_t) {}
+
+int listen_unix_socket(const std::string&)
+{
+    throw std::runtime_error("query_server is not supported on MSVC_COMPILER");
+}
+int connect_unix_socket(const std::string&)
+{
+    throw std::runtime_error("query_client is not supported on MSVC_COMPILER");
+}
+int accept_connection(int) { return -1; }
+void shutdown_listen_socket(int) {}
+void close_listen_socket(int, const std::string&) {}
+
+#endif
+
+query_client::query_client(const std::string& socket_path) :
+    m_stream(new frame_stream(connect_unix_socket(socket_path))) {}
+
+uint32_t query_client::send(query_protocol::request req)
+{
+    req.id = m_next_id++;
+    m_out.clear();
+    query_protocol::encode(req, m_out);
+    m_stream->write(m_out);
+    m_pending.emplace_back(req.id, req.op);
+    return req.id;
+}
+
+query_protocol::response query_client::receive()
+{
+    if (m_pending.empty()) {
+        throw std::logic_error("query_client::receive: no pending request");
+    }
+    const char* payload;
+    uint32_t size;
+    while (!m_stream->buffered_frame(payload, size)) {
+        if (!m_stream->receive()) {
+            throw std::runtime_error("query_client: connection closed by the server");
+        }
+    }
+    // the id is the first field of the payload
+    uint32_t id = 0;
+    for (size_t i=0; i < 4 and i < size; ++i) {
+        id |= ((uint32_t)(uint8_t)payload[i]) << (8*i);
+    }
+    for (size_t i=0; i < m_pending.size(); ++i) {
+        if (m_pending[i].first == id) {
+            query_protocol::response res;
+            if (!query_protocol::decode(payload, size, m_pending[i].second, res)) {
+                throw std::runtime_error("query_client: malformed response");
+            }
+            m_pending.erase(m_pending.begin()+i);
+            return res;
+        }
+    }
+    throw std::runtime_error("query_client: response to an unknown request");
+}
+
+query_protocol::response query_client::call(query_protocol::request& req)
+{
+    if (!m_pending.empty()) {
+        throw std::logic_error("query_client: blocking call with pending requests");
+    }
+    send(req);
+    query_protocol::response res = receive();
+    if (res.status != query_protocol::OK) {
+        throw std::runtime_error("query_server: "+res.text);
+    }
+    return res;
+}
+
+uint64_t query_client::count(const std::string& pattern)
+{
+    query_protocol::request req;
+    req.op = query_protocol::COUNT;
+    req.pattern = pattern;
+    return call(req).count;
+}
+
+std::vector<uint64_t> query_client::locate(const std::string& pattern)
+{
+    query_protocol::request req;
+    req.op = query_protocol::LOCATE;
+    req.pattern = pattern;
+    return call(req).positions;
+}
+
+std::string query_client::extract(uint64_t begin, uint64_t end)
+{
+    query_protocol::request req;
+    req.op = query_protocol::EXTRACT;
+    req.begin = begin;
+    req.end = end;
+    return call(req).text;
+}
+
+std::vector<uint64_t> query_client::k_mismatch(const std::string& pattern, uint8_t k)
+{
+    query_protocol::request req;
+    req.op = query_protocol::K_MISMATCH;
+    req.k = k;
+    req.pattern = pattern;
+    return call(req).positions;
+}
+
+} // end namespace sdsl
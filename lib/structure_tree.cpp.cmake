@@ -17,6 +17,18 @@ void write_structure_tree<JSON_FORMAT>(const structure_tree_node* v, std::ostrea
         output_tab(out,level+1); out << "\"class_name\":" << "\"" << v->type << "\"," << std::endl;
         output_tab(out,level+1); out << "\"name\":" << "\"" << v->name << "\"," << std::endl;
         output_tab(out,level+1); out << "\"size\":" << "\"" << v->size << "\"";
+        if (v->counters.size()) {
+            out << "," << std::endl;
+            output_tab(out,level+1); out << "\"counters\":{";
+            size_t written_counters = 0;
+            for (const auto& counter : v->counters) {
+                if (written_counters++ > 0) {
+                    out << ",";
+                }
+                out << "\"" << counter.first << "\":" << "\"" << counter.second << "\"";
+            }
+            out << "}";
+        }
 
         if (v->children.size()) {
             out << "," << std::endl; // terminate the size tag from before if there are children
@@ -112,7 +124,7 @@ std::string create_js_body(const std::string& jsonsize)
             "    .style(\"fill\", colour)\n"
             "    .on(\"click\", click);\n"
             "\n"
-            "  path.append(\"title\").text(function(d) { return 'class name: ' + d.class_name + '\\nmember_name: ' + d.name + '\\n size: ' + sizeMB(d) });\n"
+            "  path.append(\"title\").text(function(d) { return 'class name: ' + d.class_name + '\\nmember_name: ' + d.name + '\\n size: ' + sizeMB(d) + counters(d) });\n"
             "\n"
             "  var text = vis.selectAll(\"text\").data(nodes);\n"
             "  var textEnter = text.enter().append(\"text\")\n"
@@ -132,7 +144,7 @@ std::string create_js_body(const std::string& jsonsize)
             "    })\n"
             "    .on(\"click\", click);\n"
             "\n"
-            "  textEnter.append(\"title\").text(function(d) { return 'class name: ' + d.class_name + '\\nmember_name: ' + d.name + '\\n size: ' + sizeMB(d) });\n"
+            "  textEnter.append(\"title\").text(function(d) { return 'class name: ' + d.class_name + '\\nmember_name: ' + d.name + '\\n size: ' + sizeMB(d) + counters(d) });\n"
             "\n"
             "  textEnter.append(\"tspan\")\n"
             "    .attr(\"x\", 0)\n"
@@ -182,6 +194,12 @@ std::string create_js_body(const std::string& jsonsize)
             "//  }\n"
             "}\n"
             "\n"
+            "function counters(d) {\n"
+            "  var s = '';\n"
+            "  for (var c in d.counters) s += '\\n' + c + ': ' + d.counters[c];\n"
+            "  return s;\n"
+            "}\n"
+            "\n"
             "function calcSum(d) {\n"
             "  if(d.children) {\n"
             "  var sum = 0;\n"
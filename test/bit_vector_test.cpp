@@ -25,6 +25,8 @@ bit_vector_il<128>,
 bit_vector_il<256>,
 bit_vector_il<512>,
 bit_vector_il<1024>,
+bit_vector_cl<>,
+bit_vector_cl<64>,
 rrr_vector<64>,
 rrr_vector<256>,
 rrr_vector<129>,
@@ -38,7 +40,11 @@ rrr_vector<127>,
 rrr_vector<128>,
 sd_vector<>,
 sd_vector<rrr_vector<63> >,
-hyb_vector<>
+hyb_vector<>,
+pef_vector<>,
+pef_vector<16>,
+rle_vector<>,
+rle_vector<2>
 > Implementations;
 
 typedef Types<
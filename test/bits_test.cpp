@@ -137,6 +137,48 @@ TEST_F(bits_test, cnt)
     }
 }
 
+TEST_F(bits_test, cnt_range)
+{
+    const uint64_t* data = this->m_data.data();
+    // all lengths up to 200 words from several (unaligned) start positions
+    for (uint64_t start : {0, 1, 3, 7, 1000}) {
+        uint64_t ones = 0;
+        for (uint64_t n=0; n <= 200; ++n) {
+            ASSERT_EQ(ones, sdsl::bits::cnt(data+start, n));
+            ones += cnt_naive(data[start+n]);
+        }
+    }
+    uint64_t ones = 0;
+    for (uint64_t i=0; i < this->m_data.size(); ++i) {
+        ones += cnt_naive(data[i]);
+    }
+    ASSERT_EQ(ones, sdsl::bits::cnt(data, this->m_data.size()));
+}
+
+TEST_F(bits_test, cnt_words)
+{
+    const uint64_t* data = this->m_data.data();
+    // the version of the library kernel selected for this CPU
+    for (uint64_t start : {0, 1, 3}) {
+        uint64_t ones = 0;
+        for (uint64_t n=0; n <= 200; ++n) {
+            ASSERT_EQ(ones, sdsl::bits::cnt_words(data+start, n));
+            ones += cnt_naive(data[start+n]);
+        }
+    }
+    ASSERT_EQ(sdsl::bits::cnt(data, this->m_data.size()), sdsl::bits::cnt_words(data, this->m_data.size()));
+}
+
+TEST_F(bits_test, cnt_prefix)
+{
+    const uint64_t* data = this->m_data.data();
+    uint64_t ones = 0;
+    for (uint64_t len=0; len <= 64*50; ++len) {
+        ASSERT_EQ(ones, sdsl::bits::cnt_prefix(data+5, len));
+        ones += (data[5+len/64] >> (len%64)) & 1;
+    }
+}
+
 //! Test the parametrized constructor
 TEST_F(bits_test, sel)
 {
@@ -0,0 +1,116 @@
+// The test and its copy of the library are built with USE_CACHE (see
+// CMakeLists.txt), which enables the caches of bp_support_sada to test their
+// thread safety
+#ifndef USE_CACHE
+#error "concurrent_query_test has to be compiled with -DUSE_CACHE"
+#endif
+#include "sdsl/suffix_arrays.hpp"
+#include "sdsl/suffix_trees.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using namespace sdsl;
+
+std::string temp_dir;
+
+const size_t threads = 4;
+
+class concurrent_query_test : public ::testing::Test { };
+
+std::string random_text(size_t n)
+{
+    std::mt19937_64 rng(17);
+    std::uniform_int_distribution<int> dist(0, 3);
+    std::string text(n, 'a');
+    for (auto& c : text) {
+        c = "acgt"[dist(rng)];
+    }
+    return text;
+}
+
+// Runs query(t) for t=0..threads-1 in parallel and compares the results
+// with a sequential execution.
+template<class t_query>
+void check_parallel(t_query query)
+{
+    std::vector<std::vector<uint64_t>> expected(threads), results(threads);
+    for (size_t t=0; t < threads; ++t) {
+        expected[t] = query(t);
+    }
+    std::vector<std::thread> workers;
+    for (size_t t=0; t < threads; ++t) {
+        workers.emplace_back([&, t]() { results[t] = query(t); });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    for (size_t t=0; t < threads; ++t) {
+        ASSERT_EQ(expected[t], results[t]);
+    }
+}
+
+TEST_F(concurrent_query_test, csa_sada)
+{
+    csa_sada<enc_vector<>, 16, 32> csa;
+    construct_im(csa, random_text(100000), 1);
+    check_parallel([&](size_t) {
+        std::vector<uint64_t> res;
+        for (size_t i=0; i < csa.size(); i+=7) {
+            res.push_back(csa[i]);
+            res.push_back(csa.lf[i]);
+        }
+        for (std::string p : {"a", "ac", "gat", "cgta", "ttttt"}) {
+            res.push_back(count(csa, p.begin(), p.end()));
+        }
+        return res;
+    });
+}
+
+TEST_F(concurrent_query_test, cst_sct3)
+{
+    cst_sct3<> cst;
+    construct_im(cst, random_text(50000), 1);
+    check_parallel([&](size_t t) {
+        std::vector<uint64_t> res;
+        // every thread traverses the nodes in a different order to
+        // interleave the accesses of the caches
+        std::mt19937_64 rng(t);
+        std::uniform_int_distribution<uint64_t> dist(0, cst.csa.size()-1);
+        std::vector<uint64_t> leaves;
+        for (size_t i=0; i < 20000; ++i) {
+            leaves.push_back(dist(rng)%(cst.csa.size()/16)*16);
+        }
+        std::sort(leaves.begin(), leaves.end());
+        for (uint64_t i : leaves) {
+            auto v = cst.select_leaf(i+1);
+            auto p = cst.parent(v);
+            res.push_back(cst.id(p));
+            res.push_back(cst.depth(p));
+            res.push_back(cst.rb(p));
+            res.push_back(cst.sn(cst.sl(v)));
+        }
+        return res;
+    });
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    if (argc < 2) {
+        // LCOV_EXCL_START
+        std::cout << "Usage: " << argv[0] << " tmp_dir" << std::endl;
+        return 1;
+        // LCOV_EXCL_STOP
+    }
+    temp_dir = argv[1];
+    return RUN_ALL_TESTS();
+}
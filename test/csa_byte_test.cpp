@@ -21,6 +21,25 @@ bool in_memory;
 template<class T>
 class csa_byte_test : public ::testing::Test { };
 
+// An ISA sampling which only provides the constructor without the CSA pointer
+template<class t_csa>
+class _user_isa_sampling : public _isa_sampling<t_csa>
+{
+    public:
+        typedef typename _isa_sampling<t_csa>::sa_type sa_type;
+
+        _user_isa_sampling() {}
+
+        _user_isa_sampling(const cache_config& cconfig, const sa_type* sa_sample) :
+            _isa_sampling<t_csa>(cconfig, sa_sample) {}
+};
+
+struct user_isa_sampling {
+    template<class t_csa>
+    using type = _user_isa_sampling<t_csa>;
+    using sampling_category = isa_sampling_tag;
+};
+
 
 using testing::Types;
 
@@ -40,6 +59,10 @@ csa_wt<>,
        csa_wt<wt_huff<>, 8, 16, sa_order_sa_sampling<>>,
        csa_wt<wt_huff<>, 8, 16, sa_order_sa_sampling<>, isa_sampling<>, succinct_byte_alphabet<bit_vector, rank_support_v<>, select_support_mcl<>>>,
        csa_wt<wt_huff<>, 8, 16, sa_order_sa_sampling<>, isa_sampling<>, succinct_byte_alphabet<>>,
+       csa_wt<wt_huff<>, 8, 16, sa_order_sa_sampling<>, user_isa_sampling>,
+       csa_sada<enc_vector<>, 8, 16, sa_order_sa_sampling<>, user_isa_sampling>,
+       csa_wt<wt_huff<>,32,32,text_order_sa_sampling<pef_vector<>>,text_order_isa_sampling_support<>,succinct_byte_alphabet<pef_vector<>, rank_support_pef<>, select_support_pef<>>>,
+       csa_wt<wt_rlmn<rle_vector<>>,32,32,text_order_sa_sampling<rle_vector<>>>,
        csa_bitcompressed<>
        > Implementations;
 
@@ -55,6 +78,119 @@ TYPED_TEST(csa_byte_test, create_and_store_test)
     ASSERT_TRUE(store_to_file(csa, temp_file));
 }
 
+//! Test zero-copy loading
+TYPED_TEST(csa_byte_test, load_from_mapped_file)
+{
+    TypeParam csa1, csa2;
+    ASSERT_TRUE(load_from_file(csa1, temp_file));
+    ASSERT_TRUE(load_from_mapped_file(csa2, temp_file));
+    ASSERT_EQ(csa1.size(), csa2.size());
+    ASSERT_EQ(csa1.sigma, csa2.sigma);
+    for (size_type i=0; i<csa1.size(); ++i) {
+        ASSERT_EQ(csa1[i], csa2[i]);
+        ASSERT_EQ(csa1.bwt[i], csa2.bwt[i]);
+    }
+}
+
+//! Test that the large members of a mapped csa_wt point into the mapping
+TEST(csa_byte_mapped_test, members_point_into_mapping)
+{
+    if (in_memory) {
+        GTEST_SKIP() << "RAM-files are loaded with load_from_file";
+    }
+    csa_wt<wt_huff<>, 8, 16> csa1, csa2;
+    cache_config config(false, temp_dir, util::basename(test_file));
+    construct(csa1, test_file, config, 1);
+    string mapped_file = temp_file + "_mapped";
+    ASSERT_TRUE(store_to_mapped_file(csa1, mapped_file));
+    ASSERT_TRUE(load_from_mapped_file(csa2, mapped_file));
+    sdsl::remove(mapped_file); // the mapping stays valid
+    auto mapped = [](const uint64_t* data, size_type size) {
+        return size == 0 or memory_manager::is_mapped(data);
+    };
+    ASSERT_TRUE(mapped(csa2.wavelet_tree.bv.data(), csa2.wavelet_tree.bv.size()));
+    ASSERT_TRUE(mapped(csa2.sa_sample.data(), csa2.sa_sample.size()));
+    ASSERT_TRUE(mapped(csa2.isa_sample.data(), csa2.isa_sample.size()));
+    ASSERT_EQ(csa1.size(), csa2.size());
+    for (size_type i=0; i<csa1.size(); ++i) {
+        ASSERT_EQ(csa1[i], csa2[i]);
+    }
+}
+
+//! Test loading with parallel reads
+TYPED_TEST(csa_byte_test, load_from_file_parallel)
+{
+    TypeParam csa1, csa2;
+    ASSERT_TRUE(load_from_file(csa1, temp_file));
+    ASSERT_TRUE(load_from_file_parallel(csa2, temp_file, 4));
+    ASSERT_EQ(csa1.size(), csa2.size());
+    ASSERT_EQ(csa1.sigma, csa2.sigma);
+    for (size_type i=0; i<csa1.size(); ++i) {
+        ASSERT_EQ(csa1[i], csa2[i]);
+        ASSERT_EQ(csa1.bwt[i], csa2.bwt[i]);
+    }
+}
+
+string file_content(const string& file)
+{
+    isfstream in(file, std::ios::binary | std::ios::in);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+//! Test loading the members in parallel with the table of member offsets
+TYPED_TEST(csa_byte_test, load_members_parallel)
+{
+    TypeParam csa1, csa2, csa3;
+    ASSERT_TRUE(load_from_file(csa1, temp_file));
+    string offsets_file = temp_file + "_offsets";
+    ASSERT_TRUE(store_to_file_with_offsets(csa1, offsets_file));
+    string content = file_content(offsets_file);
+    ASSERT_EQ(file_content(temp_file), content.substr(0, size_in_bytes(csa1)));
+    vector<uint64_t> offsets;
+    ASSERT_TRUE(read_member_offsets(offsets_file, offsets));
+    ASSERT_EQ(serialized_members<TypeParam>::count+1, offsets.size());
+    ASSERT_EQ(size_in_bytes(csa1), offsets.back());
+    ASSERT_TRUE(load_from_file(csa2, offsets_file));
+    ASSERT_TRUE(load_from_file_parallel(csa3, offsets_file, 4));
+    ASSERT_EQ(csa1.size(), csa3.size());
+    ASSERT_EQ(csa1.sigma, csa3.sigma);
+    for (size_type i=0; i<csa1.size(); ++i) {
+        ASSERT_EQ(csa1[i], csa2[i]);
+        ASSERT_EQ(csa1[i], csa3[i]);
+        ASSERT_EQ(csa1.isa[i], csa3.isa[i]);
+        ASSERT_EQ(csa1.bwt[i], csa3.bwt[i]);
+    }
+    if (offsets.size() > 2) {
+        // move the end of the first member
+        uint64_t* table = (uint64_t*)(&content[offsets.back()]);
+        table[1] += 8;
+        {
+            osfstream out(offsets_file, std::ios::binary | std::ios::trunc | std::ios::out);
+            out.write(content.data(), content.size());
+        }
+        TypeParam csa4;
+        ASSERT_FALSE(load_from_file_parallel(csa4, offsets_file, 4));
+    }
+    sdsl::remove(offsets_file);
+}
+
+//! Test construction with a BWT which is calculated without SA
+TYPED_TEST(csa_byte_test, create_bwt_direct)
+{
+    TypeParam csa1, csa2;
+    ASSERT_TRUE(load_from_file(csa1, temp_file));
+    cache_config config(true, temp_dir, util::basename(test_file)+"_bwt_direct");
+    construct_config::byte_algo_bwt = DIVBWT;
+    construct(csa2, test_file, config, 1);
+    construct_config::byte_algo_bwt = BWT_FROM_SA;
+    ASSERT_EQ(csa1.size(), csa2.size());
+    for (size_type i=0; i<csa1.size(); ++i) {
+        ASSERT_EQ(csa1[i], csa2[i]);
+        ASSERT_EQ(csa1.isa[i], csa2.isa[i]);
+        ASSERT_EQ(csa1.bwt[i], csa2.bwt[i]);
+    }
+}
+
 //! Test backward_search
 TYPED_TEST(csa_byte_test, backward_search)
 {
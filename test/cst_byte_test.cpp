@@ -117,6 +117,28 @@ TYPED_TEST(cst_byte_test, move_method)
 }
 
 
+//! Test loading the members in parallel with the table of member offsets
+TYPED_TEST(cst_byte_test, load_members_parallel)
+{
+    TypeParam cst1, cst2;
+    ASSERT_TRUE(load_from_file(cst1, temp_file));
+    string offsets_file = temp_file + "_offsets";
+    ASSERT_TRUE(store_to_file_with_offsets(cst1, offsets_file));
+    vector<uint64_t> offsets;
+    ASSERT_TRUE(read_member_offsets(offsets_file, offsets));
+    ASSERT_EQ(serialized_members<TypeParam>::count+1, offsets.size());
+    ASSERT_EQ(size_in_bytes(cst1), offsets.back());
+    ASSERT_TRUE(load_from_file_parallel(cst2, offsets_file, 4));
+    sdsl::remove(offsets_file);
+    ASSERT_EQ(cst1.size(), cst2.size());
+    ASSERT_EQ(cst1.nodes(), cst2.nodes());
+    for (size_type i=0; i<cst1.size(); ++i) {
+        ASSERT_EQ(cst1.csa[i], cst2.csa[i]);
+        ASSERT_EQ(cst1.lcp[i], cst2.lcp[i]);
+    }
+    check_node_method(cst2);
+}
+
 //! Test the node method
 TYPED_TEST(cst_byte_test, node_method)
 {
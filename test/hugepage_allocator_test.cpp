@@ -0,0 +1,194 @@
+#include "sdsl/memory_management.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using namespace sdsl;
+
+std::string temp_dir;
+bool allocator_ready = false; // heap of the allocator is mapped, with hugepages if available
+
+class hugepage_allocator_test : public ::testing::Test { };
+
+const size_t threads = 4;
+// sizes of the per-thread size classes (64 B to 32 KiB) and a few in between
+const std::vector<size_t> sizes = {1, 64, 100, 1000, 4096, 5000, 32768};
+
+// Allocates all sizes several times and fills each block with a pattern of the thread
+std::vector<uint8_t*> alloc_blocks(size_t t)
+{
+    std::vector<uint8_t*> blocks;
+    for (size_t r=0; r < 10; ++r) {
+        for (size_t size : sizes) {
+            uint8_t* p = (uint8_t*)hugepage_allocator::the_allocator().mm_alloc(size);
+            std::fill(p, p+size, (uint8_t)t);
+            blocks.push_back(p);
+        }
+    }
+    return blocks;
+}
+
+bool check_blocks(const std::vector<uint8_t*>& blocks, size_t t)
+{
+    for (size_t i=0; i < blocks.size(); ++i) {
+        size_t size = sizes[i%sizes.size()];
+        for (size_t j=0; j < size; ++j) {
+            if (blocks[i][j] != (uint8_t)t) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//! Freed blocks are reused by the same thread; blocks of different threads do not overlap.
+TEST_F(hugepage_allocator_test, thread_cache_reuse)
+{
+    if (!allocator_ready) {
+        GTEST_SKIP() << "heap of hugepage_allocator could not be mapped";
+    }
+    auto& a = hugepage_allocator::the_allocator();
+    std::vector<std::vector<uint8_t*>> first(threads);
+    std::atomic<size_t> allocated(0), reused(0), corrupted(0);
+    std::vector<std::thread> workers;
+    for (size_t t=0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            first[t] = alloc_blocks(t);
+            // all threads hold their blocks at the same time
+            ++allocated;
+            while (allocated < threads) {
+                std::this_thread::yield();
+            }
+            if (!check_blocks(first[t], t)) {
+                ++corrupted;
+            }
+            for (uint8_t* p : first[t]) {
+                a.mm_free(p);
+            }
+            std::vector<uint8_t*> second = alloc_blocks(t);
+            for (uint8_t* p : second) {
+                if (std::find(first[t].begin(), first[t].end(), p) != first[t].end()) {
+                    ++reused;
+                }
+                a.mm_free(p);
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    ASSERT_EQ((size_t)0, corrupted.load());
+    // every block of the second round comes from the cache of the thread
+    ASSERT_EQ(threads*10*sizes.size(), reused.load());
+
+    // the caches of the finished threads were returned to the heap, so the
+    // heap does not grow when another thread allocates the same blocks
+    uint8_t* end = nullptr;
+    for (auto& blocks : first) {
+        for (size_t i=0; i < blocks.size(); ++i) {
+            end = std::max(end, blocks[i]+sizes[i%sizes.size()]);
+        }
+    }
+    std::thread([&]() {
+        std::vector<uint8_t*> blocks;
+        for (size_t t=0; t < threads; ++t) {
+            for (uint8_t* p : alloc_blocks(t)) {
+                blocks.push_back(p);
+                if (p >= end) {
+                    ++corrupted;
+                }
+            }
+        }
+        for (uint8_t* p : blocks) {
+            a.mm_free(p);
+        }
+    }).join();
+    ASSERT_EQ((size_t)0, corrupted.load());
+}
+
+//! Concurrent allocations, reallocations and frees of blocks which bypass the thread caches.
+TEST_F(hugepage_allocator_test, heap_concurrency)
+{
+    if (!allocator_ready) {
+        GTEST_SKIP() << "heap of hugepage_allocator could not be mapped";
+    }
+    auto& a = hugepage_allocator::the_allocator();
+    // larger than the largest size class, so every call goes to the shared heap
+    const std::vector<size_t> heap_sizes = {40000, 65536, 100000, 250000};
+    std::atomic<size_t> corrupted(0);
+    std::vector<std::thread> workers;
+    for (size_t t=0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            std::vector<std::pair<uint8_t*, size_t>> live;
+            uint64_t x = t+1;
+            for (size_t r=0; r < 2000; ++r) {
+                x = x*6364136223846793005ULL + 1442695040888963407ULL;
+                size_t op = (x >> 33) % 4;
+                if (live.size() < 8 or op == 0) {
+                    size_t size = heap_sizes[(x >> 40) % heap_sizes.size()];
+                    uint8_t* p = (uint8_t*)a.mm_alloc(size);
+                    std::fill(p, p+size, (uint8_t)t);
+                    live.emplace_back(p, size);
+                    continue;
+                }
+                size_t i = (x >> 45) % live.size();
+                uint8_t* p = live[i].first;
+                size_t size = live[i].second;
+                if (std::count(p, p+size, (uint8_t)t) != (ptrdiff_t)size) {
+                    ++corrupted;
+                }
+                if (op == 1) {
+                    size_t new_size = heap_sizes[(x >> 40) % heap_sizes.size()];
+                    p = (uint8_t*)a.mm_realloc(p, new_size);
+                    std::fill(p, p+new_size, (uint8_t)t);
+                    live[i] = {p, new_size};
+                } else {
+                    a.mm_free(p);
+                    live[i] = live.back();
+                    live.pop_back();
+                }
+            }
+            for (auto& b : live) {
+                if (std::count(b.first, b.first+b.second, (uint8_t)t) != (ptrdiff_t)b.second) {
+                    ++corrupted;
+                }
+                a.mm_free(b.first);
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    ASSERT_EQ((size_t)0, corrupted.load());
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    if (argc < 2) {
+        // LCOV_EXCL_START
+        std::cout << "Usage: " << argv[0] << " tmp_dir" << std::endl;
+        return 1;
+        // LCOV_EXCL_STOP
+    }
+    temp_dir = argv[1];
+    // the heap of the allocator does not depend on the page size, so
+    // normal pages are used if no hugepages are available
+    for (bool hugepages : {true, false}) {
+        try {
+            hugepage_allocator::the_allocator().init(64*1024*1024, hugepages);
+            allocator_ready = true;
+            break;
+        } catch (const std::system_error&) {
+        }
+    }
+    return RUN_ALL_TESTS();
+}
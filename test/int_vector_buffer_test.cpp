@@ -241,6 +241,7 @@ void test_sequential_access(size_type width=1)
     {
         rng.seed(13); // To get the same values
         t_T ivb(file_name, std::ios::in, buffersize, width);
+        ivb.async_io(true);
         ASSERT_EQ(size, ivb.size());
         for (size_type i=0; i < ivb.size(); ++i) {
             value_type x = rng() & sdsl::bits::lo_set[ivb.width()];
@@ -283,6 +284,7 @@ void test_sequential_access(size_type width=1)
     {
         rng.seed(13); // To get the same values
         t_T ivb(file_name, std::ios::in, buffersize, width);
+        ivb.async_io(true);
         ASSERT_EQ(size, ivb.size());
         for (size_type i=0; i < ivb.size(); ++i) {
             value_type x = (rng()+1) & sdsl::bits::lo_set[ivb.width()];
@@ -688,6 +690,75 @@ TEST_F(int_vector_buffer_test, Reset)
     test_reset< sdsl::int_vector_buffer<64> >(vec_sizes);
 }
 
+
+template<class t_T>
+void test_async_access(size_type width=1)
+{
+    std::mt19937_64 rng;
+    std::string file_name = temp_dir+"/int_vector_buffer";
+    size_type buffersize = 1<<16;
+    size_type size = 3*buffersize+17;
+    // fill ivb with push_back() (write-behind)
+    {
+        rng.seed(13); // To get the same values
+        t_T ivb(file_name, std::ios::out, buffersize, width);
+        ASSERT_FALSE(ivb.async_io()); // opt-in
+        ivb.async_io(true);
+        for (size_type i=0; i < size; ++i) {
+            ivb.push_back(rng() & sdsl::bits::lo_set[ivb.width()]);
+        }
+    }
+    // scan forward (read-ahead) and change values
+    {
+        rng.seed(13); // To get the same values
+        t_T ivb(file_name, std::ios::in, buffersize, width);
+        ivb.async_io(true);
+        ASSERT_EQ(size, ivb.size());
+        for (size_type i=0; i < ivb.size(); ++i) {
+            value_type x = rng() & sdsl::bits::lo_set[ivb.width()];
+            ASSERT_EQ(x, (size_type)ivb[i]);
+            ivb[i] = (x+1) & sdsl::bits::lo_set[ivb.width()];
+        }
+    }
+    // scan backward and verify changed values
+    {
+        std::vector<value_type> exp(size);
+        rng.seed(13); // To get the same values
+        for (size_type i=0; i < size; ++i) {
+            exp[i] = (rng()+1) & sdsl::bits::lo_set[width];
+        }
+        t_T ivb(file_name, std::ios::in, buffersize, width);
+        ivb.async_io(true);
+        ASSERT_EQ(size, ivb.size());
+        for (size_type i=ivb.size(); i > 0; --i) {
+            ASSERT_EQ(exp[i-1], (size_type)ivb[i-1]);
+        }
+        // the I/O thread moves with the buffer
+        t_T moved(std::move(ivb));
+        ivb = std::move(moved);
+        ASSERT_TRUE(ivb.async_io());
+        // jump between blocks
+        std::uniform_int_distribution<uint64_t> distribution(0, size-1);
+        auto dice = bind(distribution, rng);
+        for (size_type i=0; i < 1000; ++i) {
+            size_type idx = dice();
+            ASSERT_EQ(exp[idx], (size_type)ivb[idx]);
+        }
+        ivb.close(true);
+    }
+}
+
+//! Test read-ahead and write-behind of int_vector_buffers with large buffers
+TEST_F(int_vector_buffer_test, async_access)
+{
+    for (size_type width=1; width <= 64; width+=9) {
+        test_async_access< sdsl::int_vector_buffer<> >(width);
+    }
+    test_async_access< sdsl::int_vector_buffer<1> >(1);
+    test_async_access< sdsl::int_vector_buffer<8> >(8);
+    test_async_access< sdsl::int_vector_buffer<64> >(64);
+}
+
 }  // namespace
 
 int main(int argc, char** argv)
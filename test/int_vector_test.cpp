@@ -269,6 +269,9 @@ void test_SerializeAndLoad(uint8_t width=1)
         iv[i] = rng();
     std::string file_name = temp_dir+"/int_vector";
     sdsl::store_to_file(iv, file_name);
+    // the default format has no padding
+    ASSERT_EQ((t_iv::fixed_int_width ? 8U : 9U) + (iv.bit_size()+63)/64*8, sdsl::util::file_size(file_name));
+    ASSERT_EQ(sdsl::size_in_bytes(iv), sdsl::util::file_size(file_name));
     t_iv iv2;
     sdsl::load_from_file(iv2, file_name);
     ASSERT_EQ(iv.size(), iv2.size());
@@ -292,6 +295,70 @@ TEST_F(IntVectorTest, SerializeAndLoad)
     test_SerializeAndLoad<sdsl::int_vector<64> >();
 }
 
+template<class t_iv>
+void test_LoadMapped(uint8_t width=1)
+{
+    std::mt19937_64 rng;
+    t_iv iv(1000000, 0, width);
+    for (size_type i=0; i<iv.size(); ++i)
+        iv[i] = rng();
+    std::string file_name = temp_dir+"/int_vector_mapped";
+    {
+        std::ofstream out(file_name);
+        out.iword(sdsl::aligned_words_iword()) = 1;
+        iv.serialize(out);
+        iv.serialize(out);
+    }
+    t_iv iv2, iv3;
+    {
+        sdsl::mmap_filebuf buf;
+        ASSERT_TRUE(buf.open(file_name) != nullptr);
+        std::istream in(&buf);
+        iv2.load(in);
+        iv3.load(in);
+    }
+    sdsl::remove(file_name); // the mapping stays valid
+    // the headers are padded, so the words of int_vector<0> are aligned as well
+    ASSERT_TRUE(sdsl::memory_manager::is_mapped(iv2.data()));
+    ASSERT_TRUE(sdsl::memory_manager::is_mapped(iv3.data()));
+    ASSERT_EQ(0U, (uintptr_t)iv2.data() % 8);
+    ASSERT_EQ(0U, (uintptr_t)iv3.data() % 8);
+    ASSERT_EQ(iv.size(), iv2.size());
+    ASSERT_EQ(iv.width(), iv2.width());
+    for (size_type i=0; i<iv.size(); ++i) {
+        ASSERT_EQ(iv[i], iv2[i]);
+    }
+    // changes are private to the process
+    iv2[0] = iv[0] ? 0 : 1;
+    ASSERT_NE(iv[0], iv2[0]);
+    iv2[0] = iv[0];
+    // resizing copies the vector to the heap
+    iv2.resize(iv2.size()+1);
+    ASSERT_FALSE(sdsl::memory_manager::is_mapped(iv2.data()));
+    for (size_type i=0; i<iv.size(); ++i) {
+        ASSERT_EQ(iv[i], iv2[i]);
+    }
+    ASSERT_EQ((typename t_iv::value_type)0, iv2[iv.size()]);
+    // iv3 still owns the mapping
+    for (size_type i=0; i<iv.size(); ++i) {
+        ASSERT_EQ(iv[i], iv3[i]);
+    }
+    t_iv iv4 = iv3;
+    iv3 = t_iv();
+    ASSERT_FALSE(sdsl::memory_manager::is_mapped(iv4.data()));
+    ASSERT_TRUE(iv == iv4);
+}
+
+TEST_F(IntVectorTest, LoadMapped)
+{
+    for (uint8_t width=1; width <= 64; width+=7) {
+        test_LoadMapped< sdsl::int_vector<> >(width);
+    }
+    test_LoadMapped<sdsl::bit_vector     >();
+    test_LoadMapped<sdsl::int_vector< 8> >();
+    test_LoadMapped<sdsl::int_vector<64> >();
+}
+
 TEST_F(IntVectorTest, SerializeFixedToVariable)
 {
     sdsl::int_vector<32> iv(123456,0x733D);
@@ -0,0 +1,98 @@
+#include "sdsl/int_vector.hpp"
+#include "sdsl/memory_management.hpp"
+#include "gtest/gtest.h"
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using namespace sdsl;
+
+std::string temp_dir;
+
+class memory_monitor_test : public ::testing::Test { };
+
+TEST_F(memory_monitor_test, peak_single_thread)
+{
+    memory_monitor::start();
+    {
+        auto ev = memory_monitor::event("alloc");
+        int_vector<64> v(1<<20);
+        v.resize(1<<19);
+    }
+    memory_monitor::stop();
+    int64_t peak = memory_monitor::peak();
+    ASSERT_LE((int64_t)(8<<20), peak);
+    ASSERT_GE((int64_t)(8<<20)+conf::SDSL_MEMORY_MONITOR_MERGE_SIZE, peak);
+}
+
+TEST_F(memory_monitor_test, peak_multiple_threads)
+{
+    const size_t threads = 4;
+    memory_monitor::start();
+    {
+        auto ev = memory_monitor::event("parallel");
+        std::vector<std::thread> workers;
+        for (size_t t=0; t < threads; ++t) {
+            workers.emplace_back([]() {
+                std::vector<int_vector<64>> vs;
+                for (size_t i=0; i < 256; ++i) { // 256 x 4 KiB
+                    vs.emplace_back(512, i);
+                }
+                auto ev = memory_monitor::event("worker");
+                int_vector<64> large(1<<17); // 1 MiB
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+    memory_monitor::stop();
+    int64_t peak = memory_monitor::peak();
+    // at least one thread held 2 MiB; the usage of all threads is at most 8 MiB
+    ASSERT_LE((int64_t)(2<<20), peak);
+    ASSERT_GE((int64_t)threads*((2<<20)+conf::SDSL_MEMORY_MONITOR_MERGE_SIZE), peak);
+
+    std::stringstream ss;
+    memory_monitor::write_memory_log<JSON_FORMAT>(ss);
+    std::string log = ss.str();
+    ASSERT_NE(std::string::npos, log.find("\"parallel\""));
+    size_t workers_logged = 0;
+    for (size_t pos = log.find("\"worker\""); pos != std::string::npos; pos = log.find("\"worker\"", pos+1)) {
+        ++workers_logged;
+    }
+    ASSERT_EQ(threads, workers_logged);
+}
+
+TEST_F(memory_monitor_test, restart)
+{
+    memory_monitor::start();
+    int_vector<64>* v = new int_vector<64>(1<<20);
+    memory_monitor::start();
+    delete v;
+    {
+        auto ev = memory_monitor::event("after restart");
+        int_vector<64> w(1<<18);
+    }
+    memory_monitor::stop();
+    ASSERT_LE((int64_t)0, memory_monitor::peak());
+    ASSERT_GE((int64_t)(2<<20)+conf::SDSL_MEMORY_MONITOR_MERGE_SIZE, memory_monitor::peak());
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    if (argc < 2) {
+        // LCOV_EXCL_START
+        std::cout << "Usage: " << argv[0] << " tmp_dir" << std::endl;
+        return 1;
+        // LCOV_EXCL_STOP
+    }
+    temp_dir = argv[1];
+    return RUN_ALL_TESTS();
+}
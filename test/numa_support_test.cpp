@@ -0,0 +1,126 @@
+#include "sdsl/numa_support.hpp"
+#include "sdsl/int_vector.hpp"
+#include "gtest/gtest.h"
+#include <atomic>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using namespace sdsl;
+
+std::string temp_dir;
+
+class numa_support_test : public ::testing::Test { };
+
+TEST_F(numa_support_test, topology)
+{
+    ASSERT_LE((uint32_t)1, numa_topology::nodes());
+    ASSERT_LT(numa_topology::current_node(), numa_topology::nodes());
+#ifdef __linux__
+    // the nodes whose CPUs are all outside the affinity of the process
+    // (e.g. in a container) cannot be pinned to
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    ASSERT_EQ(0, sched_getaffinity(0, sizeof(allowed), &allowed));
+#endif
+    for (uint32_t node=0; node < numa_topology::nodes(); ++node) {
+        bool usable = false;
+        for (uint32_t c : numa_topology::cpus(node)) {
+#ifdef __linux__
+            usable |= c < CPU_SETSIZE and CPU_ISSET(c, &allowed);
+#else
+            usable = true;
+#endif
+        }
+        if (usable) {
+            std::thread t([node]() {
+                ASSERT_TRUE(numa_topology::pin_thread(node));
+            });
+            t.join();
+        }
+    }
+}
+
+TEST_F(numa_support_test, placement)
+{
+    for (auto placement : {NUMA_INTERLEAVE, NUMA_NODE}) {
+        std::thread t([placement]() {
+            memory_manager::set_numa_placement(placement, 0);
+            int_vector<> v(1000000, 0, 20);
+            for (size_t i=0; i < v.size(); ++i) {
+                v[i] = i;
+            }
+            v.resize(2000000);
+            for (size_t i=0; i < 1000000; ++i) {
+                ASSERT_EQ(i, v[i]);
+            }
+        });
+        t.join();
+    }
+}
+
+TEST_F(numa_support_test, replicas_and_thread_pool)
+{
+    std::string file = temp_dir+"/numa_support_test_"+util::to_string(util::pid());
+    int_vector<> v(100000, 0, 17);
+    for (size_t i=0; i < v.size(); ++i) {
+        v[i] = (i*7)%v.size();
+    }
+    ASSERT_TRUE(store_to_file(v, file));
+    numa_replicas<int_vector<>> replicas(file);
+    sdsl::remove(file);
+    ASSERT_EQ((size_t)numa_topology::nodes(), replicas.size());
+    for (size_t node=0; node < replicas.size(); ++node) {
+        ASSERT_EQ(v, replicas[node]);
+    }
+    ASSERT_EQ(v, replicas.local());
+
+    numa_thread_pool pool(2);
+    std::vector<std::future<void>> results;
+    std::atomic<uint64_t> sum(0), wrong_node(0);
+    for (size_t i=0; i < v.size(); i+=1000) {
+        results.push_back(pool.submit([&, i](uint32_t node) {
+            if (node >= replicas.size()) {
+                ++wrong_node;
+                return;
+            }
+            for (size_t j=i; j < i+1000; ++j) {
+                sum += replicas[node][j];
+            }
+        }));
+    }
+    results.push_back(pool.submit(0, [&](uint32_t node) {
+        if (node != 0) {
+            ++wrong_node;
+        }
+    }));
+    for (auto& r : results) {
+        r.get();
+    }
+    uint64_t expected = 0;
+    for (size_t i=0; i < v.size(); ++i) {
+        expected += v[i];
+    }
+    ASSERT_EQ((uint64_t)0, wrong_node.load());
+    ASSERT_EQ(expected, sum.load());
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    if (argc < 2) {
+        // LCOV_EXCL_START
+        std::cout << "Usage: " << argv[0] << " tmp_dir" << std::endl;
+        return 1;
+        // LCOV_EXCL_STOP
+    }
+    temp_dir = argv[1];
+    return RUN_ALL_TESTS();
+}
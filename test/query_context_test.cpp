@@ -0,0 +1,168 @@
+#include "sdsl/query_context.hpp"
+#include "sdsl/suffix_arrays.hpp"
+#include "sdsl/wavelet_trees.hpp"
+#include "sdsl/k2_tree.hpp"
+#include "sdsl/k2_treap.hpp"
+#include "gtest/gtest.h"
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+
+using namespace sdsl;
+using namespace std;
+
+string temp_dir;
+
+class query_context_test : public ::testing::Test { };
+
+// Runs query repeatedly and checks that the arena of ctx stops growing
+template<class t_query>
+void check_no_allocations(query_context& ctx, t_query query)
+{
+    for (size_t i=0; i < 10; ++i) { // warm-up
+        query(i);
+    }
+    size_t allocations = ctx.allocations();
+    for (size_t i=0; i < 10; ++i) {
+        query(i);
+    }
+    ASSERT_EQ(allocations, ctx.allocations());
+}
+
+TEST_F(query_context_test, arena)
+{
+    query_context ctx;
+    arena_vector<uint64_t> v((arena_allocator<uint64_t>(ctx)));
+    for (uint64_t i=0; i < 100000; ++i) {
+        v.push_back(i);
+    }
+    ASSERT_LT((size_t)1, ctx.allocations());
+    size_t allocations = ctx.allocations();
+    ctx.reset();
+    ASSERT_EQ(allocations+1, ctx.allocations()); // blocks are merged
+    size_t capacity = ctx.capacity();
+    for (size_t r=0; r < 3; ++r) {
+        ctx.reset();
+        arena_vector<uint64_t> w((arena_allocator<uint64_t>(ctx)));
+        for (uint64_t i=0; i < 100000; ++i) {
+            w.push_back(i);
+        }
+        ASSERT_EQ(99999u, w.back());
+    }
+    ASSERT_EQ(allocations+1, ctx.allocations());
+    ASSERT_EQ(capacity, ctx.capacity());
+}
+
+TEST_F(query_context_test, locate)
+{
+    csa_wt<> csa;
+    construct_im(csa, "abracadabra_barbapapa_abracadabra", 1);
+    vector<uint64_t> occ;
+    for (string pat : {"a", "abra", "bar", "zz"}) {
+        auto expected = locate(csa, pat.begin(), pat.end());
+        ASSERT_EQ(expected.size(), locate(csa, pat.begin(), pat.end(), occ));
+        ASSERT_EQ(vector<uint64_t>(expected.begin(), expected.end()), occ);
+    }
+}
+
+TEST_F(query_context_test, wt_int)
+{
+    int_vector<> iv(10000);
+    mt19937_64 rng(3);
+    for (auto it = iv.begin(); it != iv.end(); ++it) {
+        *it = rng() % 200;
+    }
+    wt_int<> wt;
+    construct_im(wt, iv);
+    wm_int<> wm;
+    construct_im(wm, iv);
+
+    query_context ctx;
+    vector<pair<uint64_t, uint64_t>> res;
+    vector<range_type> ranges = {{{10, 2000}}, {{500, 3000}}, {{4000, 9000}}};
+    for (size_t t=0; t <= ranges.size(); ++t) {
+        intersect(wt, ranges, t, res, ctx);
+        ASSERT_EQ(intersect(wt, ranges, t), res);
+    }
+    check_no_allocations(ctx, [&](size_t i) { intersect(wt, ranges, i%3, res, ctx); });
+
+    vector<uint64_t> values;
+    restricted_unique_range_values(wt, 100, 900, 20, 150, values, ctx);
+    ASSERT_EQ(restricted_unique_range_values(wt, 100, 900, 20, 150), values);
+    check_no_allocations(ctx, [&](size_t i) {
+        restricted_unique_range_values(wt, 10*i, 100+10*i, 20, 150, values, ctx);
+    });
+
+    wt_int<>::point_vec_type points;
+    auto expected = wt.range_search_2d(100, 5000, 30, 80);
+    ASSERT_EQ(expected.first, wt.range_search_2d(100, 5000, 30, 80, points, ctx));
+    ASSERT_EQ(expected.second, points);
+    auto expected_wm = wm.range_search_2d(100, 5000, 30, 80);
+    ASSERT_EQ(expected_wm.first, wm.range_search_2d(100, 5000, 30, 80, points, ctx));
+    ASSERT_EQ(expected_wm.second, points);
+    check_no_allocations(ctx, [&](size_t i) {
+        wt.range_search_2d(i, 5000, 30, 80, points, ctx);
+        wm.range_search_2d(i, 5000, 30, 80, points, ctx);
+    });
+}
+
+TEST_F(query_context_test, k2_tree)
+{
+    typedef k2_tree<2, bit_vector> tree_type;
+    vector<tuple<tree_type::idx_type, tree_type::idx_type>> edges;
+    mt19937_64 rng(5);
+    for (size_t i=0; i < 2000; ++i) {
+        edges.emplace_back(rng()%256, rng()%256);
+    }
+    tree_type tree(edges, 256);
+
+    vector<tree_type::idx_type> acc;
+    for (tree_type::idx_type i=0; i < 256; ++i) {
+        tree.neigh(i, acc);
+        ASSERT_EQ(tree.neigh(i), acc);
+        tree.reverse_neigh(i, acc);
+        ASSERT_EQ(tree.reverse_neigh(i), acc);
+    }
+    query_context ctx;
+    vector<pair<tree_type::idx_type, tree_type::idx_type>> res;
+    tree.range(10, 100, 20, 200, res, ctx);
+    ASSERT_EQ(tree.range(10, 100, 20, 200), res);
+    check_no_allocations(ctx, [&](size_t i) { tree.range(i, 100, 20, 200, res, ctx); });
+}
+
+TEST_F(query_context_test, k2_treap)
+{
+    vector<array<uint64_t, 3>> points;
+    mt19937_64 rng(7);
+    for (size_t i=0; i < 5000; ++i) {
+        points.push_back({{rng()%1024, rng()%1024, rng()%1000}});
+    }
+    k2_treap<2, bit_vector> treap;
+    construct_im(treap, points);
+
+    query_context ctx;
+    for (uint64_t x=0; x < 1024; x += 100) {
+        ASSERT_EQ(count(treap, {x, 2*x/3}, {x+300, x+200}),
+                  count(treap, {x, 2*x/3}, {x+300, x+200}, ctx));
+    }
+    check_no_allocations(ctx, [&](size_t i) { count(treap, {i, 0}, {1000, 900}, ctx); });
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    if (argc < 2) {
+        // LCOV_EXCL_START
+        cout << "Usage: " << argv[0] << " tmp_dir" << endl;
+        return 1;
+        // LCOV_EXCL_STOP
+    }
+    temp_dir = argv[1];
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,199 @@
+#include "sdsl/query_server.hpp"
+#include "sdsl/suffix_arrays.hpp"
+#include "sdsl/suffix_trees.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using namespace sdsl;
+using namespace std;
+
+string temp_dir;
+
+class query_server_test : public ::testing::Test { };
+
+string random_text(size_t n)
+{
+    mt19937_64 rng(11);
+    uniform_int_distribution<int> dist(0, 3);
+    string text(n, 'a');
+    for (auto& c : text) {
+        c = "acgt"[dist(rng)];
+    }
+    return text;
+}
+
+// Positions of all substrings of text with at most k mismatches to pat
+vector<uint64_t> brute_force_k_mismatch(const string& text, const string& pat, size_t k)
+{
+    vector<uint64_t> res;
+    for (size_t i=0; i+pat.size() <= text.size(); ++i) {
+        size_t errors = 0;
+        for (size_t j=0; j < pat.size() and errors <= k; ++j) {
+            errors += (text[i+j] != pat[j]);
+        }
+        if (errors <= k) {
+            res.push_back(i);
+        }
+    }
+    return res;
+}
+
+vector<uint64_t> sorted(vector<uint64_t> v)
+{
+    sort(v.begin(), v.end());
+    return v;
+}
+
+template<class t_index>
+void check_server(const t_index& index, const string& text, const string& name)
+{
+    string socket_path = temp_dir+"/query_server_test_"+name+".sock";
+    query_server<t_index> server(index, socket_path, 2, 16);
+    thread server_thread([&]() { server.run(); });
+
+    query_client client(socket_path);
+    vector<string> patterns = {"a", "ac", "gat", "cgta", "ttttt", "acgtacgt", "x"};
+    for (const auto& pat : patterns) {
+        auto expected = locate(index, pat.begin(), pat.end());
+        ASSERT_EQ(expected.size(), client.count(pat));
+        ASSERT_EQ(sorted(vector<uint64_t>(expected.begin(), expected.end())),
+                  sorted(client.locate(pat)));
+    }
+    for (uint64_t i=0; i+100 < text.size(); i+=997) {
+        ASSERT_EQ(text.substr(i, 50), client.extract(i, i+49));
+    }
+    ASSERT_EQ(text.substr(text.size()-10), client.extract(text.size()-10, text.size()-1));
+    // the sentinel at position text.size() is not part of the text
+    ASSERT_THROW(client.extract(10, text.size()), runtime_error);
+    ASSERT_THROW(client.extract(10, text.size()+1), runtime_error);
+    ASSERT_THROW(client.extract(-16ULL, -1ULL), runtime_error);
+    for (string pat : {"acgtac", "ggatcca", "tttttttt"}) {
+        for (uint8_t k=0; k <= 2; ++k) {
+            ASSERT_EQ(brute_force_k_mismatch(text, pat, k), sorted(client.k_mismatch(pat, k)));
+        }
+    }
+    ASSERT_THROW(client.k_mismatch("acg", 3), runtime_error);
+
+    // a frame exceeding the maximal size closes only its own connection
+    {
+        frame_stream bad(connect_unix_socket(socket_path));
+        bad.write(string(4, (char)0xFF));
+        ASSERT_FALSE(bad.receive());
+    }
+    ASSERT_EQ(locate(index, patterns[1].begin(), patterns[1].end()).size(), client.count(patterns[1]));
+    // short-lived connections
+    for (size_t i=0; i < 20; ++i) {
+        query_client short_lived(socket_path);
+        ASSERT_EQ(client.count("gat"), short_lived.count("gat"));
+    }
+
+    // pipeline many requests on a second connection
+    query_client pipelined(socket_path);
+    vector<query_protocol::request> requests;
+    for (size_t i=0; i < 500; ++i) {
+        query_protocol::request req;
+        req.op = query_protocol::COUNT;
+        req.pattern = text.substr(i*37 % (text.size()-10), 1+i%8);
+        requests.push_back(req);
+    }
+    vector<uint32_t> ids;
+    for (const auto& req : requests) {
+        ids.push_back(pipelined.send(req));
+    }
+    vector<bool> answered(requests.size(), false);
+    for (size_t i=0; i < requests.size(); ++i) {
+        auto res = pipelined.receive();
+        size_t j = find(ids.begin(), ids.end(), res.id)-ids.begin();
+        ASSERT_LT(j, requests.size());
+        ASSERT_FALSE(answered[j]);
+        answered[j] = true;
+        ASSERT_EQ(query_protocol::OK, res.status);
+        const auto& pat = requests[j].pattern;
+        ASSERT_EQ(count(index, pat.begin(), pat.end()), res.count);
+    }
+    ASSERT_LT(server.batches(), server.requests());
+
+    server.stop();
+    server_thread.join();
+}
+
+// A client which pipelines requests and never reads the responses
+TEST_F(query_server_test, non_reading_client)
+{
+    string text = random_text(20000);
+    csa_wt<wt_huff<>, 16, 32> csa;
+    construct_im(csa, text, 1);
+    string socket_path = temp_dir+"/query_server_test_non_reading.sock";
+    query_server<decltype(csa)> server(csa, socket_path, 1, 4, 4, 200);
+    thread server_thread([&]() { server.run(); });
+
+    frame_stream stalled(connect_unix_socket(socket_path));
+    query_protocol::request req;
+    req.op = query_protocol::LOCATE;
+    req.pattern = "a"; // about 40 KB per response
+    string buf;
+    for (uint32_t i=0; i < 200; ++i) {
+        req.id = i;
+        query_protocol::encode(req, buf);
+    }
+    stalled.write(buf);
+    // the worker gives up on the stalled connection and serves other clients
+    query_client client(socket_path);
+    ASSERT_EQ(count(csa, req.pattern.begin(), req.pattern.end()), client.count(req.pattern));
+    server.stop();
+    server_thread.join();
+
+    // without a send timeout, stopping the server has to wake up the blocked
+    // worker; the stalled client stays connected until the server is destroyed
+    unique_ptr<frame_stream> stalled2;
+    {
+        query_server<decltype(csa)> server2(csa, socket_path, 1, 4, 4, 0);
+        thread server_thread2([&]() { server2.run(); });
+        stalled2.reset(new frame_stream(connect_unix_socket(socket_path)));
+        stalled2->write(buf);
+        this_thread::sleep_for(chrono::milliseconds(100));
+        server2.stop();
+        server_thread2.join();
+    }
+}
+
+TEST_F(query_server_test, csa_wt)
+{
+    string text = random_text(20000);
+    csa_wt<wt_huff<>, 16, 32> csa;
+    construct_im(csa, text, 1);
+    check_server(csa, text, "csa_wt");
+}
+
+TEST_F(query_server_test, cst_sct3)
+{
+    string text = random_text(20000);
+    cst_sct3<> cst;
+    construct_im(cst, text, 1);
+    check_server(cst.csa, text, "cst_csa");
+    check_server(cst, text, "cst_sct3");
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    if (argc < 2) {
+        // LCOV_EXCL_START
+        cout << "Usage: " << argv[0] << " tmp_dir" << endl;
+        return 1;
+        // LCOV_EXCL_STOP
+    }
+    temp_dir = argv[1];
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,137 @@
+// The test and its copy of the library are built with SDSL_QUERY_STATS
+// (see CMakeLists.txt), regardless of the build option.
+#ifndef SDSL_QUERY_STATS
+#error "query_stats_test has to be compiled with -DSDSL_QUERY_STATS"
+#endif
+#include "sdsl/suffix_arrays.hpp"
+#include "sdsl/wavelet_trees.hpp"
+#include "sdsl/bp_support_sada.hpp"
+#include "gtest/gtest.h"
+#include <sstream>
+#include <string>
+
+namespace
+{
+
+using namespace sdsl;
+
+std::string temp_dir;
+
+class query_stats_test : public ::testing::Test { };
+
+// true if the (possibly mangled) class name of a structure tree node is sdsl::name
+bool is_class(const std::string& node_class, const std::string& name)
+{
+    for (const std::string& prefix : {"sdsl::"+name, "N4sdsl"+util::to_string(name.size())+name, name}) {
+        if (node_class.compare(0, prefix.size(), prefix) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// value of the counter name in the first node of class class_name in the JSON output
+std::string counter(const std::string& json, const std::string& class_name, const std::string& name)
+{
+    const std::string class_key = "\"class_name\":\"";
+    size_t node = json.find(class_key);
+    while (node != std::string::npos) {
+        size_t begin = node+class_key.size();
+        if (is_class(json.substr(begin, json.find("\"", begin)-begin), class_name)) {
+            break;
+        }
+        node = json.find(class_key, begin);
+    }
+    if (node == std::string::npos) {
+        return "";
+    }
+    size_t counters = json.find("\"counters\":{", node);
+    size_t next_node = json.find(class_key, node+1);
+    if (counters == std::string::npos or counters > next_node) {
+        return "";
+    }
+    size_t end = json.find("}", counters);
+    std::string key = "\""+name+"\":\"";
+    size_t pos = json.find(key, counters);
+    if (pos == std::string::npos or pos > end) {
+        return "";
+    }
+    pos += key.size();
+    return json.substr(pos, json.find("\"", pos)-pos);
+}
+
+template<class t_structure>
+std::string structure_json(const t_structure& x)
+{
+    std::stringstream ss;
+    write_structure<JSON_FORMAT>(x, ss);
+    return ss.str();
+}
+
+TEST_F(query_stats_test, csa)
+{
+    csa_wt<wt_huff<rrr_vector<63>>, 4, 4> csa;
+    construct_im(csa, "abracadabra_abracadabra_barbapapa", 1);
+    ASSERT_EQ("", counter(structure_json(csa), "csa_wt", "sa_access"));
+    uint64_t hits = 0;
+    for (size_t i=0; i < csa.size(); ++i) {
+        if (csa.sa_sample.is_sampled(i)) {
+            ++hits;
+        }
+        csa[i];
+    }
+    std::string json = structure_json(csa);
+    ASSERT_EQ(util::to_string(csa.size()), counter(json, "csa_wt", "sa_access"));
+    ASSERT_EQ(util::to_string(hits), counter(json, "csa_wt", "sa_sample_hits"));
+    ASSERT_NE("", counter(json, "csa_wt", "sa_steps"));
+    ASSERT_NE("", counter(json, "wt_pc", "inverse_select"));
+    ASSERT_NE("", counter(json, "wt_pc", "rank_level_0"));
+
+    // a copy starts with zero counters
+    auto csa2 = csa;
+    ASSERT_EQ("", counter(structure_json(csa2), "csa_wt", "sa_access"));
+}
+
+TEST_F(query_stats_test, wt_int)
+{
+    int_vector<> v = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5};
+    wt_int<> wt;
+    construct_im(wt, v);
+    for (size_t i=0; i <= wt.size(); ++i) {
+        wt.rank(i, 5);
+    }
+    wt.select(2, 5);
+    std::string json = structure_json(wt);
+    ASSERT_EQ(util::to_string(wt.size()+1), counter(json, "wt_int", "rank"));
+    ASSERT_EQ("1", counter(json, "wt_int", "select"));
+    ASSERT_EQ(util::to_string(wt.size()+1), counter(json, "wt_int", "rank_level_0"));
+    ASSERT_EQ("1", counter(json, "wt_int", "select_level_0"));
+}
+
+TEST_F(query_stats_test, bp_support)
+{
+    bit_vector bp = {1,1,0,1,1,0,0,0};
+    bp_support_sada<> bps(&bp);
+    for (size_t i=0; i < bp.size(); ++i) {
+        bps.find_close(i);
+    }
+    bps.enclose(3);
+    std::string json = structure_json(bps);
+    ASSERT_EQ("4", counter(json, "bp_support_sada", "find_close"));
+    ASSERT_EQ("1", counter(json, "bp_support_sada", "enclose"));
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    if (argc < 2) {
+        // LCOV_EXCL_START
+        std::cout << "Usage: " << argv[0] << " tmp_dir" << std::endl;
+        return 1;
+        // LCOV_EXCL_STOP
+    }
+    temp_dir = argv[1];
+    return RUN_ALL_TESTS();
+}
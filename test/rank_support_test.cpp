@@ -1,6 +1,8 @@
 #include "sdsl/bit_vectors.hpp"
 #include "sdsl/rank_support.hpp"
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <random>
 #include <string>
 
 using namespace sdsl;
@@ -11,14 +13,20 @@ string test_file;
 namespace
 {
 
+// gtest supports at most 50 types per test case, so the supports of the
+// pattern `1` and all others are tested in two test cases
 template<class T>
 class rank_support_test : public ::testing::Test { };
 
+template<class T>
+class rank_support_test_other : public ::testing::Test { };
+
 using testing::Types;
 
 typedef Types<rank_support_il<1, 256>,
         rank_support_il<1, 512>,
         rank_support_il<1, 1024>,
+        rank_support_cl<1>,
         rank_support_rrr<>,
         rank_support_v<>,
         rank_support_v5<>,
@@ -34,9 +42,15 @@ typedef Types<rank_support_il<1, 256>,
         rank_support_rrr<1, 128>,
         rank_support_rrr<1, 129>,
         rank_support_sd<1>,
-        rank_support_il<0, 256>,
+        rank_support_pef<1>,
+        rank_support_rle<1>,
+        rank_support_hyb<1>
+        > Implementations;
+
+typedef Types<rank_support_il<0, 256>,
         rank_support_il<0, 512>,
         rank_support_il<0, 1024>,
+        rank_support_cl<0>,
         rank_support_rrr<0>,
         rank_support_v<0>,
         rank_support_v5<0>,
@@ -52,7 +66,8 @@ typedef Types<rank_support_il<1, 256>,
         rank_support_rrr<0, 128>,
         rank_support_rrr<0, 129>,
         rank_support_sd<0>,
-        rank_support_hyb<1>,
+        rank_support_pef<0>,
+        rank_support_rle<0>,
         rank_support_hyb<0>,
         rank_support_v<10,2>,
         rank_support_v<01,2>,
@@ -62,12 +77,14 @@ typedef Types<rank_support_il<1, 256>,
         rank_support_v5<01,2>,
         rank_support_v5<00,2>,
         rank_support_v5<11,2>
-        > Implementations;
+        > Implementations_other;
 
 TYPED_TEST_CASE(rank_support_test, Implementations);
+TYPED_TEST_CASE(rank_support_test_other, Implementations_other);
 
 //! Test the rank method
-TYPED_TEST(rank_support_test, rank_method)
+template<class TypeParam>
+void test_rank_method()
 {
     static_assert(sdsl::util::is_regular<TypeParam>::value, "Type is not regular");
     bit_vector bvec;
@@ -86,6 +103,46 @@ TYPED_TEST(rank_support_test, rank_method)
     EXPECT_EQ(rank, rs.rank(bvec.size()));
 }
 
+//! Test the rank_batch method
+template<class TypeParam>
+void test_rank_batch_method()
+{
+    bit_vector bvec;
+    ASSERT_TRUE(load_from_file(bvec, test_file));
+    typename TypeParam::bit_vector_type bv(bvec);
+    TypeParam rs(&bv);
+    vector<uint64_t> idx(bvec.size()+1);
+    for (uint64_t j=0; j < idx.size(); ++j) {
+        idx[j] = j;
+    }
+    shuffle(idx.begin(), idx.end(), mt19937_64(17));
+    vector<uint64_t> res(idx.size());
+    rs.rank_batch(idx.data(), idx.size(), res.data());
+    for (uint64_t j=0; j < idx.size(); ++j) {
+        ASSERT_EQ(rs.rank(idx[j]), res[j]);
+    }
+}
+
+TYPED_TEST(rank_support_test, rank_method)
+{
+    test_rank_method<TypeParam>();
+}
+
+TYPED_TEST(rank_support_test, rank_batch_method)
+{
+    test_rank_batch_method<TypeParam>();
+}
+
+TYPED_TEST(rank_support_test_other, rank_method)
+{
+    test_rank_method<TypeParam>();
+}
+
+TYPED_TEST(rank_support_test_other, rank_batch_method)
+{
+    test_rank_batch_method<TypeParam>();
+}
+
 }// end namespace
 
 int main(int argc, char** argv)
@@ -5,6 +5,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <random>
 
 using namespace sdsl;
 using namespace std;
@@ -52,6 +53,46 @@ TEST_F(sa_construct_test, sesais)
     cout << "# constructs_space = " << (1.0*memory_monitor::peak())/n << " byte per byte, =>" << memory_monitor::peak() << " bytes in total" << endl;
 }
 
+TEST_F(sa_construct_test, sesais_memory_budget)
+{
+    // the text counts towards the budget
+    memory_monitor::start();
+    // The texts of the test cases are too small to be split, so a larger one is generated
+    int_vector<8> text(1<<20);
+    std::mt19937_64 rng(17);
+    for (uint64_t i=0; i<text.size(); ++i) {
+        text[i] = 1 + rng()%4;
+    }
+    text[text.size()-1] = 0;
+    uint64_t len = text.size();
+    uint8_t int_width = bits::hi(len-1)+1;
+    uint64_t resident = size_in_bytes(text)+(len*int_width+63)/64*8;
+    uint64_t budget = resident + (len*int_width/8)/2;
+    size_t parts;
+    uint64_t buffersize;
+    _construct_sa_se_params(len, int_width, resident, budget, parts, buffersize);
+    ASSERT_LT((size_t)1, parts);
+    ASSERT_GE(sa_se_max_parts, parts);
+    ASSERT_LE((uint64_t)4096, buffersize);
+    ASSERT_THROW(_construct_sa_se_params(len, int_width, resident, resident, parts, buffersize), std::invalid_argument);
+
+    std::string sa_file = cache_file_name("budget_sa", config);
+    // more threads than the machine may have, to test the parallel steps
+    _construct_sa_se<int_vector<8>>(text, sa_file, 256, 0, budget, 4);
+    memory_monitor::stop();
+    ASSERT_GE((int64_t)budget, memory_monitor::peak());
+    register_cache_file("budget_sa", config);
+    int_vector<> sa_check(len, 0, bits::hi(len)+1);
+    algorithm::calculate_sa((const unsigned char*)text.data(), len, sa_check);
+
+    int_vector_buffer<> sa(sa_file);
+    ASSERT_EQ(sa_check.size(), sa.size()) << " suffix array size differ";
+    for (uint64_t i=0; i<sa_check.size(); ++i) {
+        ASSERT_EQ(sa_check[i], sa[i]) << " sa differs at position " << i;
+    }
+    ASSERT_THROW(_construct_sa_se<int_vector<8>>(text, sa_file, 256, 0, size_in_bytes(text)), std::invalid_argument);
+}
+
 TEST_F(sa_construct_test, compare)
 {
     // Load both SAs
@@ -17,7 +17,8 @@ using testing::Types;
 
 typedef Types<
 sd_vector<>,
-          sd_vector<rrr_vector<63>>
+          sd_vector<rrr_vector<63>>,
+          sd_vector<bit_vector, select_support_mcl<1>, select_support_mcl<0>>
           > Implementations;
 
 TYPED_TEST_CASE(sd_vector_test, Implementations);
@@ -75,6 +76,30 @@ TYPED_TEST(sd_vector_test, builder_empty_constructor)
     }
 }
 
+TYPED_TEST(sd_vector_test, successor_and_predecessor)
+{
+    for (uint64_t dens : {2, 10, 1000}) {
+        bit_vector bv(BV_SIZE);
+        std::mt19937_64 rng(dens);
+        for (size_t i=0; i < bv.size(); ++i) {
+            // ones in clusters separated by long gaps
+            bv[i] = ((i/4096)%3 == 0) and (rng()%dens == 0);
+        }
+        TypeParam sdv(bv);
+        size_t succ = bv.size();
+        for (size_t i=bv.size(); i > 0; --i) {
+            if (bv[i-1]) succ = i-1;
+            ASSERT_EQ(succ, sdv.successor(i-1)) << "i=" << i-1;
+        }
+        ASSERT_EQ(bv.size(), sdv.successor(bv.size()));
+        size_t pred = bv.size();
+        for (size_t i=0; i < bv.size(); ++i) {
+            if (bv[i]) pred = i;
+            ASSERT_EQ(pred, sdv.predecessor(i)) << "i=" << i;
+        }
+    }
+}
+
 } // end namespace
 
 int main(int argc, char* argv[])
@@ -1,6 +1,8 @@
 #include "sdsl/bit_vectors.hpp"
 #include "sdsl/select_support.hpp"
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <random>
 #include <string>
 
 using namespace sdsl;
@@ -17,6 +19,7 @@ class select_support_test : public ::testing::Test { };
 using testing::Types;
 
 typedef Types<select_support_mcl<>,
+        select_support_darray<1>,
         select_support_rrr<1, 256>,
         select_support_rrr<1, 129>,
         select_support_rrr<1, 192>,
@@ -29,10 +32,20 @@ typedef Types<select_support_mcl<>,
         select_support_sd<1>,
         select_support_sd<0>,
         select_0_support_sd<>,
+        select_support_sd<1, bit_vector, select_support_mcl<1>, select_support_mcl<0>>,
+        select_support_pef<1>,
+        select_support_pef<0>,
+        select_support_rle<1>,
+        select_support_rle<0>,
+        select_support_hyb<1>,
+        select_support_hyb<0>,
         select_support_il<1, 256>,
         select_support_il<1, 512>,
         select_support_il<1, 1024>,
+        select_support_cl<1>,
+        select_support_cl<1, 64>,
         select_support_mcl<0>,
+        select_support_darray<0>,
         select_support_rrr<0, 256>,
         select_support_rrr<0>,
         select_support_rrr<0, 15>,
@@ -42,6 +55,8 @@ typedef Types<select_support_mcl<>,
         select_support_il<0, 256>,
         select_support_il<0, 512>,
         select_support_il<0, 1024>,
+        select_support_cl<0>,
+        select_support_cl<0, 64>,
         select_support_mcl<01,2>,
         select_support_mcl<10,2>,
         select_support_mcl<00,2>,
@@ -74,6 +89,60 @@ TYPED_TEST(select_support_test, select_method)
     }
 }
 
+//! Test the select_batch method
+TYPED_TEST(select_support_test, select_batch_method)
+{
+    bit_vector bvec;
+    ASSERT_TRUE(load_from_file(bvec, test_file));
+    typename TypeParam::bit_vector_type bv(bvec);
+    TypeParam ss(&bv);
+    vector<uint64_t> idx;
+    for (uint64_t j=0, select=0; j < bvec.size(); ++j) {
+        bool found = (j >= TypeParam::bit_pat_len-1);
+        for (uint8_t k=0; found and k < TypeParam::bit_pat_len; ++k) {
+            found &= bvec[j-k] == ((TypeParam::bit_pat>>k)&1);
+        }
+        if (found) {
+            idx.push_back(++select);
+        }
+    }
+    shuffle(idx.begin(), idx.end(), mt19937_64(17));
+    vector<uint64_t> res(idx.size());
+    ss.select_batch(idx.data(), idx.size(), res.data());
+    for (uint64_t j=0; j < idx.size(); ++j) {
+        ASSERT_EQ(ss.select(idx[j]), res[j]);
+    }
+}
+
+template<class T>
+class select_support_darray_test : public ::testing::Test { };
+
+typedef Types<select_support_darray<1>, select_support_darray<0>> darray_implementations;
+
+TYPED_TEST_CASE(select_support_darray_test, darray_implementations);
+
+//! Test select on a skewed vector: a dense half followed by 256 arguments in a sparse half
+TYPED_TEST(select_support_darray_test, skewed_input)
+{
+    const uint64_t n = 1ULL<<22;
+    bit_vector bv(n, !TypeParam::bit_pat);
+    for (uint64_t j=0; j < n/2; ++j) {
+        bv[j] = TypeParam::bit_pat;
+    }
+    mt19937_64 rng(13);
+    for (uint64_t j=0; j < 256; ++j) {
+        bv[n/2 + rng()%(n/2)] = TypeParam::bit_pat;
+    }
+    TypeParam ss(&bv);
+    for (uint64_t j=0, select=0; j < n; ++j) {
+        if (bv[j] == TypeParam::bit_pat) {
+            ASSERT_EQ(j, ss.select(++select));
+        }
+    }
+    // the sparse half is stored explicitly instead of being scanned
+    ASSERT_LT(size_in_bytes(ss)*8, n/4);
+}
+
 }// end namespace
 
 int main(int argc, char** argv)
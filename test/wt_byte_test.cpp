@@ -29,11 +29,14 @@ wt_pc<balanced_shape>
                       ,wt_blcd<bit_vector_il<>>
                       ,wt_blcd<bit_vector>
                       ,wt_huff<bit_vector_il<>>
+                      ,wt_huff<bit_vector_cl<>>
                       ,wt_huff<bit_vector, rank_support_v<>>
                       ,wt_huff<bit_vector, rank_support_v5<>>
                       ,wt_huff<rrr_vector<63>>
+                      ,wt_huff<hyb_vector<>>
                       ,wt_rlmn<>
                       ,wt_rlmn<bit_vector>
+                      ,wt_rlmn<rle_vector<>>
                       ,wt_gmr_rs<>
                       ,wt_hutu<bit_vector_il<>>
                       ,wt_hutu<bit_vector, rank_support_v<>>
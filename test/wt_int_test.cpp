@@ -36,7 +36,11 @@ wt_blcd<bit_vector, rank_support_v<>, select_support_mcl<1>, select_support_mcl<
         ,wt_int<>
         ,wt_int<rrr_vector<15>>
         ,wt_int<rrr_vector<63>>
+        ,wt_int<hyb_vector<>>
+        ,wt_int<bit_vector_cl<>>
+        ,wm_int<bit_vector_cl<>>
         ,wt_rlmn<bit_vector, rank_support_v5<>, select_support_mcl<1>, wt_int<>>
+        ,wt_rlmn<rle_vector<>, rank_support_rle<>, select_support_rle<>, wt_int<>>
         > Implementations;
 
 TYPED_TEST_CASE(wt_int_test, Implementations);